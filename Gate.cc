@@ -36,6 +36,7 @@
 #include "GateOutputMgr.hh"
 #include "GatePrimaryGeneratorAction.hh"
 #include "GateUserActions.hh"
+#include "GateActionInitialization.hh"
 #include "GateDigitizer.hh"
 #include "GateClock.hh"
 #include "GateUIcontrolMessenger.hh"
@@ -287,7 +288,11 @@ int main( int argc, char* argv[] )
   runManager->SetUserInitialization( GatePhysicsList::GetInstance() );
 
   // Set the users actions to handle callback for actors - before the initialisation
+#ifdef GATE_USE_MT
+  runManager->SetUserInitialization( new GateActionInitialization );
+#else
   new GateUserActions( runManager);
+#endif
 
   // Set the Visualization Manager
 #ifdef G4VIS_USE
@@ -301,7 +306,10 @@ int main( int argc, char* argv[] )
   runManager->InitializeAll();
 
   // Incorporate the user actions, set the particles generator
+  // (in multithreaded mode, done per thread by GateActionInitialization)
+#ifndef GATE_USE_MT
   runManager->SetUserAction( new GatePrimaryGeneratorAction() );
+#endif
 
   // Create various singleton objets
 #ifdef G4ANALYSIS_USE_GENERAL
@@ -0,0 +1,32 @@
+#!/bin/bash
+
+# Step overhead of the actors attached to a volume, as a function of the
+# number of actors. Usage: ./run_bench.sh [number of primaries] [Gate binary]
+# For each number of actors N, prints the time per step (ns) and the
+# additional time per step and per actor compared to N=0.
+
+NPART=${1:-2000}
+GATE_BINARY=${2:-Gate}
+
+cd "`dirname \"$0\"`"
+mkdir -p output
+
+printf "%8s %12s %14s %18s\n" "actors" "steps" "ns/step" "ns/step/actor"
+ref=""
+for n in 0 1 2 5 10 20
+do
+    $GATE_BINARY -a "[nActors,$n][npart,$NPART]" mac/main.mac > output/log-$n.txt 2>&1
+    if [ $? -ne 0 ]; then
+        echo "Gate failed for $n actors, see output/log-$n.txt"
+        exit 1
+    fi
+    steps=`grep "NumberOfSteps " output/stat-$n.txt | awk '{print $4}'`
+    time=`grep "ElapsedTimeWoInit" output/stat-$n.txt | awk '{print $4}'`
+    nsPerStep=`echo "$time $steps" | awk '{printf "%.1f", 1e9*$1/$2}'`
+    if [ -z "$ref" ]; then ref=$nsPerStep; fi
+    perActor="-"
+    if [ $n -ne 0 ]; then
+        perActor=`echo "$nsPerStep $ref $n" | awk '{printf "%.1f", ($1-$2)/$3}'`
+    fi
+    printf "%8s %12s %14s %18s\n" $n $steps $nsPerStep $perActor
+done
@@ -4,9 +4,11 @@
 #include "GateMessageManager.hh"
 #include "G4UImanager.hh"
 #include "GateCCHitFileReader.hh"
+#include "GateHitConvertor.hh"
 #include "GateDigitizer.hh"
 #include "GateSingleDigi.hh"
 #include "GateRandomEngine.hh"
+#include "Randomize.hh"
 
 #include "GateDetectorConstruction.hh"
 #include "GateRunManager.hh"
@@ -19,47 +21,52 @@
 #include "TRint.h"
 #include "TPluginManager.h"
 #endif
+#include "TFile.h"
+#include "TTree.h"
+#include "TFileMerger.h"
 #include <getopt.h>
 #include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
 #include <queue>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 
 
-
-
-int main(int argc, char *argv[])
+// Time of the first and last hits of the file (s)
+static bool GetHitTimeRange(const std::string& hits_filePathName, double& firstTime, double& lastTime)
 {
-    // Usage
-    std::ostringstream usage;
-    usage << std::endl
-          << "Gate_CC_hits_digitizer" << std::endl
-          << "Gate for Compton Camera" << std::endl
-          << "Process hits to provide singles" << std::endl
-          << "Usage : " << argv[0] << " <hit.root> <singles.root> <options.mac>" << std::endl;
-
-    // Get user parameters
-    if (argc != 4) {
-        std::cout << "Need 4 parameters" << std::endl
-                  << usage.str() << std::endl;
-        exit(0);
-    }
+    TFile file(hits_filePathName.c_str(),"READ");
+    if (!file.IsOpen()) return false;
+    TTree* hitTree = (TTree*)file.Get(GateHitConvertor::GetOutputAlias());
+    if (!hitTree || hitTree->GetEntries()==0) return false;
+    double time = 0.;
+    hitTree->SetBranchStatus("*",0);
+    hitTree->SetBranchStatus("time",1);
+    hitTree->SetBranchAddress("time",&time);
+    hitTree->GetEntry(0);
+    firstTime = time;
+    hitTree->GetEntry(hitTree->GetEntries()-1);
+    lastTime = time;
+    return true;
+}
 
 
-    std::string hits_filePathName=argv[1];
-    std::string singles_filePathName = argv[2];
-    std::string options_macrofile = argv[3];
-
-    size_t foundPoint =  options_macrofile.find_last_of( "." );
-    // Finding suffix
-    G4String suffix = "";
-    if( foundPoint != G4String::npos )
-        suffix =  options_macrofile.substr( foundPoint + 1 );
-    if( suffix != "mac" )
-    {
-        std::cout << "problemas last argument is not a macro file" << std::endl;
-        exit(0);
-    }
 
+// Digitize the hits of a file into singles.
+// If stopTime>startTime, only the singles in [startTime,stopTime[ (s) are written. The hits
+// from startTime-overlap to stopTime+overlap are processed so that the dead-time and pile-up
+// states are the same as in a digitization of the whole file: the singles of the window see
+// the hits before it, and the hits after it that pile up with them or fall in their dead time.
+// The random engine of a chunk is seeded with the engine seed plus chunkIndex.
+static int DigitizeHits(const std::string& hits_filePathName, const std::string& singles_filePathName,
+                        const std::string& options_macrofile,
+                        double startTime, double stopTime, double overlap, Long64_t cacheSize,
+                        int chunkIndex)
+{
     // GATE Initialisation
     // First of all, set the G4cout to our message manager
     GateMessageManager* theGateMessageManager = GateMessageManager::GetInstance();
@@ -75,10 +82,7 @@ int main(int argc, char *argv[])
     // Set the DetectorConstruction
     GateDetectorConstruction* gateDC = new GateDetectorConstruction();
     runManager->SetUserInitialization( gateDC );
-    // Set the PhysicsList
-    runManager->SetUserInitialization( GatePhysicsList::GetInstance() );
-    // Initialize G4 kernel
-    //runManager->InitializeAll();
+    // No physics list: the hits are only digitized, the G4 kernel is never initialised
 
     //With these lines I enable /gate/digitizer/layers  command because the pointer is called digitizer and the chain layers.
     GateDigitizer*  digitizer =    GateDigitizer::GetInstance();
@@ -95,6 +99,13 @@ int main(int argc, char *argv[])
     UImanager->ApplyCommand( command + options_macrofile );
     std::cout << "Done" << std::endl;
 
+    // The forked chunks inherit the same engine state: without a new seed they would all
+    // draw the same random numbers (blurring, resolutions...)
+    if (chunkIndex>0) {
+        CLHEP::HepRandomEngine* engine = CLHEP::HepRandom::getTheEngine();
+        engine->setSeed(engine->getSeed()+chunkIndex, 0);
+    }
+
 
 
     //Prepare output file
@@ -107,7 +118,11 @@ int main(int argc, char *argv[])
 
 
     //Read Hits tree
+    bool isWindowed = (stopTime>startTime);
     GateCCHitFileReader* m_hitFileReader= GateCCHitFileReader::GetInstance(hits_filePathName);
+    m_hitFileReader->SetCacheSize(cacheSize);
+    if (isWindowed)
+        m_hitFileReader->SetTimeWindow((startTime-overlap)*s,(stopTime+overlap)*s);
     m_hitFileReader->PrepareAcquisition();
     while(m_hitFileReader->HasNextEvent()){
 
@@ -122,6 +137,12 @@ int main(int argc, char *argv[])
                GatePulseConstIterator iterIn;
                 for (iterIn = pPulseList->begin() ; iterIn != pPulseList->end() ; ++iterIn){
 
+                    // Singles of the overlap, or after the window, are written by other chunks
+                    if (isWindowed) {
+                        double time = (*iterIn)->GetTime()/s;
+                        if (time<startTime || time>=stopTime) continue;
+                    }
+
                     GateSingleDigi* aSingleDigi=new GateSingleDigi(*iterIn);
 
 
@@ -145,9 +166,129 @@ int main(int argc, char *argv[])
     delete runManager;
     delete digitizer;
 
+    return 0;
+}
 
 
 
+int main(int argc, char *argv[])
+{
+    // Usage
+    std::ostringstream usage;
+    usage << std::endl
+          << "Gate_CC_hits_digitizer" << std::endl
+          << "Gate for Compton Camera" << std::endl
+          << "Process hits to provide singles" << std::endl
+          << "Usage : " << argv[0] << " [options] <hit.root> <singles.root> <options.mac>" << std::endl
+          << "Options:" << std::endl
+          << "  -j <n>        process the file in n time chunks, in parallel processes" << std::endl
+          << "  -s <time>     only write the singles after this time (s)" << std::endl
+          << "  -e <time>     only write the singles before this time (s)" << std::endl
+          << "  -o <time>     time processed before each chunk for dead time and pile-up (s, default 1e-3)" << std::endl
+          << "  -c <size>     size of the hit read cache (MB, default 64)" << std::endl;
+
+    int nbOfJobs = 1;
+    double startTime = 0.;
+    double stopTime = 0.;
+    double overlap = 1e-3;
+    int cacheSize = 64;
+    int option;
+    while ((option = getopt(argc, argv, "j:s:e:o:c:")) != -1) {
+        switch (option) {
+        case 'j': nbOfJobs = atoi(optarg); break;
+        case 's': startTime = atof(optarg); break;
+        case 'e': stopTime = atof(optarg); break;
+        case 'o': overlap = atof(optarg); break;
+        case 'c': cacheSize = atoi(optarg); break;
+        default:
+            std::cout << usage.str() << std::endl;
+            exit(0);
+        }
+    }
+
+    // Get user parameters
+    if (argc-optind != 3) {
+        std::cout << "Need 3 parameters" << std::endl
+                  << usage.str() << std::endl;
+        exit(0);
+    }
+
+
+    std::string hits_filePathName=argv[optind];
+    std::string singles_filePathName = argv[optind+1];
+    std::string options_macrofile = argv[optind+2];
+
+    size_t foundPoint =  options_macrofile.find_last_of( "." );
+    // Finding suffix
+    G4String suffix = "";
+    if( foundPoint != G4String::npos )
+        suffix =  options_macrofile.substr( foundPoint + 1 );
+    if( suffix != "mac" )
+    {
+        std::cout << "problemas last argument is not a macro file" << std::endl;
+        exit(0);
+    }
+
+    if (nbOfJobs<=1)
+        return DigitizeHits(hits_filePathName, singles_filePathName, options_macrofile,
+                            startTime, stopTime, overlap, (Long64_t)cacheSize*1024*1024, 0);
+
+    // The time range of the file is split in chunks digitized by independent processes
+    // (the digitizer modules are singletons), the chunk outputs are then merged
+    double firstTime, lastTime;
+    if (!GetHitTimeRange(hits_filePathName, firstTime, lastTime)) {
+        std::cout << "Could not read the hit times of " << hits_filePathName << std::endl;
+        exit(1);
+    }
+    if (stopTime>startTime) {
+        firstTime = std::max(firstTime, startTime);
+        lastTime = std::min(lastTime, stopTime);
+    }
+    // The last chunk must include the last hit
+    lastTime = std::nextafter(lastTime, lastTime+1.);
+
+    std::vector<std::string> chunkFileNames;
+    std::vector<pid_t> children;
+    for (int j=0; j<nbOfJobs; j++) {
+        std::ostringstream chunkFileName;
+        chunkFileName << singles_filePathName << ".chunk" << j << ".root";
+        chunkFileNames.push_back(chunkFileName.str());
+        double chunkStart = firstTime + (lastTime-firstTime)*j/nbOfJobs;
+        double chunkStop = (j==nbOfJobs-1) ? lastTime : firstTime + (lastTime-firstTime)*(j+1)/nbOfJobs;
+        pid_t pid = fork();
+        if (pid==0)
+            _exit(DigitizeHits(hits_filePathName, chunkFileNames.back(), options_macrofile,
+                               chunkStart, chunkStop, overlap, (Long64_t)cacheSize*1024*1024, j));
+        if (pid<0) {
+            std::cout << "Could not start the process of chunk " << j << std::endl;
+            exit(1);
+        }
+        children.push_back(pid);
+    }
+
+    int failures = 0;
+    for (size_t j=0; j<children.size(); j++) {
+        int status;
+        waitpid(children[j], &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status)!=0) failures++;
+    }
+    if (failures) {
+        std::cout << failures << " chunk(s) failed, the chunk files are kept" << std::endl;
+        exit(1);
+    }
+
+    // The chunks are in time order, so are the merged singles
+    TFileMerger merger(kFALSE);
+    merger.OutputFile(singles_filePathName.c_str(),"RECREATE");
+    for (size_t j=0; j<chunkFileNames.size(); j++)
+        merger.AddFile(chunkFileNames[j].c_str(),kFALSE);
+    if (!merger.Merge()) {
+        std::cout << "Could not merge the chunk files into " << singles_filePathName << std::endl;
+        exit(1);
+    }
+    for (size_t j=0; j<chunkFileNames.size(); j++)
+        remove(chunkFileNames[j].c_str());
+
     return 0;
 }
 
@@ -63,7 +63,7 @@ private:
 
   G4int runIDcounter;
   G4bool flagBasicOutput;
-  static GateRunAction* prunAction;
+  static G4ThreadLocal GateRunAction* prunAction;
 };
 //-----------------------------------------------------------------------------
 
@@ -93,7 +93,7 @@ private:
   GateUserActions* pCallbackMan;
 
   G4bool flagBasicOutput;
-  static GateEventAction* peventAction;
+  static G4ThreadLocal GateEventAction* peventAction;
 };
 //-----------------------------------------------------------------------------
 
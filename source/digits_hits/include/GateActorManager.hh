@@ -32,6 +32,7 @@ See LICENSE.md for further details
 #include <G4Run.hh>
 #include <G4Event.hh>
 
+#include "GateConfiguration.h"
 #include "GateMessageManager.hh"
 #include "GateVFilter.hh"
 #include "GateActorManagerMessenger.hh"
@@ -39,6 +40,7 @@ See LICENSE.md for further details
 
 class GateVActor;
 class GateMultiSensitiveDetector;
+class GateFilterManager;
 
 class GateActorManager
 {
@@ -102,6 +104,20 @@ public:
 
   G4int GetCurrentEventId() const { return mCurrentEventId; }
 
+#ifdef GATE_USE_MT
+  //-----------------------------------------------------------------------------
+  /// Multithreaded mode: each thread owns its GateActorManager and its
+  /// actors (created by the broadcast macro commands). At the end of a
+  /// run, the master merges the data of the worker actors, in thread
+  /// order, into its own actors before saving them.
+  void MergeWorkerActors();
+  /// Called by a worker thread between two events (save every n
+  /// events/seconds): merge the data of one of its actors into the
+  /// corresponding master actor, and save it if needed for event ne.
+  void MergeWorkerActorIntoMaster(GateVActor * workerActor, int ne);
+  //-----------------------------------------------------------------------------
+#endif
+
 protected:
   //std::vector<GateMultiSensitiveDetector*> theListOfMultiSensitiveDetector;
   std::vector<GateVActor*> theListOfActors;
@@ -112,6 +128,8 @@ protected:
   std::vector<GateVActor*> theListOfActorsEnabledForPreUserTrackingAction;
   std::vector<GateVActor*> theListOfActorsEnabledForPostUserTrackingAction;
   std::vector<GateVActor*> theListOfActorsEnabledForUserSteppingAction;
+  // Filters of the actors above, resolved once (0 if the actor has no filter)
+  std::vector<GateFilterManager*> theListOfFiltersForUserSteppingAction;
 
   GateActorManagerMessenger* pActorManagerMessenger;  //pointer to the Messenger
   G4int mCurrentEventId;
@@ -121,7 +139,13 @@ private:
   bool resetAfterSaving;
 
   GateActorManager();
-  static GateActorManager *singleton_ActorManager;
+  static G4ThreadLocal GateActorManager *singleton_ActorManager;
+
+#ifdef GATE_USE_MT
+  G4int mThreadId;
+  static GateActorManager * theMasterActorManager;
+  static std::vector<GateActorManager*> theListOfWorkerActorManagers;
+#endif
 };
 
 #endif /* end #define GATEACTORMANAGER_HH */
@@ -49,6 +49,7 @@ protected:
   G4UIcmdWithABool *    pSetOverWriteFilesFlagCmd;
   G4UIcmdWithABool *    pSetResetDataAtEachRunFlagCmd;
   G4UIcmdWithAString *  pAddFilterCmd;
+  G4UIcmdWithAString *  pSetFilterOperatorCmd;
 
   G4String baseName;
 };
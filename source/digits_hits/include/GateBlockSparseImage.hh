@@ -0,0 +1,138 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+
+/*!
+  \class  GateBlockSparseImage
+  \brief  Values of a 3D grid stored by blocks of 8x8x8 voxels, a block is
+  allocated the first time one of its voxels is accessed
+
+  Used by GateImageWithStatistic for large grids where only a small part
+  of the voxels is reached. Each voxel holds a fixed number of channels
+  (value, squared value, temporary value...) stored contiguously, so all
+  the channels of a voxel are reached with a single block lookup. The
+  voxels of the blocks not allocated have the background value of each
+  channel. Voxels are designated by their index in the dense image.
+*/
+
+#ifndef GATEBLOCKSPARSEIMAGE_HH
+#define GATEBLOCKSPARSEIMAGE_HH
+
+#include "GateImage.hh"
+#include <vector>
+
+class GateBlockSparseImage
+{
+public:
+  GateBlockSparseImage();
+
+  static const int kBlockShift = 3;
+  static const int kBlockSize = 1 << kBlockShift;
+  static const int kBlockMask = kBlockSize-1;
+  static const int kBlockNumberOfVoxels = kBlockSize*kBlockSize*kBlockSize;
+
+  // Grid of the dense image and number of values per voxel. All blocks
+  // are released and the background values are set to 0.
+  void SetLayout(const GateVImage & image, int numberOfChannels);
+  int GetNumberOfChannels() const { return mNumberOfChannels; }
+
+  // Value of the voxels not allocated (also the initial value of the
+  // voxels of a new block)
+  void SetBackgroundValue(int channel, double v) { mBackgroundValues[channel] = v; }
+  double GetBackgroundValue(int channel) const { return mBackgroundValues[channel]; }
+
+  // Release all the blocks
+  void Clear();
+
+  // Channels of the voxel, the block is allocated if needed. The pointer
+  // is invalidated by the next block allocation.
+  inline double * GetValues(int index);
+  // Channels of the voxel, 0 when its block is not allocated
+  inline const double * FindValues(int index) const;
+
+  // Allocated blocks (in allocation order) and their channels, voxel v of
+  // the block b starts at GetBlockValues(b)[v*GetNumberOfChannels()]
+  size_t GetNumberOfAllocatedBlocks() const { return mAllocatedBlocks.size(); }
+  int GetBlockId(size_t b) const { return mAllocatedBlocks[b]; }
+  double * GetBlockValues(size_t b) { return &mValues[b*mBlockStride]; }
+  const double * GetBlockValues(size_t b) const { return &mValues[b*mBlockStride]; }
+  // Channels of the block of this id, allocated if needed
+  double * GetBlockValuesFromId(int blockId);
+
+  // Index in the dense image of the voxel v of a block, -1 when the voxel
+  // is outside the grid (last blocks along each axis)
+  int GetVoxelIndex(int blockId, int v) const;
+
+  // Number of voxels of the grid that are not in an allocated block
+  long GetNumberOfBackgroundVoxels() const;
+
+  // Copy one channel (multiplied by scale) to an allocated image with the
+  // same layout
+  void CopyChannelToImage(int channel, GateImageDouble & image, double scale=1.0) const;
+
+  // Memory used by the blocks (bytes)
+  size_t GetMemorySize() const { return mValues.capacity()*sizeof(double); }
+
+protected:
+  inline int GetBlockIdAndVoxel(int index, int & v) const;
+  double * AllocateBlock(int blockId);
+
+  int mSizeX;
+  int mSizeY;
+  int mSizeZ;
+  int mNumberOfBlocksX;
+  int mNumberOfBlocksY;
+  int mNumberOfBlocksZ;
+  int mNumberOfChannels;
+  size_t mBlockStride;
+
+  std::vector<double> mBackgroundValues;
+  // Allocated block number of each block id, -1 when not allocated
+  std::vector<int> mBlockNumbers;
+  // Block id of each allocated block
+  std::vector<int> mAllocatedBlocks;
+  std::vector<double> mValues;
+};
+
+//-----------------------------------------------------------------------------
+inline int GateBlockSparseImage::GetBlockIdAndVoxel(int index, int & v) const
+{
+  int x = index % mSizeX;
+  int r = index / mSizeX;
+  int y = r % mSizeY;
+  int z = r / mSizeY;
+  v = (x & kBlockMask) + ((y & kBlockMask) << kBlockShift) + ((z & kBlockMask) << (2*kBlockShift));
+  return (x >> kBlockShift) +
+    ((y >> kBlockShift) + (z >> kBlockShift)*mNumberOfBlocksY)*mNumberOfBlocksX;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+inline double * GateBlockSparseImage::GetValues(int index)
+{
+  int v;
+  int blockId = GetBlockIdAndVoxel(index, v);
+  int b = mBlockNumbers[blockId];
+  double * values = (b < 0 ? AllocateBlock(blockId) : &mValues[b*mBlockStride]);
+  return values + v*mNumberOfChannels;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+inline const double * GateBlockSparseImage::FindValues(int index) const
+{
+  int v;
+  int b = mBlockNumbers[GetBlockIdAndVoxel(index, v)];
+  if (b < 0) return 0;
+  return &mValues[b*mBlockStride + v*mNumberOfChannels];
+}
+//-----------------------------------------------------------------------------
+
+#endif /* end #define GATEBLOCKSPARSEIMAGE_HH */
@@ -19,6 +19,7 @@ See LICENSE.md for further details
 
 #include "GateVBlurringLaw.hh"
 #include "GateInverseSquareBlurringLaw.hh"
+#include "GateResolutionTable.hh"
 
 class GateBlurringMessenger;
 
@@ -27,6 +28,11 @@ class GateBlurringMessenger;
 
     - GateBlurring - by Martin.Rey@epfl.ch
 
+    - The resolution can also be taken from a GateResolutionTable, read from a file
+      (resolution vs energy for each crystal) or tabulated from the law when the
+      first pulse is processed. The crystal index is computed from the output
+      volume ID of the pulse, using all the levels of the system.
+
       \sa GateVPulseProcessor
 */
 class GateBlurring : public GateVPulseProcessor
@@ -54,6 +60,11 @@ class GateBlurring : public GateVPulseProcessor
       Choose between "linear" and "inverseSquare" blurring law
     */
     inline void SetBlurringLaw(GateVBlurringLaw* law)   { m_blurringLaw = law; }
+
+    //! Use the resolution table read from this file
+    void SetResolutionTable(const G4String& filename);
+    //! Use a table of the blurring law, computed when the first pulse is processed
+    void SetLawTabulation(G4double eMin, G4double eMax, size_t nbEnergies);
     //@}
 
 
@@ -69,10 +80,37 @@ class GateBlurring : public GateVPulseProcessor
     void ProcessOnePulse(const GatePulse* inputPulse,GatePulseList& outputPulseList);
 
   private:
+    //! Resolution of the pulse, from the table if any, otherwise from the law
+    inline G4double ComputeResolution(const GatePulse* pulse, G4double energy);
+    //! Check the table and compute the crystal index strides of the system
+    void InitResolutionTable();
+    size_t ComputeCrystalIndex(const GateOutputVolumeID& volumeID) const;
+
     GateVBlurringLaw* m_blurringLaw;
     GateBlurringMessenger *m_messenger;   //!< Messenger
 
+    GateResolutionTable* m_resolutionTable;   //!< 0 when the law is used
+    G4bool   m_tabulateLaw;                    //!< The table is computed from the law at initialisation
+    G4double m_tabulationEMin;
+    G4double m_tabulationEMax;
+    size_t   m_tabulationNbEnergies;
+    G4bool   m_resolutionTableInitDone;
+    std::vector<size_t> m_crystalStrides;      //!< Crystal index increment of each level of the system
+    size_t   m_nbCrystals;                     //!< Number of rows of the table
+
 };
 
 
+inline G4double GateBlurring::ComputeResolution(const GatePulse* pulse, G4double energy)
+{
+  if (!m_resolutionTable)
+    return m_blurringLaw->ComputeResolution(energy);
+  if (!m_resolutionTableInitDone)
+    InitResolutionTable();
+  if (m_resolutionTable->GetNumberOfCrystals() == 1)
+    return m_resolutionTable->GetResolution(0, energy);
+  return m_resolutionTable->GetResolution(ComputeCrystalIndex(pulse->GetOutputVolumeID()), energy);
+}
+
+
 #endif
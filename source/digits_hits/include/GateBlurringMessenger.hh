@@ -40,6 +40,8 @@ class GateBlurringMessenger: public GatePulseProcessorMessenger
     GateVBlurringLaw* CreateBlurringLaw(const G4String& law);
 
     G4UIcmdWithAString *lawCmd;
+    G4UIcmdWithAString *resolutionTableCmd;
+    G4UIcommand        *tabulateLawCmd;
 
 };
 
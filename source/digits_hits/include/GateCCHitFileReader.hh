@@ -81,6 +81,14 @@ public:
     //! Set the hit file name
     void   SetFileName(const G4String aName)   { m_fileName = aName; };
 
+    //! Only read the events whose hits are in [start,stop[ (to call before PrepareAcquisition).
+    //! The hit tree is expected to be time ordered, the first and last entries are found by a
+    //! binary search on the time branch. Used to digitize a hit file in independent chunks.
+    void   SetTimeWindow(G4double start, G4double stop) { m_startTime = start; m_stopTime = stop; };
+    //! Size of the ROOT read cache (bytes): the baskets of all the branches are read by large
+    //! blocks instead of one entry at a time
+    void   SetCacheSize(Long64_t size)         { m_cacheSize = size; };
+
     /*! \brief Overload of the base-class virtual method to print-out a description of the reader
 
     \param indent: the print-out indentation (cosmetic parameter)
@@ -92,6 +100,9 @@ protected:
     //! Reads a set of hit data from the hit-tree, and stores them into the root-hit buffer
     void LoadHitData();
 
+    //! First entry of the hit-tree with a time not before aTime
+    Long64_t FindFirstEntry(G4double aTime);
+
 protected:
 
     G4String    	      m_fileName;     	      //!< Name of the input hit-file
@@ -100,8 +111,12 @@ protected:
     TFile*              m_hitFile;       	      //!< the input hit file
 
     TTree*              m_hitTree;       	      //!< the input hit tree
-    Stat_t       	      m_entries;      	      //!< Number of entries in the tree
-    G4int       	      m_currentEntry; 	      //!< Current entry in the tree
+    Long64_t       	      m_entries;      	      //!< Number of entries in the tree
+    Long64_t       	      m_currentEntry; 	      //!< Current entry in the tree
+    Long64_t       	      m_lastEntry; 	      //!< Entry where the reading stops
+    G4double                 m_startTime;             //!< Start of the time window to read
+    G4double                 m_stopTime;              //!< Stop of the time window to read (no window if not after start)
+    Long64_t                 m_cacheSize;             //!< Size of the ROOT read cache
 
 
     GateCCRootHitBuffer        m_hitBuffer;       	      //!< Buffer to store the data read from the hit-tree
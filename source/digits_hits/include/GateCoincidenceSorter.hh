@@ -14,7 +14,9 @@ See LICENSE.md for further details
 #include <iostream>
 #include <list>
 #include <deque>
+#include <vector>
 #include "G4ThreeVector.hh"
+#include "CLHEP/Random/RandomEngine.h"
 
 #include "GateCoincidencePulse.hh"
 #include "GateClockDependent.hh"
@@ -116,7 +118,7 @@ public:
     const G4String& GetInputName() const
     { return m_inputName; }
     void SetInputName(const G4String& anInputName)
-    {  m_inputName = anInputName; }
+    {  m_inputName = anInputName; m_inputSlot = -1; }
 
     const G4String& GetOutputName() const
     { return m_outputName; }
@@ -148,6 +150,10 @@ public:
 
     void SetMultiplesPolicy(const G4String& policy);
 
+    //! Add a coincidence window evaluated on the same sorted singles, with its
+    //! own output. The jitters and the other parameters are those of the sorter.
+    void AddWindow(const G4String& outputName, G4double window, G4double offset, const G4String& policy);
+
 protected:
     //! \name Parameters of the sorter
     //@{
@@ -156,6 +162,7 @@ protected:
     GateVSystem         *m_system;                      //!< System to which the sorter is attached
     G4String            m_outputName;
     G4String            m_inputName;
+    G4int               m_inputSlot;                    //!< Digitizer slot of the input, bound on the first event
     G4double            m_coincidenceWindow;            //!< Coincidence time window
     G4double            m_coincidenceWindowJitter;      //!< Coincidence time window jitter
     G4double            m_offset;                       //!< Offset window
@@ -173,7 +180,21 @@ private:
     //! \name Work storage variable
     //@{
 
-    std::list<GatePulse*> m_presortBuffer;      // incoming pulses are presorted and buffered
+    //! Pulse of the presort buffer. The buffer is a binary heap whose top is
+    //! the earliest pulse; pulses with equal times leave it in arrival order.
+    struct PresortedPulse {
+      G4double   time;
+      G4long     order;
+      GatePulse* pulse;
+    };
+    struct IsLaterPresortedPulse {
+      inline bool operator()(const PresortedPulse& a, const PresortedPulse& b) const
+      { return a.time > b.time || (a.time == b.time && a.order > b.order); }
+    };
+
+    std::vector<PresortedPulse> m_presortBuffer; // incoming pulses are presorted and buffered
+    G4long                m_presortOrder;       // arrival counter of the presorted pulses
+    std::vector<GatePulse*> m_pulsePool;        // discarded pulses, reused for the next copies
     G4int                 m_presortBufferSize;
     G4bool                m_presortWarning;     // avoid repeat warnings
     bool                m_CCSorter;     // compton camera sorter
@@ -184,12 +205,26 @@ private:
 
     std::deque<GateCoincidencePulse*> m_coincidencePulses;  // open coincidence windows
 
-    void ProcessCompletedCoincidenceWindow(GateCoincidencePulse*);
+    //! Additional window setting, sharing the presort buffer of the sorter
+    struct CoincidenceWindow {
+      G4String            outputName;
+      G4double            window;
+      G4double            offset;
+      multiple_policy_t   multiplesPolicy;
+      std::deque<GateCoincidencePulse*> coincidencePulses;  // open coincidence windows
+    };
+    std::vector<CoincidenceWindow> m_additionalWindows;
+    CLHEP::HepRandomEngine* m_windowsRandomEngine;  // jitters of the additional windows
+
+    static multiple_policy_t ParseMultiplesPolicy(const G4String& policy);
+    void ProcessPulseInWindow(GatePulse* pulse, CoincidenceWindow& window);
+
+    void ProcessCompletedCoincidenceWindow(GateCoincidencePulse*, multiple_policy_t policy, G4double window);
     void ProcessCompletedCoincidenceWindow4CC(GateCoincidencePulse *);
 
     G4bool IsForbiddenCoincidence(const GatePulse* pulse1,const GatePulse* pulse2);
     G4bool IsCoincidenceGood4CC(GateCoincidencePulse* coincidence);
-    GateCoincidencePulse* CreateSubPulse(GateCoincidencePulse* coincidence, G4int i, G4int j);
+    GateCoincidencePulse* CreateSubPulse(GateCoincidencePulse* coincidence, G4int i, G4int j, G4double window);
     G4int ComputeSectorID(const GatePulse& pulse);
     static G4int          gm_coincSectNum;     // internal use
 
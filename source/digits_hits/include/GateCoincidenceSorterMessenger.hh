@@ -68,6 +68,7 @@ private:
     G4UIcmdWithAString          *MultiplePolicyCmd;  //!< The UI command "MultiplesPolicy"
     G4UIcmdWithABool            *AllPulseOpenCoincGateCmd;  //!< The UI command "allowMultiples"
     G4UIcmdWithABool            *SetTriggerOnlyByAbsorberCmd;
+    G4UIcommand                 *addWindowCmd;       //!< The UI command "addWindow"
     
     
 };
@@ -12,12 +12,18 @@ See LICENSE.md for further details
 
 #include "G4VSensitiveDetector.hh"
 #include "GateCrystalHit.hh"
+#include "GateVolumeID.hh"
+#include "GateOutputVolumeID.hh"
+#include <unordered_map>
 class G4Step;
 class G4HCofThisEvent;
 class G4TouchableHistory;
 
 class GateVVolume;
 class GateVSystem;
+class GateRotationMove;
+class GateOrbitingMove;
+class GateEccentRotMove;
 
 //! List of typedefs for the multi-system usage.
 typedef std::vector<GateVSystem*> GateSystemList;
@@ -84,6 +90,19 @@ class GateCrystalSD : public G4VSensitiveDetector
      GateVSystem* m_system;                           //! System to which the SD is attached //mhadi_obso obsollete, because we use the multi-system approach
      GateSystemList* m_systemList;                    //! System list instead of one system
   private:
+      //! Data of a volume that do not change during a run, computed the first time the volume is hit
+      struct VolumeInfo {
+        GateVSystem*       system;
+        GateOutputVolumeID outputVolumeID;
+        GateRotationMove*  rotationMove;     //! moves of the system base component giving the scanner angle
+        GateOrbitingMove*  orbitingMove;
+        GateEccentRotMove* eccentRotMove;
+      };
+      const VolumeInfo& GetVolumeInfo(const GateVolumeID& volumeID);
+
+      std::unordered_map<GateVolumeID,VolumeInfo,GateVolumeIDHash> m_volumeInfoCache; //! Cleared at each run (time slice)
+      G4int m_volumeInfoCacheRunID;                  //! Run of the cached data
+
       GateCrystalHitsCollection * crystalCollection;  //! Hit collection
 
       static const G4String theCrystalCollectionName; //! Name of the hit collection
@@ -19,6 +19,7 @@
 #include "GateObjectStore.hh"
 
 class GateDeadTimeMessenger;
+class GateVVolume;
 
 
 /*! \class  GateDeadTime
@@ -87,6 +88,9 @@ private:
   G4int m_testVolume;     //!< equal to 1 if the volume name is valid, 0 else
   std::vector<int> numberOfComponentForLevel; //!< Table of number of element for each geometric level
   G4int numberOfHigherLevels ;  //!< number of geometric level higher than the one chosen by the user
+  std::vector<G4int> m_levelMultipliers; //!< Factor of the copy number of each higher level in the element ID
+  GateVVolume* m_volumeCreator;  //!< Creator of the volume where Dead time is applied
+  G4int m_initDoneRunID;   //!< Run for which the dead-time table was initialised
   unsigned long long int m_deadTime; //!< DeadTime value
   // was :  G4String m_deadTimeMode;   //!< dead time mode : paralysable nonparalysable
   G4bool m_isParalysable;   //!< dead time mode : paralysable (true) nonparalysable (false) (modif. by D. Guez on 03/03/04)
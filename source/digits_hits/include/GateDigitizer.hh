@@ -16,6 +16,8 @@
 
 #include "globals.hh"
 #include <vector>
+#include <string>
+#include <unordered_map>
 #include "G4VDigitizerModule.hh"
 
 #include "GateClockDependent.hh"
@@ -92,6 +94,20 @@ public:
   //! Find a pulse-list from the array of pulse-list
   std::vector<GateCoincidencePulse*> FindCoincidencePulse(const G4String& pulseName);
 
+  //! Slot of a pulse-list name (created on the first call). The chains,
+  //! sorters and digi-makers bind their input once to a slot, the
+  //! per-event lookups are then an array indexing.
+  G4int GetPulseListSlot(const G4String& pulseListName);
+  //! Find the pulse-list (alias first) stored this event under a slot
+  GatePulseList* FindPulseList(G4int slot);
+  //! Store a new alias for a pulse-list into a slot
+  void StorePulseListAlias(G4int slot,GatePulseList* aPulseList);
+
+  //! Same as above for the coincidence pulses
+  G4int GetCoincidencePulseSlot(const G4String& pulseName);
+  std::vector<GateCoincidencePulse*> FindCoincidencePulse(G4int slot);
+  void StoreCoincidencePulseAlias(G4int slot,GateCoincidencePulse* aPulse);
+
   //! Clear the array of pulse-lists
   void ErasePulseListVector();
 
@@ -177,8 +193,18 @@ protected:
 private:
   std::vector<GatePulseList*>            	m_pulseListVector;
   std::vector<GateCoincidencePulse*>     	m_coincidencePulseVector;
-  std::vector<GatePulseListAlias>      		m_pulseListAliasVector;
-   std::vector<GateCoincidencePulseListAlias>    m_coincidencePulseListAliasVector;
+
+  //! Slots of the pulse-list names, kept for the whole simulation. For
+  //! each slot, the alias and the list of that name stored this event.
+  std::unordered_map<std::string,G4int>         m_pulseListSlotMap;
+  std::vector<GatePulseList*>                   m_pulseListAliasSlots;
+  std::vector<GatePulseList*>                   m_pulseListNameSlots;
+
+  //! Slots of the coincidence pulse names. For each slot, the aliases and
+  //! the pulses of that name stored this event.
+  std::unordered_map<std::string,G4int>         m_coincidencePulseSlotMap;
+  std::vector< std::vector<GateCoincidencePulse*> > m_coincidencePulseAliasSlots;
+  std::vector< std::vector<GateCoincidencePulse*> > m_coincidencePulseNameSlots;
 
 
   static GateDigitizer*      			theDigitizer;
@@ -29,7 +29,10 @@
 #include "GateDoseActorMessenger.hh"
 #include "GateImageWithStatistic.hh"
 #include "GateVoxelizedMass.hh"
+#include "GateDoseStepFilter.hh"
 #include "GateRegionDoseStat.hh"
+#include "GateStoppingPowerRatioTable.hh"
+#include "GateDoseEfficiencyCurve.hh"
 
 class G4EmCalculator;
 
@@ -71,8 +74,11 @@ public:
   void EnableDoseToOtherMaterialNormalisationToMax(bool b);
   void EnableDoseToOtherMaterialNormalisationToIntegral(bool b);
   void SetOtherMaterial(G4String b) { mOtherMaterial = b; }
+  void SetStoppingPowerRatioTableBins(int n) { mStoppingPowerRatioTableBins = n; }
+  void SetStoppingPowerRatioTableTolerance(double t) { mStoppingPowerRatioTableTolerance = t; }
   //Others
   void EnableNumberOfHitsImage(bool b) { mIsNumberOfHitsImageEnabled = b; }
+  void EnableSparseStorage(bool b) { mIsSparseStorageEnabled = b; }
   void SetDoseAlgorithmType(G4String b) { mDoseAlgorithmType = b; }
   void ImportMassImage(G4String b) { mImportMassImage = b; }
   void ExportMassImage(G4String b) { mExportMassImage = b; }
@@ -87,13 +93,17 @@ public:
   virtual void BeginOfRunAction(const G4Run*r);
   virtual void BeginOfEventAction(const G4Event * event);
 
-  virtual void UserSteppingActionInVoxel(const int index, const G4Step* step);
+  virtual void UserSteppingActionInVoxel(const int index, const G4Step* step) {
+    (this->*pUserSteppingActionInVoxel)(index, step);
+  }
   virtual void UserPreTrackActionInVoxel(const int /*index*/, const G4Track* track);
+  virtual bool IsRayCastStepHitTypeSupported() const { return true; }
   virtual void UserPostTrackActionInVoxel(const int /*index*/, const G4Track* /*t*/) {}
 
   //  Saves the data collected to the file
   virtual void SaveData();
   virtual void ResetData();
+  virtual void MergeDataFrom(GateVActor * workerActor);
 
   // Scorer related
   virtual void Initialize(G4HCofThisEvent*){}
@@ -101,10 +111,18 @@ public:
 
 protected:
   GateDoseActor(G4String name, G4int depth=0);
+  void InitializeStoppingPowerRatioTable(GateStoppingPowerRatioTable & table, const G4Material * target);
+
+  // Step processing specialised at Construct, depending on whether the
+  // dosel mass is needed (mass weighting, volume or material filter)
+  template<bool UseVoxelizedMass>
+  void UserSteppingActionInVoxelT(const int index, const G4Step* step);
+  void (GateDoseActor::*pUserSteppingActionInVoxel)(const int index, const G4Step* step);
   GateDoseActorMessenger* pMessenger;
   GateVoxelizedMass mVoxelizedMass;
 
   int mCurrentEvent;
+  int mLastMergedEvent;
   StepHitType mUserStepHitType;
 
   bool mIsLastHitEventImageEnabled;
@@ -133,6 +151,7 @@ protected:
   bool mIsDoseToOtherMaterialNormalisationEnabled;
   //Others
   bool mIsNumberOfHitsImageEnabled;
+  bool mIsSparseStorageEnabled;
   bool mTestFlag;
 
   //Edep
@@ -143,13 +162,14 @@ protected:
   GateImageWithStatistic mDoseImage;
     //Efficiency option
   G4String mDoseEfficiencyFile;
-  std::vector<double> mDoseEnergy;
-  std::vector<double> mDoseEfficiency;
+  GateDoseEfficiencyCurve mDoseEfficiencyCurve;
     //Efficiency option by Z (by ion atomic number)
   std::vector<G4String> mDoseEfficiencyFileByZ;
   std::vector<G4int> mDoseZByZ;
-  std::vector<std::vector<double>> mDoseEnergyByZ;
-  std::vector<std::vector<double>> mDoseEfficiencyByZ;
+  std::vector<GateDoseEfficiencyCurve> mDoseEfficiencyCurvesByZ;
+  // index in mDoseEfficiencyCurvesByZ of the curve for Z = mDoseEfficiencyMinZ + i (-1 if none)
+  std::vector<int> mDoseEfficiencyCurveIndexByZ;
+  int mDoseEfficiencyMinZ;
   //DoseToWater
   G4String mDoseToWaterFilename;
   GateImageWithStatistic mDoseToWaterImage;
@@ -157,10 +177,19 @@ protected:
   G4String mDoseToOtherMaterialFilename;
   GateImageWithStatistic mDoseToOtherMaterialImage;
   G4String mOtherMaterial;
+  double mOtherMaterialDensity;
+  //Stopping power ratios for DoseToWater and DoseToOtherMaterial
+  GateStoppingPowerRatioTable mDoseToWaterRatioTable;
+  GateStoppingPowerRatioTable mDoseToOtherMaterialRatioTable;
+  int mStoppingPowerRatioTableBins;
+  double mStoppingPowerRatioTableTolerance;
   //Hits
   G4String mNbOfHitsFilename;
   GateImageInt mNumberOfHitsImage;
+  bool mIsNumberOfHitsTrackingEnabled;         // worker: merged over the voxels hit since the last merge
+  std::vector<int> mNumberOfHitsTouchedVoxels;
   GateImageInt mLastHitEventImage;
+  GateBlockSparseImage mSparseLastHitEventImage; // used with sparse storage
   //Others
   GateImageDouble mMassImage;
   //Regions
@@ -177,6 +206,7 @@ protected:
   G4String mExportMassImage;
   G4String mVolumeFilter;
   G4String mMaterialFilter;
+  GateDoseStepFilter mStepFilter;
 
   G4EmCalculator* emcalc;
 
@@ -18,6 +18,8 @@
 
 #include "G4UIcmdWithABool.hh"
 #include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADouble.hh"
 #include "GateImageActorMessenger.hh"
 
 class GateDoseActor;
@@ -59,8 +61,11 @@ protected:
   G4UIcmdWithABool * pEnableDoseToOtherMaterialNormToMaxCmd;
   G4UIcmdWithABool * pEnableDoseToOtherMaterialNormToIntegralCmd;
   G4UIcmdWithAString * pSetOtherMaterialCmd;
+  G4UIcmdWithAnInteger * pSetStoppingPowerRatioTableBinsCmd;
+  G4UIcmdWithADouble * pSetStoppingPowerRatioTableToleranceCmd;
   //Others
   G4UIcmdWithABool * pEnableNumberOfHitsCmd;
+  G4UIcmdWithABool * pEnableSparseStorageCmd;
   G4UIcmdWithAString * pSetDoseAlgorithmCmd;
   G4UIcmdWithAString * pImportMassImageCmd;
   G4UIcmdWithAString * pExportMassImageCmd;
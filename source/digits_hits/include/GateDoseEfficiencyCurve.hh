@@ -0,0 +1,74 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+
+/*!
+  \class  GateDoseEfficiencyCurve
+  \brief  Detector efficiency as a function of the energy, used by the
+  dose actor to weight the dose (film/diode response...)
+
+  Points are read from a file (number of points, then "energy efficiency"
+  lines ordered by increasing energy). The efficiency is linearly
+  interpolated; the bin is found with a binary search, the last bin
+  found is tried first since consecutive steps usually have close
+  energies.
+*/
+
+#ifndef GATEDOSEEFFICIENCYCURVE_HH
+#define GATEDOSEEFFICIENCYCURVE_HH
+
+#include "G4String.hh"
+#include <vector>
+
+class GateDoseEfficiencyCurve
+{
+public:
+  GateDoseEfficiencyCurve();
+
+  void Read(G4String filename);
+  const G4String & GetFilename() const { return mFilename; }
+
+  // Efficiency at this energy. Below the first point the first
+  // efficiency is used; above the last point the efficiency is 1.
+  inline double GetEfficiency(double energy);
+
+protected:
+  double GetEfficiencyAboveLastPoint();
+
+  G4String mFilename;
+  std::vector<double> mEnergy;
+  std::vector<double> mEfficiency;
+  std::vector<double> mSlope;
+  size_t mLastBin;
+  bool mIsAboveRangeWarningDone;
+};
+
+//-----------------------------------------------------------------------------
+inline double GateDoseEfficiencyCurve::GetEfficiency(double energy)
+{
+  const size_t n = mEnergy.size();
+  if (energy >= mEnergy[n-1]) return GetEfficiencyAboveLastPoint();
+  if (energy < mEnergy[0]) return mEfficiency[0];
+
+  // bin i is [mEnergy[i], mEnergy[i+1])
+  size_t i = mLastBin;
+  if (energy < mEnergy[i] || energy >= mEnergy[i+1]) {
+    size_t inf = 0;
+    size_t sup = n-1;
+    while (sup - inf > 1) {
+      size_t mid = (inf + sup)/2;
+      if (mEnergy[mid] > energy) sup = mid;
+      else inf = mid;
+    }
+    i = mLastBin = inf;
+  }
+  return mEfficiency[i] + mSlope[i]*(energy-mEnergy[i]);
+}
+//-----------------------------------------------------------------------------
+
+#endif /* end #define GATEDOSEEFFICIENCYCURVE_HH */
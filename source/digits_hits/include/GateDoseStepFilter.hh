@@ -0,0 +1,57 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See LICENSE.md for further details
+----------------------*/
+
+/*!
+  \class  GateDoseStepFilter
+  \brief  Volume and material filters (setVolumeFilter, setMaterialFilter)
+  of the dose actors, resolved once at Construct
+ */
+
+#ifndef GATEDOSESTEPFILTER_HH
+#define GATEDOSESTEPFILTER_HH
+
+#include <algorithm>
+#include <vector>
+
+#include "G4String.hh"
+#include "G4StepPoint.hh"
+
+class G4Material;
+class G4VPhysicalVolume;
+
+class GateDoseStepFilter
+{
+ public:
+
+  GateDoseStepFilter();
+
+  // Looks up the physical volumes and the material from their names (no
+  // filter if empty), warns with the actor name when nothing matches
+  void Initialize(const G4String& actorName, const G4String& volumeName, const G4String& materialName);
+
+  bool HasVolumeFilter() const { return mHasVolumeFilter; }
+  bool HasMaterialFilter() const { return mHasMaterialFilter; }
+  // The filtered dose needs the dosel mass of the filtered part
+  bool IsEnabled() const { return mHasVolumeFilter || mHasMaterialFilter; }
+
+  // True when the step starts outside the filtered volumes or material
+  bool Rejects(const G4StepPoint* preStep) const {
+    return (mHasVolumeFilter &&
+            std::find(mVolumes.begin(), mVolumes.end(), preStep->GetPhysicalVolume()) == mVolumes.end()) ||
+           (mHasMaterialFilter && preStep->GetMaterial() != mMaterial);
+  }
+
+ protected:
+  bool mHasVolumeFilter;
+  bool mHasMaterialFilter;
+  // all the physical volumes with the name (repeated volumes share the name)
+  std::vector<const G4VPhysicalVolume*> mVolumes;
+  const G4Material* mMaterial;
+};
+
+#endif
@@ -18,6 +18,8 @@ See LICENSE.md for further details
 #define GATEIMAGEWITHSTATISTIC_HH
 
 #include "GateImage.hh"
+#include "GateBlockSparseImage.hh"
+#include <vector>
 
 //-----------------------------------------------------------------------------
 /// \brief
@@ -62,6 +64,24 @@ class GateImageWithStatistic
   virtual void UpdateSquaredImage();
   virtual void UpdateUncertaintyImage(int numberOfEvents);
 
+  // Add the values of an image with the same layout (multithreaded mode:
+  // image of a worker thread) and reset 'image'. The pending values of the
+  // last events of 'image' are flushed first, so the squared image stays
+  // exact per event. Only the voxels touched since the previous merge are
+  // visited when 'image' tracks them.
+  void Merge(GateImageWithStatistic & image);
+
+  // Keep the list of voxels modified since the last Reset/Merge (enabled
+  // by Allocate in the worker threads of the multithreaded mode)
+  void EnableTouchedVoxelsTracking(bool b) { mIsTouchedVoxelsTrackingEnabled = b; }
+
+  // Store the values by blocks of 8x8x8 voxels allocated on first touch
+  // instead of dense images (large grids with few voxels reached). The
+  // dense images are only built, one at a time, by SaveData; the value
+  // and uncertainty images then only hold the layout. Set before Allocate.
+  void EnableSparseStorage(bool b) { mIsSparseStorageEnabled = b; }
+  bool IsSparseStorageEnabled() const { return mIsSparseStorageEnabled; }
+
   GateVImage & GetValueImage() { return mValueImage; }
   GateVImage & GetUncertaintyImage() { return mUncertaintyImage; }
 
@@ -70,6 +90,20 @@ class GateImageWithStatistic
   void SetTransformMatrix(const G4RotationMatrix & m);
 
   protected:
+  inline void TouchVoxel(const int index) {
+    if (mIsTouchedVoxelsTrackingEnabled && !mTouchedVoxelsMask[index]) {
+      mTouchedVoxelsMask[index] = true;
+      mTouchedVoxels.push_back(index);
+    }
+  }
+  void ResetTouchedVoxels();
+  void SaveSparseData(int numberOfEvents, bool normalise);
+  void MergeSparse(GateImageWithStatistic & image);
+  static double ComputeRelativeUncertainty(double sum, double squaredSum, int numberOfEvents);
+
+  // Channels of the sparse storage
+  enum { ValueChannel = 0, SquaredChannel = 1, TempChannel = 2 };
+
   GateImageDouble mValueImage;
   GateImageDouble mSquaredImage;
   GateImageDouble mTempImage;
@@ -83,6 +117,12 @@ class GateImageWithStatistic
   bool mIsSquaredImageEnabled;
   bool mIsUncertaintyImageEnabled;
   bool mIsValuesMustBeScaled;
+  bool mIsTouchedVoxelsTrackingEnabled;
+  bool mIsSparseStorageEnabled;
+
+  std::vector<int> mTouchedVoxels;
+  std::vector<bool> mTouchedVoxelsMask;
+  GateBlockSparseImage mSparseImage;
 
   double mScaleFactor;
 
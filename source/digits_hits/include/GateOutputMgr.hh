@@ -108,6 +108,10 @@ public:
   //! If it is not the case the module is disabled and a warning is sent.
   void CheckFileNameForAllOutput();
 
+  //! Return the number of enabled output modules (must be called after
+  //! CheckFileNameForAllOutput, which disables the modules without file name)
+  G4int GetNumberOfEnabledModules();
+
   //! Return the current crystal-hit collection (if nay)
   GateCrystalHitsCollection*  	  GetCrystalHitCollection();
   //! Return the current phantom-hit collection (if nay)
@@ -125,6 +129,11 @@ public:
 
   inline void AllowNoOutput() {m_allowNoOutput=true;}
 
+  //! The blocks of the numpy, binary and ASCII outputs are written by a background
+  //! thread, through a queue of at most queueSize bytes
+  void SetAsynchronousWriting(G4bool flag);
+  void SetAsynchronousQueueSize(size_t queueSize);
+
   /* PY Descourt 11/12/2008 */
   void RecordTracks(GateSteppingAction*);
 
@@ -17,6 +17,7 @@ class GateClock;
 class G4UIdirectory;
 class G4UIcmdWithAString;
 class G4UIcmdWithAnInteger;
+class G4UIcmdWithABool;
 class G4UIcmdWithADouble;
 class G4UIcmdWithADoubleAndUnit;
 class G4UIcmdWith3VectorAndUnit;
@@ -39,6 +40,8 @@ private:
   G4UIcmdWithoutParameter*             DescribeCmd;
   G4UIcmdWithAnInteger*                VerboseCmd;
   G4UIcmdWithoutParameter*             AllowNoOutputCmd;
+  G4UIcmdWithABool*                    AsynchronousWritingCmd;
+  G4UIcmdWithAnInteger*                AsynchronousQueueSizeCmd;
 };
 
 #endif
@@ -13,6 +13,7 @@
 
 #include "GateVActor.hh"
 #include "GateImage.hh"
+#include "GateVImageActor.hh"
 #include "GateTreeFileManager.hh"
 
 struct iaea_header_type;
@@ -163,6 +164,7 @@ protected:
   bool mMaskIsEnabled;
   G4String mMaskFilename;
   GateImage mMask;
+  GateVImageActor::TouchableDepthCache mMaskDepthCache;
   bool mKillParticleFlag;
 
   bool bEnableTOut;
@@ -13,12 +13,13 @@ See LICENSE.md for further details
 #include "globals.hh"
 #include <iostream>
 #include <vector>
+#include <unordered_map>
 #include "G4ThreeVector.hh"
 
 #include "GateVPulseProcessor.hh"
+#include "GateOutputVolumeID.hh"
 
 class GatePileupMessenger;
-class GateOutputVolumeID;
 
 /*! \class  GatePileup
     \brief  Pulse-processor modelling a pileup (maximum energy wins) of a crystal-block
@@ -32,6 +33,10 @@ class GateOutputVolumeID;
     - The class is largely inspired from the GateReadout class,
       but is aimed to work by time and not by event.
 
+    - The waiting pulses are stored by block, so a new pulse is only compared
+      with the pulses of its block, and they leave in their order of creation
+      when their pileup window is over.
+
       \sa GateVPulseProcessor
 */
 class GatePileup : public GateVPulseProcessor
@@ -66,6 +71,7 @@ class GatePileup : public GateVPulseProcessor
     //! It is is called by ProcessPulseList() for each of the input pulses
     //! The result of the pulse-processing is incorporated into the output pulse-list
     virtual GatePulseList* ProcessPulseList(const GatePulseList* inputPulseList);
+    //! The pulse is piled up with the waiting pulses (outputPulseList is not used)
     virtual void ProcessOnePulse(const GatePulse* inputPulse,GatePulseList& outputPulseList);
 
   private:
@@ -75,7 +81,33 @@ class GatePileup : public GateVPulseProcessor
     //! taking place in a same block if the first two figures of their volume IDs are identical
     G4int m_depth;
     G4double m_pileup;
-    GatePulseList m_waiting;
+
+    //! Waiting pulse, with its order of creation
+    struct WaitingPulse {
+      GatePulse* pulse;
+      G4long     order;
+    };
+    struct IsEarlierWaitingPulse {
+      inline bool operator()(const WaitingPulse& a, const WaitingPulse& b) const
+      { return a.order < b.order; }
+    };
+    typedef std::vector<WaitingPulse> WaitingBlock;
+    //! Waiting pulses of each block, in their order of creation
+    std::unordered_map<GateOutputVolumeID,WaitingBlock,GateOutputVolumeIDHash> m_waitingBlocks;
+
+    //! Time of a waiting pulse, the entries whose time changed since are ignored
+    struct WaitingTime {
+      G4double      time;
+      G4long        order;
+      WaitingBlock* block;
+    };
+    struct IsLaterWaitingTime {
+      inline bool operator()(const WaitingTime& a, const WaitingTime& b) const
+      { return a.time > b.time; }
+    };
+    //! Binary heap of the waiting times, the earliest on top
+    std::vector<WaitingTime> m_waitingTimes;
+    G4long m_waitingOrder;
 
     GatePileupMessenger *m_messenger;	  //!< Messenger for this Pileup
 };
@@ -15,6 +15,7 @@ See LICENSE.md for further details
 #include <iostream>
 #include <vector>
 #include "G4ThreeVector.hh"
+#include "G4Allocator.hh"
 
 #include "GateVolumeID.hh"
 #include "GateOutputVolumeID.hh"
@@ -31,6 +32,10 @@ See LICENSE.md for further details
 
     - S. Stute: june2014, add two methods used in the new GateReadout implementation
 
+    - Pulses are copied at each step of the processor chain: they are allocated
+      from a (per thread) G4Allocator and their strings (volume/process names)
+      are shared, a pulse only holds a pointer to them
+
       \sa GateVPulseProcessor, GatePulseProcessorChain
 */
 class GateVSystem;
@@ -50,6 +55,9 @@ public:
     //! Destructor
     virtual inline ~GatePulse() {}
 
+    inline void* operator new(size_t);
+    inline void  operator delete(void*);
+
 public:
     //! \name getters and setters to acces the content of the pulse
     //@{
@@ -96,11 +104,11 @@ public:
     inline void  SetNCrystalRayleigh(G4int j)  { m_nCrystalRayleigh = j; }
     inline G4int GetNCrystalRayleigh() const        { return m_nCrystalRayleigh; }
 
-    inline void     SetComptonVolumeName(const G4String& name) { m_comptonVolumeName = name; }
-    inline G4String GetComptonVolumeName() const        { return m_comptonVolumeName; }
+    inline void     SetComptonVolumeName(const G4String& name) { m_comptonVolumeName = InternString(name); }
+    inline const G4String& GetComptonVolumeName() const        { return *m_comptonVolumeName; }
 
-    inline void     SetRayleighVolumeName(const G4String& name) { m_RayleighVolumeName = name; }
-    inline G4String GetRayleighVolumeName() const        { return m_RayleighVolumeName; }
+    inline void     SetRayleighVolumeName(const G4String& name) { m_RayleighVolumeName = InternString(name); }
+    inline const G4String& GetRayleighVolumeName() const        { return *m_RayleighVolumeName; }
 
     inline void  SetVolumeID(const GateVolumeID& volumeID)            { m_volumeID = volumeID; }
     inline const GateVolumeID& GetVolumeID() const                  	{ return m_volumeID; }
@@ -135,8 +143,8 @@ public:
 
 
     // AE : Added for IdealComptonPhot adder which take into account several Comptons in the same volume
-    inline void     SetPostStepProcess(G4String proc) { m_Postprocess = proc; }
-    inline G4String GetPostStepProcess() const             { return m_Postprocess; }
+    inline void     SetPostStepProcess(const G4String& proc) { m_Postprocess = InternString(proc); }
+    inline const G4String& GetPostStepProcess() const             { return *m_Postprocess; }
 
     inline void SetEnergyIniTrack(G4double eIni)          { m_energyIniTrack = eIni; }
     inline G4double GetEnergyIniTrack() const                { return m_energyIniTrack; }
@@ -154,8 +162,8 @@ public:
     inline G4int GetNCrystalConv() const                { return m_nCrystalConv; }
 
 
-    inline void     SetProcessCreator(G4String proc) { m_processCreator = proc; }
-    inline G4String GetProcessCreator() const             { return m_processCreator; }
+    inline void     SetProcessCreator(const G4String& proc) { m_processCreator = InternString(proc); }
+    inline const G4String& GetProcessCreator() const             { return *m_processCreator; }
 
     inline void SetTrackID(G4int trkID)          { m_trackID = trkID; }
     inline G4int GetTrackID() const                { return m_trackID; }
@@ -192,6 +200,9 @@ public:
     //! printing methods
     friend std::ostream& operator<<(std::ostream&, const GatePulse&);
 
+    //! Shared copy of a string (never released), one set per thread
+    static const G4String* InternString(const G4String& s);
+
 private:
     //! \name pulse data
     //@{
@@ -208,8 +219,8 @@ private:
     G4int m_nCrystalCompton;    	  //!< # of compton processes in the crystal occurred to the photon
     G4int m_nPhantomRayleigh;    	  //!< # of Rayleigh processes in the phantom occurred to the photon
     G4int m_nCrystalRayleigh;    	  //!< # of Rayleigh processes in the crystal occurred to the photon
-    G4String m_comptonVolumeName;   //!< name of the volume of the last (if any) compton scattering
-    G4String m_RayleighVolumeName;   //!< name of the volume of the last (if any) Rayleigh scattering
+    const G4String* m_comptonVolumeName;   //!< name of the volume of the last (if any) compton scattering
+    const G4String* m_RayleighVolumeName;   //!< name of the volume of the last (if any) Rayleigh scattering
     GateVolumeID m_volumeID;        //!< Volume ID in the world volume tree
     G4ThreeVector m_scannerPos; 	  //!< Position of the scanner
     G4double m_scannerRotAngle; 	  //!< Rotation angle of the scanner
@@ -221,10 +232,10 @@ private:
 
     // AE : Added for IdealComptonPhot adder which take into account several Comptons in the same volume
     //These variables no sense for a general pulse but I need them to  process idealy the hits. or create another structure
-    G4String m_Postprocess;         // PostStep process
+    const G4String* m_Postprocess;         // PostStep process
     G4double m_energyIniTrack;         // Initial energy of the track
     G4double m_energyFin;         // final energy of the particle
-    G4String m_processCreator;
+    const G4String* m_processCreator;
     G4int m_trackID;
     G4int m_parentID;
 
@@ -291,4 +302,17 @@ typedef GatePulseList::iterator GatePulseIterator;
 typedef GatePulseList::const_iterator GatePulseConstIterator;
 
 
+extern G4ThreadLocal G4Allocator<GatePulse>* GatePulseAllocator;
+
+inline void* GatePulse::operator new(size_t)
+{
+  if (!GatePulseAllocator) GatePulseAllocator = new G4Allocator<GatePulse>;
+  return (void*) GatePulseAllocator->MallocSingle();
+}
+
+inline void GatePulse::operator delete(void* aPulse)
+{
+  GatePulseAllocator->FreeSingle((GatePulse*) aPulse);
+}
+
 #endif
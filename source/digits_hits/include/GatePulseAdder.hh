@@ -13,6 +13,7 @@ See LICENSE.md for further details
 #include "globals.hh"
 #include <iostream>
 #include <vector>
+#include <unordered_map>
 #include "G4ThreeVector.hh"
 
 #include "GateVPulseProcessor.hh"
@@ -48,6 +49,10 @@ class GatePulseAdder : public GateVPulseProcessor
     //! print-out the attributes specific of the pulse adder
     virtual void DescribeMyself(size_t indent);
      void SetPositionPolicy(const G4String& policy);
+
+    //! Overload of GateVPulseProcessor::ProcessPulseList(), resets the
+    //! volume index of the output pulses before processing the list
+    virtual GatePulseList* ProcessPulseList(const GatePulseList* inputPulseList);
   protected:
     //! Implementation of the pure virtual method declared by the base class GateVPulseProcessor
     //! This methods processes one input-pulse
@@ -56,6 +61,10 @@ class GatePulseAdder : public GateVPulseProcessor
     void ProcessOnePulse(const GatePulse* inputPulse,GatePulseList& outputPulseList);
     position_policy_t   m_positionPolicy;
 
+    //! Output pulses of the current list, indexed by the hash of their volumeID
+    typedef std::unordered_multimap<size_t,GatePulse*> OutputPulseMap;
+    OutputPulseMap      m_outputPulses;
+
   private:
     GatePulseAdderMessenger *m_messenger;     //!< Messenger
 };
@@ -13,9 +13,11 @@ See LICENSE.md for further details
 #include "globals.hh"
 #include <iostream>
 #include <vector>
+#include <unordered_map>
 #include "G4ThreeVector.hh"
 
 #include "GateVPulseProcessor.hh"
+#include "GateOutputVolumeID.hh"
 #include "GateVSystem.hh"
 #include "GateArrayComponent.hh"
 
@@ -23,7 +25,6 @@ See LICENSE.md for further details
 #define READOUT_POLICY_CENTROID 1
 
 class GateReadoutMessenger;
-class GateOutputVolumeID;
 
 /*! \class  GateReadout
     \brief  Pulse-processor modelling a simple PMT readout (maximum energy wins) of a crystal-block
@@ -87,6 +88,9 @@ class GateReadout : public GateVPulseProcessor
     G4int m_crystalDepth;
     GateArrayComponent* m_crystalComponent;
 
+    //! Index of the output pulse of each block (output volume ID down to m_depth), reused between lists
+    std::unordered_map<GateOutputVolumeID,G4int,GateOutputVolumeIDHash> m_outputPulseIndex;
+
     GateReadoutMessenger *m_messenger;	  //!< Messenger for this readout
 };
 
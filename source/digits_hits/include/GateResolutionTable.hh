@@ -0,0 +1,87 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+
+/*!
+  \class  GateResolutionTable
+  \brief  Energy resolution (FWHM, fraction of the energy) as a function of
+  the energy for each crystal, used by GateBlurring instead of its law
+
+  The table is either read from a file or tabulated from a blurring law
+  (a single row then used for all the crystals). The resolution is linearly
+  interpolated between the points of the energy grid; the bin is computed
+  directly when the grid is regular, otherwise found with a binary search.
+  Out of the grid, the resolution of the first or last point is used.
+
+  File format (lines starting with '#' are ignored):
+  - number of energies, number of crystals
+  - the energies of the grid in keV, ordered by increasing energy
+  - one line per crystal (in the crystal index order) with the resolution
+    at each energy of the grid
+*/
+
+#ifndef GATERESOLUTIONTABLE_HH
+#define GATERESOLUTIONTABLE_HH
+
+#include "globals.hh"
+#include <vector>
+#include <algorithm>
+
+class GateVBlurringLaw;
+
+class GateResolutionTable
+{
+public:
+  GateResolutionTable();
+
+  void Read(const G4String& filename);
+  // Single row computed with the law at nbEnergies regularly spaced energies
+  void Tabulate(const GateVBlurringLaw* law, G4double eMin, G4double eMax, size_t nbEnergies);
+
+  size_t GetNumberOfEnergies() const { return m_energies.size(); }
+  size_t GetNumberOfCrystals() const { return m_nbCrystals; }
+  const G4String& GetSource() const { return m_source; }
+
+  // Resolution of this crystal at this energy. The crystal index is ignored
+  // when the table has a single row.
+  inline G4double GetResolution(size_t crystal, G4double energy) const;
+
+  void Describe(size_t indent=0) const;
+
+protected:
+  void ComputeBins();
+
+  G4String m_source;                 //!< File name or law name
+  std::vector<G4double> m_energies;
+  std::vector<G4double> m_invWidths; //!< 1/width of each bin of the grid
+  std::vector<G4double> m_resolutions; //!< Rows of the crystals, one after the other
+  size_t m_nbCrystals;
+  G4double m_invStep;                //!< 1/width of the bins for a regular grid, 0 otherwise
+};
+
+//-----------------------------------------------------------------------------
+inline G4double GateResolutionTable::GetResolution(size_t crystal, G4double energy) const
+{
+  const size_t n = m_energies.size();
+  const G4double* row = &m_resolutions[(m_nbCrystals==1 ? 0 : crystal)*n];
+  if (energy <= m_energies[0]) return row[0];
+  if (energy >= m_energies[n-1]) return row[n-1];
+
+  // bin i is [m_energies[i], m_energies[i+1])
+  size_t i;
+  if (m_invStep > 0) {
+    i = (size_t)((energy-m_energies[0])*m_invStep);
+    if (i > n-2) i = n-2;
+  }
+  else
+    i = std::upper_bound(m_energies.begin(), m_energies.end(), energy) - m_energies.begin() - 1;
+  return row[i] + (row[i+1]-row[i])*(energy-m_energies[i])*m_invWidths[i];
+}
+//-----------------------------------------------------------------------------
+
+#endif /* end #define GATERESOLUTIONTABLE_HH */
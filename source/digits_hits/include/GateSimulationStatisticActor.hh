@@ -49,6 +49,7 @@ class GateSimulationStatisticActor : public GateVActor
   /// Saves the data collected to the file
   virtual void SaveData();
   virtual void ResetData();
+  virtual void MergeDataFrom(GateVActor * workerActor);
 
 protected:
   GateSimulationStatisticActor(G4String name, G4int depth=0);
@@ -0,0 +1,77 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+
+/*!
+  \class  GateStoppingPowerRatioTable
+  \brief  Tabulated ratio of total stopping powers S_target(E)/S_material(E)
+
+  One table per (particle definition, material index), sampled on a
+  regular log-energy grid. Used to convert dose into dose-to-water (or
+  dose to another material) with a single interpolation per step instead
+  of two G4EmCalculator::ComputeTotalDEDX calls. Tables are built at
+  begin of run for the most common particles; other particles (ions...)
+  get their table the first time they are seen. Outside the grid, or
+  when the table is disabled (0 bins), the exact ratio is returned.
+*/
+
+#ifndef GATESTOPPINGPOWERRATIOTABLE_HH
+#define GATESTOPPINGPOWERRATIOTABLE_HH
+
+#include "G4String.hh"
+#include <vector>
+
+class G4EmCalculator;
+class G4Material;
+class G4ParticleDefinition;
+
+class GateStoppingPowerRatioTable
+{
+public:
+  GateStoppingPowerRatioTable();
+  ~GateStoppingPowerRatioTable() {}
+
+  void SetTargetMaterial(const G4Material * m) { mTargetMaterial = m; }
+  const G4Material * GetTargetMaterial() const { return mTargetMaterial; }
+
+  // Log grid between emin and emax. 0 bins means no table (exact computation)
+  void SetEnergyRange(double emin, double emax, int nbins);
+  int GetNumberOfBins() const { return mNumberOfBins; }
+
+  // When > 0, each table is compared to the exact value at the middle of
+  // each bin and a warning is issued if the relative error is larger
+  void SetTolerance(double t) { mTolerance = t; }
+
+  // Remove all tables (must be called when the physics may have changed)
+  void Initialize(G4EmCalculator * calc);
+  bool IsInitialized() const { return mEmCalculator != 0; }
+
+  // Build the tables of the given particle for all the current materials
+  void BuildTables(const G4ParticleDefinition * p);
+
+  double GetRatio(const G4ParticleDefinition * p, const G4Material * m, double energy);
+  double ComputeExactRatio(const G4ParticleDefinition * p, const G4Material * m, double energy);
+
+protected:
+  const std::vector<double> & GetTable(const G4ParticleDefinition * p, const G4Material * m);
+  void BuildTable(const G4ParticleDefinition * p, const G4Material * m, std::vector<double> & table);
+
+  G4EmCalculator * mEmCalculator;
+  const G4Material * mTargetMaterial;
+  double mMinEnergy;
+  double mMaxEnergy;
+  double mLogMinEnergy;
+  double mInvLogBinWidth;
+  int mNumberOfBins;
+  double mTolerance;
+
+  // mTables[particle definition ID][material index]
+  std::vector<std::vector<std::vector<double> > > mTables;
+};
+
+#endif /* end #define GATESTOPPINGPOWERRATIOTABLE_HH */
@@ -25,6 +25,7 @@
 #include "GateMaterialMuHandler.hh"
 #include "G4UnitsTable.hh"
 #include "GateVoxelizedMass.hh"
+#include "GateDoseStepFilter.hh"
 
 class GateTLEDoseActor : public GateVImageActor
 {
@@ -58,7 +59,9 @@ public:
 
   //virtual void PostUserTrackingAction(const GateVVolume *, const G4Track* t);
   virtual void UserSteppingAction(const GateVVolume *, const G4Step*);
-  virtual void UserSteppingActionInVoxel(const int index, const G4Step* step);
+  virtual void UserSteppingActionInVoxel(const int index, const G4Step* step) {
+    (this->*pUserSteppingActionInVoxel)(index, step);
+  }
   virtual void UserPreTrackActionInVoxel(const int /*index*/, const G4Track* /*t*/) {}
   virtual void UserPostTrackActionInVoxel(const int /*index*/, const G4Track* /*t*/) {}
 
@@ -76,6 +79,11 @@ protected:
   GateTLEDoseActor(G4String name, G4int depth=0);
   GateTLEDoseActorMessenger * pMessenger;
 
+  // Specialised at Construct as in GateDoseActor
+  template<bool UseVoxelizedMass>
+  void UserSteppingActionInVoxelT(const int index, const G4Step* step);
+  void (GateTLEDoseActor::*pUserSteppingActionInVoxel)(const int index, const G4Step* step);
+
   GateVoxelizedMass mVoxelizedMass;
 
   GateImageWithStatistic mDoseImage;
@@ -92,6 +100,7 @@ protected:
   G4String mImportMassImage;
   G4String mVolumeFilter;
   G4String mMaterialFilter;
+  GateDoseStepFilter mStepFilter;
 
   G4double ConversionFactor;
   G4double VoxelVolume;
@@ -14,6 +14,7 @@
 #include <fstream>
 
 #include "GateVOutputModule.hh"
+#include "GateAsyncOfstream.hh"
 
 #ifdef G4ANALYSIS_USE_FILE
 
@@ -82,7 +83,7 @@ public:
       G4int             m_fileCounter;
       long              m_outputFileBegin;
       G4int	        m_collectionID;
-      std::ofstream   m_outputFile;
+      GateAsyncOfstream m_outputFile;
 
       static long       m_outputFileSizeLimit;
   };
@@ -148,8 +149,8 @@ private:
 
   GateToASCIIMessenger* m_asciiMessenger;
 
-  std::ofstream m_outFileRun;
-  std::ofstream m_outFileHits;
+  GateAsyncOfstream m_outFileRun;
+  GateAsyncOfstream m_outFileHits;
 
   G4String m_fileName;
 
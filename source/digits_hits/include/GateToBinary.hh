@@ -25,6 +25,7 @@
 #include <cstdlib>
 
 #include "GateVOutputModule.hh"
+#include "GateAsyncOfstream.hh"
 #include "GateCoincidenceDigi.hh"
 #include "GateSingleDigi.hh"
 #include "GatePrimaryGeneratorAction.hh"
@@ -310,7 +311,7 @@ public:
     G4String m_collectionName; /*!< Name of the collection */
     G4int m_fileCounter; /*!< Count of the file */
     G4int	m_collectionID; /*!< Collection ID */
-    std::ofstream m_outputFile; /*!< Output file */
+    GateAsyncOfstream m_outputFile; /*!< Output file */
     static G4int m_outputFileSizeLimit; /*!< Output file size limit */
   } VOutputChannel;
 
@@ -396,8 +397,8 @@ protected:
   G4int m_recordFlag; /*!< Record Flag */
   std::vector< VOutputChannel* > m_outputChannelVector; /*!< Vector of output channel */
 
-  std::ofstream m_outFileRun; /*!< outfile for run */
-  std::ofstream m_outFileHits; /*!< outfile for hits */
+  GateAsyncOfstream m_outFileRun; /*!< outfile for run */
+  GateAsyncOfstream m_outFileHits; /*!< outfile for hits */
 
 private:
   static G4String FixedWidthZeroPaddedString(const G4String & full, size_t length);
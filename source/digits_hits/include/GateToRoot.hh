@@ -46,6 +46,7 @@ See LICENSE.md for further details
 #include "G4Event.hh"
 
 #include "GateRootDefs.hh"
+#include "GateRootTreeFile.hh"
 #include "GateVOutputModule.hh"
 
 /* PY Descourt 08/09/2009 */
@@ -141,6 +142,7 @@ public:
     virtual void Clear() = 0;
     virtual void RecordDigitizer() = 0 ;
     virtual void Book() = 0;
+    virtual TTree* GetTree() = 0;
 
     inline void SetOutputFlag(G4bool flag) { m_outputFlag = flag; };
     inline void SetVerboseLevel(G4int val) { nVerboseLevel = val; };
@@ -172,6 +174,7 @@ public:
 	m_tree->Init(m_buffer);
       }
     }
+    inline TTree* GetTree() { return m_tree; }
 
     void RecordDigitizer();
 
@@ -201,6 +204,7 @@ public:
 	m_tree->Init(m_buffer);
       }
     }
+    inline TTree* GetTree() { return m_tree; }
 
     void RecordDigitizer();
 
@@ -224,6 +228,11 @@ public:
   G4bool GetRootOpticalFlag()                   { return m_rootOpticalFlag; };
   void   SetRootOpticalFlag(G4bool flag)        { m_rootOpticalFlag = flag; };
 
+  //! Compression of the ROOT file, basket size and auto-flush of its trees
+  GateRootStorageSettings& GetStorageSettings() { return m_storageSettings; };
+  //! Hit branches that are not booked
+  void   DisableHitBranch(const G4String& name) { m_disabledHitBranches.insert(name); };
+
 
   //! Get the output file name
   const  G4String& GetFileName()             { return m_fileName; };
@@ -308,6 +317,9 @@ private:
   G4bool   m_saveRndmFlag;
   G4bool   m_rootOpticalFlag;
 
+  GateRootStorageSettings m_storageSettings;
+  std::set<G4String>      m_disabledHitBranches;
+
   G4String m_fileName;
 
   GateToRootMessenger* m_rootMessenger;
@@ -59,6 +59,12 @@ class GateToRootMessenger: public GateOutputModuleMessenger
     G4UIcmdWithABool*        SaveRndmCmd;
     G4UIcmdWithAString*      SetFileNameCmd;
 
+    G4UIcommand*             CompressionCmd;
+    G4UIcmdWithAnInteger*    BasketSizeCmd;
+    G4UIcmdWithAnInteger*    AutoFlushCmd;
+    G4UIcmdWithAnInteger*    AutoSaveCmd;
+    G4UIcmdWithAString*      DisableHitBranchCmd;
+
     G4UIcommand*      CoincidenceMaskCmd;
 	G4int m_coincidenceMaskLength;
 
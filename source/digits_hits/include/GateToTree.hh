@@ -70,6 +70,9 @@ public:
   G4bool getOpticalDataEnabled() const;
   void setOpticalDataEnabled(G4bool mOpticalDataEnabled);
 
+  // .npy outputs written as one file per variable
+  void setNumpyOneFilePerColumn(G4bool b);
+
   std::unordered_map<std::string, SaveDataParam> &getHitsParamsToWrite();
   std::unordered_map<std::string, SaveDataParam> &getOpticalParamsToWrite();
   std::unordered_map<std::string, SaveDataParam> &getSinglesParamsToWrite();
@@ -105,6 +108,7 @@ private:
   }
 
   void RecordOpticalData(const G4Event * event);
+  std::string getFileKind(const std::string &extension) const; //kind of the output file for this extension
 
 
 
@@ -125,6 +129,7 @@ private:
   G4String m_uselessFileName; //only for GiveNameOfFile which return a reference..
 
   G4bool m_opticalData_enabled;
+  G4bool m_npy_one_file_per_column;
 
  private:
 
@@ -20,6 +20,7 @@ See LICENSE.md for further details
 class GateToTree;
 class G4UIcmdWithAString;
 class G4UIcmdWithABool;
+class G4UIcmdWithAnInteger;
 class G4UIcmdWithoutParameter;
 
 
@@ -42,6 +43,10 @@ private:
   G4UIcmdWithoutParameter *m_disableOpticalDataOutput;
 
   G4UIcmdWithAString* m_addCollectionCmd;
+  G4UIcmdWithABool* m_npyOneFilePerColumnCmd;
+  G4UIcommand* m_rootCompressionCmd;
+  G4UIcmdWithAnInteger* m_rootBasketSizeCmd;
+  G4UIcmdWithAnInteger* m_rootAutoFlushCmd;
   GateToTree *m_gateToTree;
 
   std::unordered_map<G4UIcmdWithoutParameter*, G4String> m_maphits_cmdParameter_toTreeParameter;
@@ -39,12 +39,16 @@ See LICENSE.md for further details
 
 class GateRunAction;
 class GateEventAction;
+class GateTrackingAction;
+class GateSteppingAction;
 class G4SliceTimer;
 
 class GateUserActions
 {
 public:
   GateUserActions(GateRunManager* m);
+  /// Multithreaded mode: the actions are registered by GateActionInitialization
+  GateUserActions();
   ~GateUserActions();
 
   //-----------------------------------------------------------------------------
@@ -92,7 +96,13 @@ public:
   void EnableTimeStudy(G4String filename);
   void EnableTimeStudyForSteps(G4String filename);
 
+  GateRunAction* GetRunAction() { return runAction; }
+  GateEventAction* GetEventAction() { return eventAction; }
+  GateTrackingAction* GetTrackingAction() { return trackingAction; }
+  GateSteppingAction* GetSteppingAction() { return steppingAction; }
+
 protected:
+  void Initialize();
 
   //-----------------------------------------------------------------------------
   /// Pointer on the GateRunmanager
@@ -119,11 +129,13 @@ protected:
   long int mStepNumberInCurrentTrack;
   //-----------------------------------------------------------------------------
 
-  static GateUserActions* pUserActions;
+  static G4ThreadLocal GateUserActions* pUserActions;
 
 
   GateRunAction* runAction;
   GateEventAction* eventAction;
+  GateTrackingAction* trackingAction;
+  GateSteppingAction* steppingAction;
 
   G4bool mIsTimeStudyActivated;
   G4SliceTimer* mTimer;
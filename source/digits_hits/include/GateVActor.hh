@@ -109,6 +109,19 @@ public:
   void EnableSaveEveryNSeconds(int n) { mSaveEveryNSeconds = n; }
   void SetOverWriteFilesFlag(bool b) { mOverWriteFilesFlag = b; }
   void EnableResetDataAtEachRun(bool b) { mResetDataAtEachRun = b; }
+
+  // Save if the event number ne (or the time since the last save)
+  // reaches the value given by EnableSaveEveryNEvents/NSeconds
+  void SaveDataIfNeeded(int ne);
+  //-----------------------------------------------------------------------------
+
+  //-----------------------------------------------------------------------------
+  // Multithreaded mode: accumulate into this (master) actor the data of
+  // the same actor owned by a worker thread, and leave the worker data
+  // empty. Called periodically (save every n events/seconds) and at the
+  // end of each run, always between two events of the worker, so the
+  // pending per-event values can be flushed. Not supported by default.
+  virtual void MergeDataFrom(GateVActor * workerActor);
   //-----------------------------------------------------------------------------
 
   G4String GetVolumeName(){return mVolumeName;}
@@ -116,6 +129,11 @@ public:
   void SetVolumeName(G4String name){mVolumeName = name;}
 
   GateFilterManager * GetFilterManager(){return pFilterManager;}
+  // Filter to check before each step/track callback (0 if the actor has no filter)
+  GateFilterManager * GetFilterManagerIfAny(){return (mNumOfFilters!=0 ? pFilterManager : 0);}
+  // Step in the attached volume, called by GateMultiSensitiveDetector
+  // once the filters have been checked
+  G4bool ProcessStep(G4Step * step) { return ProcessHits(step, 0); }
   G4int GetNumberOfFilters() {return mNumOfFilters;}
   void IncNumberOfFilters() {mNumOfFilters++;}
 
@@ -149,6 +167,7 @@ protected:
   G4String mSaveFilename;
   int mSaveFileDescriptor;
   struct timeval mTimeOfLastSaveEvent;
+  int mNumberOfEventsSinceLastMerge; // worker threads only
   //-----------------------------------------------------------------------------
 
 };
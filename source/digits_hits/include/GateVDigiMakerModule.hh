@@ -41,7 +41,7 @@ public:
   virtual void DescribeMyself(size_t indent);
 
   virtual void SetInputName(const G4String& inputName)
-    { m_inputName = inputName; }
+    { m_inputName = inputName; m_inputSlot = -1; }
   virtual const G4String& GetInputName()
     { return m_inputName; }
   virtual const G4String& GetCollectionName()
@@ -50,6 +50,7 @@ public:
  protected:
   GateDigitizer*	 m_digitizer;
   G4String		 m_inputName;
+  G4int			 m_inputSlot;	//!< Digitizer slot of the input, bound on the first event
   G4String		 m_collectionName;
 };
 
@@ -22,6 +22,8 @@ See LICENSE.md for further details
 #include "GateImageWithStatistic.hh"
 #include "Randomize.hh"
 
+class G4VTouchable;
+
 //-----------------------------------------------------------------------------
 /// \brief Base (virtual) class for sensor storing data in a 3D matrix
 /// (GateImage)
@@ -29,7 +31,7 @@ class GateVImageActor: public GateVActor
 {
 public :
   //-----------------------------------------------------------------------------
-  enum StepHitType {PreStepHitType, PostStepHitType, MiddleStepHitType, RandomStepHitType, RandomStepHitTypeCylindricalCS, PostStepHitTypeCylindricalCS};
+  enum StepHitType {PreStepHitType, PostStepHitType, MiddleStepHitType, RandomStepHitType, RandomStepHitTypeCylindricalCS, PostStepHitTypeCylindricalCS, RayCastStepHitType};
 
   //-----------------------------------------------------------------------------
   /// Constructs the class
@@ -59,6 +61,9 @@ public :
   //void SetPosition(GateVVolume * v);
   /// Sets the type of the hit
   void SetStepHitType(G4String t);
+  /// True if the actor scales its step quantities by mStepHitFraction,
+  /// required by the 'raycast' hit type
+  virtual bool IsRayCastStepHitTypeSupported() const { return false; }
   //-----------------------------------------------------------------------------
 
   double GetDoselVolume(){return mVoxelSize.x()*mVoxelSize.y()*mVoxelSize.z();}
@@ -83,12 +88,38 @@ public :
 
   virtual void ResetData();
 
+  //-----------------------------------------------------------------------------
+  /// Level (counted from the world) of the touchable history where the
+  /// logical volume of the actor was last found. The depth of the
+  /// actor's volume is usually the same for all the steps, so it is
+  /// checked first before walking the whole history.
+  struct TouchableDepthCache {
+    TouchableDepthCache():target(0), volume(0), level(-1) {}
+    const G4LogicalVolume * target;
+    const G4LogicalVolume * volume;
+    int level;
+  };
+  static int FindVolumeDepth(const G4VTouchable * touchable,
+                             const G4LogicalVolume * target,
+                             TouchableDepthCache * cache = 0);
+
+  /// Pre and post step positions in the frame of the actor's image.
+  /// Returns false if the step is not inside the volume v.
+  static bool GetStepPositionsInImageFrame(const GateVVolume * v,
+                                           const G4Step * step,
+                                           const bool mPositionIsSet,
+                                           const G4ThreeVector & mPosition,
+                                           G4ThreeVector & prePosition,
+                                           G4ThreeVector & postPosition,
+                                           TouchableDepthCache * cache = 0);
+
   static int GetIndexFromStepPosition2(const GateVVolume *,
                                        const G4Step  * step,
                                        const GateImage & image,
                                        const bool mPositionIsSet,
                                        const G4ThreeVector mPosition,
-                                       const StepHitType mStepHitType);
+                                       const StepHitType mStepHitType,
+                                       TouchableDepthCache * cache = 0);
 
 protected:
 
@@ -113,6 +144,21 @@ protected:
   int GetIndexFromTrackPosition(const GateVVolume *, const G4Track * track);
   int GetIndexFromStepPosition(const GateVVolume *, const G4Step  * step);
 
+  // 'raycast' hit type: the straight segment between the pre and post
+  // step points is traced through the grid (Amanatides-Woo), and
+  // UserSteppingActionInVoxel is called for each crossed voxel with
+  // mStepHitFraction set to the fraction of the step length in it.
+  void RayCastStepInVoxels(const G4Step * step);
+  double mStepHitFraction;
+
+  // When the actor grid is the voxel grid of the attached image volume,
+  // the index is given by the copy numbers of the touchable
+  enum VoxelCopyNumberType {NoVoxelCopyNumber, RegularVoxelCopyNumber, NestedVoxelCopyNumber};
+  void InitializeVoxelCopyNumber();
+  VoxelCopyNumberType mVoxelCopyNumberType;
+  const G4LogicalVolume * mVoxelLogicalVolume;
+  TouchableDepthCache mTouchableDepthCache;
+
 }; // end class GateVImageActor
 
 //-----------------------------------------------------------------------------
@@ -10,6 +10,7 @@
 #define GATEACTION_CC
 
 #include "G4Run.hh"
+#include "G4Threading.hh"
 #include "G4UImanager.hh"
 #include "G4VVisManager.hh"
 #include "G4Polyline.hh"
@@ -51,8 +52,20 @@
 #include "GateSteppingActionMessenger.hh"
 #include "GateCrystalSD.hh"
 
-GateRunAction* GateRunAction::prunAction=0;
-GateEventAction* GateEventAction::peventAction=0;
+G4ThreadLocal GateRunAction* GateRunAction::prunAction=0;
+G4ThreadLocal GateEventAction* GateEventAction::peventAction=0;
+
+#ifdef G4ANALYSIS_USE_GENERAL
+//-----------------------------------------------------------------------------
+// The output modules are not thread-aware: they are fed by the master thread
+// only, and GateApplicationMgr::StartDAQ stops with an error when one of them
+// is enabled in multithreaded mode, so that the worker events are not lost.
+static G4bool IsOutputRecorded()
+{
+  return GateApplicationMgr::GetInstance()->GetOutputMode() && !G4Threading::IsWorkerThread();
+}
+//-----------------------------------------------------------------------------
+#endif
 
 //-----------------------------------------------------------------------------
 GateRunAction::GateRunAction(GateUserActions * cbm)
@@ -75,7 +88,7 @@ void GateRunAction::BeginOfRunAction(const G4Run* aRun)
 
 #ifdef G4ANALYSIS_USE_GENERAL
   // Here we fill the histograms of the Analysis manager
-  if(GateApplicationMgr::GetInstance()->GetOutputMode()){
+  if(IsOutputRecorded()){
     GateOutputMgr* outputMgr = GateOutputMgr::GetInstance();
     outputMgr->RecordBeginOfRun(aRun);
   }
@@ -95,7 +108,7 @@ inline void GateRunAction::EndOfRunAction(const G4Run* aRun)
 
 #ifdef G4ANALYSIS_USE_GENERAL
   // Here we fill the histograms of the Analysis manager
-  if(GateApplicationMgr::GetInstance()->GetOutputMode()){
+  if(IsOutputRecorded()){
     GateOutputMgr* outputMgr = GateOutputMgr::GetInstance();
     outputMgr->RecordEndOfRun(aRun);
   }
@@ -126,7 +139,7 @@ inline void GateEventAction::BeginOfEventAction(const G4Event* anEvent)
 
 #ifdef G4ANALYSIS_USE_GENERAL
       // Here we fill the histograms of the OutputMgr manager
-      if(GateApplicationMgr::GetInstance()->GetOutputMode()){
+      if(IsOutputRecorded()){
         GateOutputMgr* outputMgr = GateOutputMgr::GetInstance();
         outputMgr->RecordBeginOfEvent(anEvent);
       }
@@ -148,7 +161,7 @@ inline void GateEventAction::EndOfEventAction(const G4Event* anEvent)
 #ifdef G4ANALYSIS_USE_GENERAL
   // Here we fill the histograms of the OutputMgr manager
   // Pre-digitalisation outputMgr (hits)
-  if(GateApplicationMgr::GetInstance()->GetOutputMode()){
+  if(IsOutputRecorded()){
     GateOutputMgr* outputMgr = GateOutputMgr::GetInstance();
     outputMgr->RecordEndOfEvent(anEvent);
   }
@@ -1007,7 +1020,7 @@ void GateSteppingAction::UserSteppingAction(const GateVVolume *v, const G4Step*
 
 #ifdef G4ANALYSIS_USE_GENERAL
   // Here we fill the histograms of the Analysis manager
-  if(GateApplicationMgr::GetInstance()->GetOutputMode()){
+  if(IsOutputRecorded()){
     GateOutputMgr* outputMgr = GateOutputMgr::GetInstance();
     outputMgr->RecordStepWithVolume(v, theStep);
   }
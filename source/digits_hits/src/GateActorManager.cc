@@ -14,6 +14,17 @@
 #include "GateVActor.hh"
 #include "GateMultiSensitiveDetector.hh"
 
+#ifdef GATE_USE_MT
+#include "G4AutoLock.hh"
+#include <algorithm>
+
+namespace {
+  G4Mutex theWorkerActorManagersMutex = G4MUTEX_INITIALIZER;
+  // Protects the master actors (merges and saves)
+  G4Mutex theMasterActorsMutex = G4MUTEX_INITIALIZER;
+}
+#endif
+
 //-----------------------------------------------------------------------------
 GateActorManager::GateActorManager()
 {
@@ -22,6 +33,18 @@ GateActorManager::GateActorManager()
   pActorManagerMessenger = new GateActorManagerMessenger(this);
   IsInitialized =0;
   resetAfterSaving = false;
+
+#ifdef GATE_USE_MT
+  mThreadId = G4Threading::G4GetThreadId();
+  if (G4Threading::IsWorkerThread()) {
+    // The prototypes are registered by static creators in the master
+    theListOfActorPrototypes = theMasterActorManager->theListOfActorPrototypes;
+    theListOfFilterPrototypes = theMasterActorManager->theListOfFilterPrototypes;
+    G4AutoLock l(&theWorkerActorManagersMutex);
+    theListOfWorkerActorManagers.push_back(this);
+  }
+  else theMasterActorManager = this;
+#endif
   GateDebugMessageDec("Actor",4,"GateActormanager() -- end\n");
 }
 //-----------------------------------------------------------------------------
@@ -38,6 +61,7 @@ GateActorManager::~GateActorManager()
   theListOfActorsEnabledForPreUserTrackingAction.clear();
   theListOfActorsEnabledForPostUserTrackingAction.clear();
   theListOfActorsEnabledForUserSteppingAction.clear();
+  theListOfFiltersForUserSteppingAction.clear();
   delete pActorManagerMessenger;
 
   GateDebugMessageDec("Actor",4,"~GateActormanager() -- end\n");
@@ -92,6 +116,8 @@ void GateActorManager::CreateListsOfEnabledActors()
     //GateMessage("Core", 0, "Actor = " << (*sit)->GetObjectName() << Gateendl);
 
     (*sit)->Construct();
+    // names given to the filters are resolved once the geometry is built
+    if ((*sit)->GetNumberOfFilters()!=0) (*sit)->GetFilterManager()->Initialize();
     if ((*sit)->IsBeginOfRunActionEnabled()       && IsInitialized<2) theListOfActorsEnabledForBeginOfRun.push_back( (*sit) );
     if ((*sit)->IsEndOfRunActionEnabled()         && IsInitialized<2) theListOfActorsEnabledForEndOfRun.push_back( (*sit) );
     if ((*sit)->IsBeginOfEventActionEnabled()     && IsInitialized<2) theListOfActorsEnabledForBeginOfEvent.push_back( (*sit) );
@@ -103,7 +129,10 @@ void GateActorManager::CreateListsOfEnabledActors()
 
     if ((*sit)->IsUserSteppingActionEnabled()) {
       if ( (*sit)->GetVolumeName()=="" ) {
-        if (IsInitialized<2) theListOfActorsEnabledForUserSteppingAction.push_back( (*sit) );
+        if (IsInitialized<2) {
+          theListOfActorsEnabledForUserSteppingAction.push_back( (*sit) );
+          theListOfFiltersForUserSteppingAction.push_back( (*sit)->GetFilterManagerIfAny() );
+        }
       }
       else {
         SetMultiFunctionalDetector((*sit),(*sit)->GetVolume());
@@ -149,6 +178,12 @@ void GateActorManager::BeginOfRunAction(const G4Run* run)
 {
   std::vector<GateVActor*>::iterator sit;
 
+#ifdef GATE_USE_MT
+  // Worker actors are created by the macro commands replayed at the
+  // beginning of the first run of the thread, construct them now
+  if (G4Threading::IsWorkerThread() && IsInitialized==0) CreateListsOfEnabledActors();
+#endif
+
   //GateMessage("Core", 0, "Run " << run->GetRunID() << " is starting.\n");
   for (sit = theListOfActorsEnabledForBeginOfRun.begin(); sit!=theListOfActorsEnabledForBeginOfRun.end(); ++sit)
     (*sit)->BeginOfRunAction(run);
@@ -160,6 +195,12 @@ void GateActorManager::BeginOfRunAction(const G4Run* run)
 void GateActorManager::EndOfRunAction(const G4Run* run)
 {
   std::vector<GateVActor*>::iterator sit;
+
+#ifdef GATE_USE_MT
+  // Only the master saves, once the data of all workers have been merged
+  if (G4Threading::IsWorkerThread()) return;
+  MergeWorkerActors();
+#endif
   for (sit = theListOfActorsEnabledForEndOfRun.begin(); sit!=theListOfActorsEnabledForEndOfRun.end(); ++sit)
     (*sit)->EndOfRunAction(run);
   //GateMessage("Core", 0, "Run " << run->GetRunID() << " is ending.\n");
@@ -216,15 +257,14 @@ void GateActorManager::PostUserTrackingAction(const G4Track* track)
 //-----------------------------------------------------------------------------
 void GateActorManager::UserSteppingAction(const G4Step* step)
 {
-  std::vector<GateVActor*>::iterator sit;
-  // GateDebugMessage("Actor", 1, "list = " << theListOfActorsEnabledForUserSteppingAction.size() << Gateendl);
-  for (sit = theListOfActorsEnabledForUserSteppingAction.begin(); sit!=theListOfActorsEnabledForUserSteppingAction.end(); ++sit)
+  // Only the actors without volume are here, the others are called by the
+  // GateMultiSensitiveDetector of their volume
+  const size_t n = theListOfActorsEnabledForUserSteppingAction.size();
+  for (size_t i=0; i<n; i++)
     {
-      // GateDebugMessage("Actor", 1, "Step for " << (*sit)->GetObjectName());
-      if ((*sit)->GetNumberOfFilters()!=0){
-        if (!(*sit)->GetFilterManager()->Accept(step) ) continue;
-      }
-      (*sit)->UserSteppingAction(0, step);
+      GateFilterManager * filter = theListOfFiltersForUserSteppingAction[i];
+      if (filter && !filter->Accept(step)) continue;
+      theListOfActorsEnabledForUserSteppingAction[i]->UserSteppingAction(0, step);
     }
 }
 //-----------------------------------------------------------------------------
@@ -327,6 +367,44 @@ G4bool GateActorManager::AddFilter(G4String filterType, G4String actorName )
 }
 //-----------------------------------------------------------------------------
 
-GateActorManager *GateActorManager::singleton_ActorManager = 0;
+#ifdef GATE_USE_MT
+//-----------------------------------------------------------------------------
+void GateActorManager::MergeWorkerActors()
+{
+  G4AutoLock l(&theMasterActorsMutex);
+  // Merge always in the same (thread) order for reproducible sums
+  std::sort(theListOfWorkerActorManagers.begin(), theListOfWorkerActorManagers.end(),
+            [](const GateActorManager * a, const GateActorManager * b) { return a->mThreadId < b->mThreadId; });
+
+  for (auto worker:theListOfWorkerActorManagers) {
+    if (worker->theListOfActors.size() != theListOfActors.size())
+      GateError("Actor Manager -- MergeWorkerActors: thread " << worker->mThreadId << " has "
+                << worker->theListOfActors.size() << " actors while the master has " << theListOfActors.size());
+    for (unsigned int i = 0; i<theListOfActors.size(); i++)
+      theListOfActors[i]->MergeDataFrom(worker->theListOfActors[i]);
+  }
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+void GateActorManager::MergeWorkerActorIntoMaster(GateVActor * workerActor, int ne)
+{
+  // Actors are created in the same (macro) order in all threads
+  unsigned int i = std::find(theListOfActors.begin(), theListOfActors.end(), workerActor) - theListOfActors.begin();
+  if (i >= theMasterActorManager->theListOfActors.size())
+    GateError("Actor Manager -- MergeWorkerActorIntoMaster: no master actor for " << workerActor->GetObjectName());
+  GateVActor * masterActor = theMasterActorManager->theListOfActors[i];
+
+  G4AutoLock l(&theMasterActorsMutex);
+  masterActor->MergeDataFrom(workerActor);
+  masterActor->SaveDataIfNeeded(ne);
+}
+//-----------------------------------------------------------------------------
+
+GateActorManager *GateActorManager::theMasterActorManager = 0;
+std::vector<GateActorManager*> GateActorManager::theListOfWorkerActorManagers;
+#endif
+
+G4ThreadLocal GateActorManager *GateActorManager::singleton_ActorManager = 0;
 
 #endif /* end #define GATEACTORMANAGER_CC */
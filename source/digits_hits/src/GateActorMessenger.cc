@@ -38,6 +38,7 @@ GateActorMessenger::~GateActorMessenger()
   delete pSaveEveryNEventsCmd;
   delete pSaveEveryNSecondsCmd;
   delete pAddFilterCmd;
+  delete pSetFilterOperatorCmd;
   delete pSetOverWriteFilesFlagCmd;
 }
 //-----------------------------------------------------------------------------
@@ -89,6 +90,13 @@ void GateActorMessenger::BuildCommands(G4String base)
   pAddFilterCmd->SetGuidance(guidance);
   pAddFilterCmd->SetParameterName("Type",false);
 
+  bb = base+"/setFilterOperator";
+  pSetFilterOperatorCmd = new G4UIcmdWithAString(bb,this);
+  guidance = "Combine the filters of this actor with 'and' (all must accept, default) or 'or' (at least one)";
+  pSetFilterOperatorCmd->SetGuidance(guidance);
+  pSetFilterOperatorCmd->SetParameterName("Operator",false);
+  pSetFilterOperatorCmd->SetCandidates("and or");
+
 }
 //-----------------------------------------------------------------------------
 
@@ -117,6 +125,9 @@ void GateActorMessenger::SetNewValue(G4UIcommand* command, G4String param)
 
   if(command == pAddFilterCmd)
     GateActorManager::GetInstance()->AddFilter(param, pActor->GetObjectName() );
+
+  if(command == pSetFilterOperatorCmd)
+    pActor->GetFilterManager()->SetOperator(param == "or" ? GateFilterManager::kOr : GateFilterManager::kAnd);
 }
 //-----------------------------------------------------------------------------
 
@@ -0,0 +1,136 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+#include "GateBlockSparseImage.hh"
+
+#include <algorithm>
+#include <cmath>
+
+const int GateBlockSparseImage::kBlockShift;
+const int GateBlockSparseImage::kBlockSize;
+const int GateBlockSparseImage::kBlockMask;
+const int GateBlockSparseImage::kBlockNumberOfVoxels;
+
+//-----------------------------------------------------------------------------
+GateBlockSparseImage::GateBlockSparseImage()
+{
+  mSizeX = mSizeY = mSizeZ = 0;
+  mNumberOfBlocksX = mNumberOfBlocksY = mNumberOfBlocksZ = 0;
+  mNumberOfChannels = 0;
+  mBlockStride = 0;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateBlockSparseImage::SetLayout(const GateVImage & image, int numberOfChannels)
+{
+  G4ThreeVector resolution = image.GetResolution();
+  mSizeX = (int)lrint(resolution.x());
+  mSizeY = (int)lrint(resolution.y());
+  mSizeZ = (int)lrint(resolution.z());
+  mNumberOfBlocksX = (mSizeX + kBlockMask) >> kBlockShift;
+  mNumberOfBlocksY = (mSizeY + kBlockMask) >> kBlockShift;
+  mNumberOfBlocksZ = (mSizeZ + kBlockMask) >> kBlockShift;
+  mNumberOfChannels = numberOfChannels;
+  mBlockStride = (size_t)kBlockNumberOfVoxels*numberOfChannels;
+
+  mBackgroundValues.assign(numberOfChannels, 0.0);
+  mBlockNumbers.assign((size_t)mNumberOfBlocksX*mNumberOfBlocksY*mNumberOfBlocksZ, -1);
+  mAllocatedBlocks.clear();
+  std::vector<double>().swap(mValues);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateBlockSparseImage::Clear()
+{
+  for(size_t b=0; b<mAllocatedBlocks.size(); b++)
+    mBlockNumbers[mAllocatedBlocks[b]] = -1;
+  mAllocatedBlocks.clear();
+  mValues.clear(); // the memory is kept for the next blocks
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+double * GateBlockSparseImage::AllocateBlock(int blockId)
+{
+  size_t b = mAllocatedBlocks.size();
+  mBlockNumbers[blockId] = b;
+  mAllocatedBlocks.push_back(blockId);
+  mValues.resize(mValues.size() + mBlockStride);
+  double * values = &mValues[b*mBlockStride];
+  for(int v=0; v<kBlockNumberOfVoxels; v++)
+    for(int c=0; c<mNumberOfChannels; c++)
+      values[v*mNumberOfChannels+c] = mBackgroundValues[c];
+  return values;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+double * GateBlockSparseImage::GetBlockValuesFromId(int blockId)
+{
+  int b = mBlockNumbers[blockId];
+  if (b < 0) return AllocateBlock(blockId);
+  return &mValues[b*mBlockStride];
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+int GateBlockSparseImage::GetVoxelIndex(int blockId, int v) const
+{
+  int bx = blockId % mNumberOfBlocksX;
+  int r = blockId / mNumberOfBlocksX;
+  int by = r % mNumberOfBlocksY;
+  int bz = r / mNumberOfBlocksY;
+  int x = (bx << kBlockShift) + (v & kBlockMask);
+  int y = (by << kBlockShift) + ((v >> kBlockShift) & kBlockMask);
+  int z = (bz << kBlockShift) + (v >> (2*kBlockShift));
+  if (x >= mSizeX || y >= mSizeY || z >= mSizeZ) return -1;
+  return x + (y + z*mSizeY)*mSizeX;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+long GateBlockSparseImage::GetNumberOfBackgroundVoxels() const
+{
+  long n = (long)mSizeX*mSizeY*mSizeZ;
+  for(size_t b=0; b<mAllocatedBlocks.size(); b++) {
+    int blockId = mAllocatedBlocks[b];
+    int bx = blockId % mNumberOfBlocksX;
+    int r = blockId / mNumberOfBlocksX;
+    int by = r % mNumberOfBlocksY;
+    int bz = r / mNumberOfBlocksY;
+    long nx = std::min(kBlockSize, mSizeX - (bx << kBlockShift));
+    long ny = std::min(kBlockSize, mSizeY - (by << kBlockShift));
+    long nz = std::min(kBlockSize, mSizeZ - (bz << kBlockShift));
+    n -= nx*ny*nz;
+  }
+  return n;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateBlockSparseImage::CopyChannelToImage(int channel, GateImageDouble & image, double scale) const
+{
+  image.Fill(mBackgroundValues[channel]*scale);
+  for(size_t b=0; b<mAllocatedBlocks.size(); b++) {
+    const double * values = GetBlockValues(b) + channel;
+    for(int v=0; v<kBlockNumberOfVoxels; v++) {
+      int index = GetVoxelIndex(mAllocatedBlocks[b], v);
+      if (index >= 0) image.SetValue(index, values[v*mNumberOfChannels]*scale);
+    }
+  }
+}
+//-----------------------------------------------------------------------------
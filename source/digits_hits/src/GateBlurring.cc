@@ -12,12 +12,24 @@ See LICENSE.md for further details
 #include "GateBlurringMessenger.hh"
 #include "GateTools.hh"
 #include "GateConstants.hh"
+#include "GateMessageManager.hh"
+#include "GateVSystem.hh"
+#include "GateSystemListManager.hh"
+#include "GatePulseProcessorChain.hh"
 #include "Randomize.hh"
+#include "G4UnitsTable.hh"
 
 
 GateBlurring::GateBlurring(GatePulseProcessorChain* itsChain,
       	      	      	      	 const G4String& itsName)
-  : GateVPulseProcessor(itsChain,itsName)
+  : GateVPulseProcessor(itsChain,itsName),
+    m_resolutionTable(0),
+    m_tabulateLaw(false),
+    m_tabulationEMin(0),
+    m_tabulationEMax(0),
+    m_tabulationNbEnergies(0),
+    m_resolutionTableInitDone(false),
+    m_nbCrystals(0)
 {
   m_messenger = new GateBlurringMessenger(this);
   m_blurringLaw = new GateInverseSquareBlurringLaw(GetObjectName());
@@ -28,6 +40,74 @@ GateBlurring::~GateBlurring()
 {
   delete m_messenger;
   delete m_blurringLaw;
+  delete m_resolutionTable;
+}
+
+
+void GateBlurring::SetResolutionTable(const G4String& filename)
+{
+  if (!m_resolutionTable) m_resolutionTable = new GateResolutionTable;
+  m_resolutionTable->Read(filename);
+  m_tabulateLaw = false;
+  m_resolutionTableInitDone = false;
+}
+
+
+void GateBlurring::SetLawTabulation(G4double eMin, G4double eMax, size_t nbEnergies)
+{
+  if (!m_resolutionTable) m_resolutionTable = new GateResolutionTable;
+  m_tabulateLaw = true;
+  m_tabulationEMin = eMin;
+  m_tabulationEMax = eMax;
+  m_tabulationNbEnergies = nbEnergies;
+  m_resolutionTableInitDone = false;
+}
+
+
+void GateBlurring::InitResolutionTable()
+{
+  m_resolutionTableInitDone = true;
+  // The law is tabulated only now, its parameters may be set after the tabulation command
+  if (m_tabulateLaw)
+    m_resolutionTable->Tabulate(m_blurringLaw, m_tabulationEMin, m_tabulationEMax, m_tabulationNbEnergies);
+
+  m_crystalStrides.clear();
+  m_nbCrystals = m_resolutionTable->GetNumberOfCrystals();
+  if (m_nbCrystals == 1)
+    return;
+
+  // The crystal index is only defined within one system: the pulses of a chain
+  // may come from any of the systems, so several systems are refused
+  if (GateSystemListManager::GetInstance()->size() > 1)
+    GateError("[GateBlurring::InitResolutionTable]: the per-crystal resolution table " << m_resolutionTable->GetSource()
+              << " can not be used with several systems\n");
+  GateVSystem* system = GetChain()->GetSystem();
+  if (!system)
+    GateError("[GateBlurring::InitResolutionTable]: no system defined, the crystal index of the resolution table can not be computed\n");
+
+  // Same index as GateVSystem::ComputeIdFromVolID() with all the levels enabled
+  size_t depth = system->GetTreeDepth();
+  std::vector<G4bool> enableList(depth, true);
+  for (size_t i=0; i<depth; i++)
+    m_crystalStrides.push_back(system->ComputeNofSubCrystalsAtLevel(i, enableList));
+  size_t nbCrystals = depth ? m_crystalStrides[0]*system->ComputeNofElementsAtLevel(0) : 0;
+  if (m_nbCrystals != nbCrystals)
+    GateError("[GateBlurring::InitResolutionTable]: the resolution table " << m_resolutionTable->GetSource()
+              << " has " << m_resolutionTable->GetNumberOfCrystals() << " crystals while the system has "
+              << nbCrystals << Gateendl);
+}
+
+
+size_t GateBlurring::ComputeCrystalIndex(const GateOutputVolumeID& volumeID) const
+{
+  size_t index = 0;
+  size_t depth = std::min(volumeID.size(), m_crystalStrides.size());
+  for (size_t i=0; i<depth; i++)
+    if (volumeID[i] >= 0) index += volumeID[i]*m_crystalStrides[i];
+  if (index >= m_nbCrystals)
+    GateError("[GateBlurring::ComputeCrystalIndex]: crystal index " << index << " of the pulse is out of the "
+              << m_nbCrystals << " crystals of the resolution table " << m_resolutionTable->GetSource() << Gateendl);
+  return index;
 }
 
 
@@ -36,7 +116,7 @@ void GateBlurring::ProcessOnePulse(const GatePulse* inputPulse,GatePulseList& ou
 {
 	G4double currentEnergy = inputPulse->GetEnergy();
 	GatePulse* outputPulse = new GatePulse(*inputPulse);
-	outputPulse->SetEnergy(G4RandGauss::shoot(currentEnergy,(m_blurringLaw->ComputeResolution(currentEnergy)*currentEnergy)/GateConstants::fwhm_to_sigma));
+	outputPulse->SetEnergy(G4RandGauss::shoot(currentEnergy,(ComputeResolution(inputPulse,currentEnergy)*currentEnergy)/GateConstants::fwhm_to_sigma));
 	outputPulseList.push_back(outputPulse);
 }
 
@@ -44,4 +124,12 @@ void GateBlurring::DescribeMyself(size_t indent)
 {
  G4cout << GateTools::Indent(indent) << "Blurring law:\t" << m_blurringLaw->GetObjectName() << Gateendl;
  m_blurringLaw->DescribeMyself();
+ if (m_resolutionTable) {
+   if (m_tabulateLaw && !m_resolutionTableInitDone)
+     G4cout << GateTools::Indent(indent) << "Resolution table:\t" << m_tabulationNbEnergies << " energies from "
+            << G4BestUnit(m_tabulationEMin,"Energy") << " to " << G4BestUnit(m_tabulationEMax,"Energy")
+            << ", computed from the law at the first pulse" << Gateendl;
+   else
+     m_resolutionTable->Describe(indent);
+ }
 }
@@ -14,6 +14,10 @@ See LICENSE.md for further details
 #include  "G4UIcmdWithADoubleAndUnit.hh"
 
 #include "G4UIcmdWithAString.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UnitsTable.hh"
+#include <sstream>
 
 #include "GateInverseSquareBlurringLaw.hh"
 #include "GateLinearBlurringLaw.hh"
@@ -29,12 +33,35 @@ GateBlurringMessenger::GateBlurringMessenger(GateBlurring* itsResolution)
   lawCmd = new G4UIcmdWithAString(cmdName,this);
   lawCmd->SetGuidance("Set the law of energy resolution for gaussian blurring");
 
+  cmdName = GetDirectoryName() + "setResolutionTable";
+  resolutionTableCmd = new G4UIcmdWithAString(cmdName,this);
+  resolutionTableCmd->SetGuidance("Read the energy resolution of each crystal, as a function of the energy, from a file (used instead of the law)");
+  resolutionTableCmd->SetParameterName("fileName",false);
+
+  cmdName = GetDirectoryName() + "tabulateLaw";
+  tabulateLawCmd = new G4UIcommand(cmdName,this);
+  tabulateLawCmd->SetGuidance("Tabulate the blurring law at regularly spaced energies when the first pulse is processed,");
+  tabulateLawCmd->SetGuidance("the resolution is then interpolated in this table");
+  G4UIparameter* parameter = new G4UIparameter("eMin",'d',false);
+  tabulateLawCmd->SetParameter(parameter);
+  parameter = new G4UIparameter("eMax",'d',false);
+  tabulateLawCmd->SetParameter(parameter);
+  parameter = new G4UIparameter("unit",'s',true);
+  parameter->SetDefaultValue("keV");
+  tabulateLawCmd->SetParameter(parameter);
+  parameter = new G4UIparameter("nbEnergies",'i',true);
+  parameter->SetDefaultValue(256);
+  parameter->SetParameterRange("nbEnergies>=2");
+  tabulateLawCmd->SetParameter(parameter);
+
 }
 
 
 GateBlurringMessenger::~GateBlurringMessenger()
 {
   delete lawCmd;
+  delete resolutionTableCmd;
+  delete tabulateLawCmd;
 }
 
 
@@ -61,6 +88,18 @@ void GateBlurringMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
     		GetBlurring()->SetBlurringLaw(a_blurringLaw);
   	  	}
   	}
+  else if ( command==resolutionTableCmd )
+    GetBlurring()->SetResolutionTable(newValue);
+  else if ( command==tabulateLawCmd )
+    {
+      G4double eMin, eMax;
+      G4String unit;
+      G4int nbEnergies;
+      std::istringstream is(newValue);
+      is >> eMin >> eMax >> unit >> nbEnergies;
+      G4double unitValue = G4UIcommand::ValueOf(unit);
+      GetBlurring()->SetLawTabulation(eMin*unitValue, eMax*unitValue, nbEnergies);
+    }
   else
     GatePulseProcessorMessenger::SetNewValue(command,newValue);
 }
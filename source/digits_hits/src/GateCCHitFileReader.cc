@@ -30,6 +30,10 @@ GateCCHitFileReader::GateCCHitFileReader(G4String file)
   , m_hitTree(0)
   , m_entries(0)
   , m_currentEntry(0)
+  , m_lastEntry(0)
+  , m_startTime(0.)
+  , m_stopTime(0.)
+  , m_cacheSize(64*1024*1024)
 {
 
 
@@ -106,10 +110,26 @@ void GateCCHitFileReader::PrepareAcquisition()
   // Reset the entry counters
   m_currentEntry=0;
   m_entries = m_hitTree->GetEntries();
+  m_lastEntry = m_entries;
 
   // Set the addresses of the branch buffers: each buffer is a field of the root-hit structure
   GateCCHitTree::SetBranchAddresses(m_hitTree,m_hitBuffer);
 
+  // Restrict the reading to the time window
+  if (m_stopTime>m_startTime) {
+    m_currentEntry = FindFirstEntry(m_startTime);
+    m_lastEntry = FindFirstEntry(m_stopTime);
+    std::cout<<"Reading entries "<<m_currentEntry<<" to "<<m_lastEntry<<" of "<<m_entries<<std::endl;
+  }
+
+  // Read all the branches by large blocks
+  if (m_cacheSize>0) {
+    m_hitTree->SetCacheSize(m_cacheSize);
+    m_hitTree->AddBranchToCache("*",kTRUE);
+    m_hitTree->SetCacheEntryRange(m_currentEntry,m_lastEntry);
+    m_hitTree->StopCacheLearningPhase();
+  }
+
 
   //Load the first hit into the root-hit structure
   LoadHitData();
@@ -203,7 +223,7 @@ void GateCCHitFileReader::TerminateAfterAcquisition()
 
 G4bool GateCCHitFileReader::HasNextEvent(){
 
-  if (m_currentEntry>=m_entries){
+  if (m_currentEntry>=m_lastEntry){
 
     return false;
   }
@@ -235,6 +255,27 @@ void GateCCHitFileReader::LoadHitData()
 
 
 
+// First entry of the hit-tree with a time not before aTime
+// Only the time branch is read during the search
+Long64_t GateCCHitFileReader::FindFirstEntry(G4double aTime)
+{
+  TBranch* timeBranch = m_hitTree->GetBranch("time");
+  Long64_t first = 0;
+  Long64_t last = m_entries;
+  while (first<last) {
+    Long64_t middle = first + (last-first)/2;
+    timeBranch->GetEntry(middle);
+    if (m_hitBuffer.time*s < aTime)
+      first = middle+1;
+    else
+      last = middle;
+  }
+  return first;
+}
+
+
+
+
 /* Overload of the base-class virtual method to print-out a description of the reader
 
    indent: the print-out indentation (cosmetic parameter)
@@ -247,6 +288,7 @@ void GateCCHitFileReader::Describe(size_t indent)
   if (m_hitTree) {
     G4cout << GateTools::Indent(indent) << "Hit-tree entries: " << m_entries << Gateendl;
     G4cout << GateTools::Indent(indent) << "Current entry:    " << m_currentEntry << Gateendl;
+    G4cout << GateTools::Indent(indent) << "Last entry:       " << m_lastEntry << Gateendl;
   }
 }
 
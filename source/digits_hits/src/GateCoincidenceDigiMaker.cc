@@ -39,7 +39,9 @@ GateCoincidenceDigiMaker::~GateCoincidenceDigiMaker()
 // Convert a pulse list into a Coincidence Digi collection
 void GateCoincidenceDigiMaker::Digitize()
 {
-  std::vector<GateCoincidencePulse*> coincidencePulse = GateDigitizer::GetInstance()->FindCoincidencePulse(m_inputName);
+  if (m_inputSlot<0)
+    m_inputSlot = GateDigitizer::GetInstance()->GetCoincidencePulseSlot(m_inputName);
+  std::vector<GateCoincidencePulse*> coincidencePulse = GateDigitizer::GetInstance()->FindCoincidencePulse(m_inputSlot);
   if (coincidencePulse.empty()) {
     if (nVerboseLevel)
       G4cout  << "[GateCoincidenceDigiMaker::Digitize]: coincidence pulse null --> no digi created\n";
@@ -8,6 +8,8 @@ See LICENSE.md for further details
 
 
 #include "Randomize.hh"
+#include "CLHEP/Random/JamesRandom.h"
+#include <algorithm>
 
 #include "GateCoincidenceSorter.hh"
 
@@ -38,6 +40,7 @@ GateCoincidenceSorter::GateCoincidenceSorter(GateDigitizer* itsDigitizer,
     m_system(0),
     m_outputName(itsOutputName),
     m_inputName(itsInputName),
+    m_inputSlot(-1),
     m_coincidenceWindow(itsWindow),
     m_coincidenceWindowJitter(0.),
     m_offset(0.),
@@ -46,10 +49,12 @@ GateCoincidenceSorter::GateCoincidenceSorter(GateDigitizer* itsDigitizer,
     m_multiplesPolicy(kKeepIfAllAreGoods),
     m_allPulseOpenCoincGate(false),
     m_depth(1),
+    m_presortOrder(0),
     m_presortBufferSize(256),
     m_presortWarning(false),
     m_CCSorter(IsCCSorter),
-    m_triggerOnlyByAbsorber(0)
+    m_triggerOnlyByAbsorber(0),
+    m_windowsRandomEngine(0)
 {
 
   // Create the messenger
@@ -69,16 +74,24 @@ GateCoincidenceSorter::~GateCoincidenceSorter()
   while(m_presortBuffer.size() > 0)
   {
      // G4cout<<"[GateCoincidenceSorter::~GateCoincidenceSorter()] m_presortBuffer.size="<<m_presortBuffer.size()<<G4endl;
-    delete m_presortBuffer.back();
+    delete m_presortBuffer.back().pulse;
     m_presortBuffer.pop_back();
   }
 
+  for(size_t i=0; i<m_pulsePool.size(); i++)
+    delete m_pulsePool[i];
+
   while(m_coincidencePulses.size() > 0)
   {
     delete m_coincidencePulses.back();
     m_coincidencePulses.pop_back();
   }
 
+  for(size_t i=0; i<m_additionalWindows.size(); i++)
+    for(size_t j=0; j<m_additionalWindows[i].coincidencePulses.size(); j++)
+      delete m_additionalWindows[i].coincidencePulses[j];
+  delete m_windowsRandomEngine;
+
   delete m_messenger;
 }
 //------------------------------------------------------------------------------------------------------
@@ -98,44 +111,71 @@ void GateCoincidenceSorter::Describe(size_t indent)
   G4cout << GateTools::Indent(indent) << "Presort buffer size: " << m_presortBufferSize << Gateendl;
   G4cout << GateTools::Indent(indent) << "Input:              '" << m_inputName << "'" << Gateendl;
   G4cout << GateTools::Indent(indent) << "Output:             '" << m_outputName << "'" << Gateendl;
+  for(size_t i=0; i<m_additionalWindows.size(); i++)
+    G4cout << GateTools::Indent(indent) << "Additional window:  " << G4BestUnit(m_additionalWindows[i].window,"Time")
+           << " offset " << G4BestUnit(m_additionalWindows[i].offset,"Time")
+           << " -> '" << m_additionalWindows[i].outputName << "'" << Gateendl;
 }
 //------------------------------------------------------------------------------------------------------
 
 
 //------------------------------------------------------------------------------------------------------
 void GateCoincidenceSorter::SetMultiplesPolicy(const G4String& policy)
+{
+  m_multiplesPolicy = ParseMultiplesPolicy(policy);
+}
+//------------------------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------------------------
+multiple_policy_t GateCoincidenceSorter::ParseMultiplesPolicy(const G4String& policy)
 {
     if (policy=="takeWinnerOfGoods")
-    	m_multiplesPolicy=kTakeWinnerOfGoods;
+    	return kTakeWinnerOfGoods;
     else if (policy=="takeWinnerIfIsGood")
-    	m_multiplesPolicy=kTakeWinnerIfIsGood;
+    	return kTakeWinnerIfIsGood;
     else if (policy=="takeWinnerIfAllAreGoods")
-    	m_multiplesPolicy=kTakeWinnerIfAllAreGoods;
+    	return kTakeWinnerIfAllAreGoods;
     else if (policy=="killAll")
-    	m_multiplesPolicy=kKillAll;
+    	return kKillAll;
     else if (policy=="takeAllGoods")
-    	m_multiplesPolicy=kTakeAllGoods;
+    	return kTakeAllGoods;
     else if (policy=="killAllIfMultipleGoods")
-    	m_multiplesPolicy=kKillAllIfMultipleGoods;
+    	return kKillAllIfMultipleGoods;
     else if (policy=="keepIfAnyIsGood")
-    	m_multiplesPolicy=kKeepIfAnyIsGood;
+    	return kKeepIfAnyIsGood;
     else if (policy=="keepIfOnlyOneGood")
-    	m_multiplesPolicy=kKeepIfOnlyOneGood;
+    	return kKeepIfOnlyOneGood;
     else if (policy=="keepAll")
-    	m_multiplesPolicy=kKeepAll;
+    	return kKeepAll;
     else {
     	if (policy!="keepIfAllAreGoods")
     	    G4cout<<"WARNING : policy not recognized, using default : keepMultiplesIfAllAreGoods\n";
-  	m_multiplesPolicy=kKeepIfAllAreGoods;
+  	return kKeepIfAllAreGoods;
     }
 }
 //------------------------------------------------------------------------------------------------------
 
 
+//------------------------------------------------------------------------------------------------------
+void GateCoincidenceSorter::AddWindow(const G4String& outputName, G4double window, G4double offset, const G4String& policy)
+{
+  CoincidenceWindow newWindow;
+  newWindow.outputName = outputName;
+  newWindow.window = window;
+  newWindow.offset = offset;
+  newWindow.multiplesPolicy = ParseMultiplesPolicy(policy);
+  m_additionalWindows.push_back(newWindow);
+
+  m_digitizer->InsertDigiMakerModule( new GateCoincidenceDigiMaker(m_digitizer, outputName,true) );
+}
+//------------------------------------------------------------------------------------------------------
+
+
 void GateCoincidenceSorter::ProcessSinglePulseList(GatePulseList* inp)
 {
   GatePulse* pulse;
-  std::list<GatePulse*>::iterator buf_iter;                // presort buffer iterator
+  PresortedPulse presorted;
   std::deque<GateCoincidencePulse*>::iterator coince_iter; // coincidence list iterator
 
   G4bool inCoincidence;
@@ -160,7 +200,9 @@ void GateCoincidenceSorter::ProcessSinglePulseList(GatePulseList* inp)
 
 
 
-  GatePulseList* inputPulseList = inp ? inp : m_digitizer->FindPulseList( m_inputName );
+  if (!inp && m_inputSlot<0)
+    m_inputSlot = m_digitizer->GetPulseListSlot( m_inputName );
+  GatePulseList* inputPulseList = inp ? inp : m_digitizer->FindPulseList( m_inputSlot );
 
 
 //  if(inputPulseList!=0){
@@ -181,29 +223,31 @@ void GateCoincidenceSorter::ProcessSinglePulseList(GatePulseList* inp)
   // put input pulses in sorted input buffer
   for(gpl_iter = inputPulseList->begin();gpl_iter != inputPulseList->end();gpl_iter++)
   {
-      // make a copy of the pulse
-      pulse = new GatePulse(**gpl_iter);
+      // make a copy of the pulse (reuse a discarded one when possible)
+      if(m_pulsePool.empty())
+          pulse = new GatePulse(**gpl_iter);
+      else
+      {
+          pulse = m_pulsePool.back();
+          m_pulsePool.pop_back();
+          *pulse = **gpl_iter;
+      }
 
-      if(m_presortBuffer.empty())
-          m_presortBuffer.push_back(pulse);
-      else if(pulse->GetTime() < m_presortBuffer.back()->GetTime())    // check that even isn't earlier than the earliest event in the buffer
+      // check that even isn't earlier than the earliest event in the buffer
+      if(!m_presortBuffer.empty() && pulse->GetTime() < m_presortBuffer.front().time)
       {
           if(!m_presortWarning)
               GateWarning("Event is earlier than earliest event in coincidence presort buffer. Consider using a larger buffer.");
           m_presortWarning = true;
-          m_presortBuffer.push_back(pulse); // this will probably not cause a problem, but coincidences may be missed
-      }
-      else // put the event into the presort buffer in the right place
-      {
-          buf_iter = m_presortBuffer.begin();
-          while(pulse->GetTime() < (*buf_iter)->GetTime())
-              buf_iter++;
-          m_presortBuffer.insert(buf_iter, pulse);
-          //      G4cout<<"presortBuffer filled in position "<<std::distance(m_presortBuffer.begin(),buf_iter)<<G4endl;
-          //      G4cout<<"pulseTime "<<pulse->GetTime()<<G4endl;
-          //      G4cout<<"pulseTime "<<pulse->GetTime()/ns<<G4endl;
+          // this will probably not cause a problem, but coincidences may be missed
       }
 
+      // put the event into the presort buffer, it is extracted in time order
+      presorted.time = pulse->GetTime();
+      presorted.order = m_presortOrder++;
+      presorted.pulse = pulse;
+      m_presortBuffer.push_back(presorted);
+      std::push_heap(m_presortBuffer.begin(), m_presortBuffer.end(), IsLaterPresortedPulse());
   }
 
 
@@ -211,9 +255,14 @@ void GateCoincidenceSorter::ProcessSinglePulseList(GatePulseList* inp)
   for(G4int i = m_presortBuffer.size();i > m_presortBufferSize;i--)
   {
 
-    pulse = m_presortBuffer.back();
+    std::pop_heap(m_presortBuffer.begin(), m_presortBuffer.end(), IsLaterPresortedPulse());
+    pulse = m_presortBuffer.back().pulse;
     m_presortBuffer.pop_back();
 
+    // the additional windows get their own copies of the pulse
+    for(size_t w=0; w<m_additionalWindows.size(); w++)
+      ProcessPulseInWindow(pulse, m_additionalWindows[w]);
+
     // process completed coincidence pulse window at front of list
     while(!m_coincidencePulses.empty() && m_coincidencePulses.front()->IsAfterWindow(pulse))
     {
@@ -226,7 +275,7 @@ void GateCoincidenceSorter::ProcessSinglePulseList(GatePulseList* inp)
             ProcessCompletedCoincidenceWindow4CC(coincidence);
         }
         else{
-            ProcessCompletedCoincidenceWindow(coincidence);
+            ProcessCompletedCoincidenceWindow(coincidence, m_multiplesPolicy, m_coincidenceWindow);
         }
     }
 
@@ -266,6 +315,8 @@ void GateCoincidenceSorter::ProcessSinglePulseList(GatePulseList* inp)
                m_coincidencePulses.push_back(coincidence);
 
           }
+          else
+            m_pulsePool.push_back(pulse); // not kept by any coincidence window
       }
       else{
         coincidence = new GateCoincidencePulse(m_outputName,pulse,window,offset);
@@ -274,12 +325,62 @@ void GateCoincidenceSorter::ProcessSinglePulseList(GatePulseList* inp)
       }
     }
     else
-      delete pulse; // pulses that don't open a coincidence window can be discarded
+      m_pulsePool.push_back(pulse); // pulses that don't open a coincidence window can be discarded
   }
 
 }
 
 
+
+// Same as the coincidence search of ProcessSinglePulseList, for an additional window
+void GateCoincidenceSorter::ProcessPulseInWindow(GatePulse* pulse, CoincidenceWindow& window)
+{
+  GateCoincidencePulse* coincidence;
+  std::deque<GateCoincidencePulse*>::iterator coince_iter;
+
+  // process completed coincidence pulse window at front of list
+  while(!window.coincidencePulses.empty() && window.coincidencePulses.front()->IsAfterWindow(pulse))
+  {
+    coincidence = window.coincidencePulses.front();
+    window.coincidencePulses.pop_front();
+    if(m_CCSorter==true)
+      ProcessCompletedCoincidenceWindow4CC(coincidence);
+    else
+      ProcessCompletedCoincidenceWindow(coincidence, window.multiplesPolicy, window.window);
+  }
+
+  // add event to coincidences
+  G4bool inCoincidence = false;
+  coince_iter = window.coincidencePulses.begin();
+  while( coince_iter != window.coincidencePulses.end() && (*coince_iter)->IsInCoincidence(pulse) )
+  {
+    inCoincidence = true;
+    (*coince_iter)->push_back(new GatePulse(pulse));
+    coince_iter++;
+  }
+
+  if(!m_allPulseOpenCoincGate && inCoincidence)
+    return;
+  if(m_triggerOnlyByAbsorber==1 && ((pulse->GetVolumeID()).GetBottomCreator())->GetObjectName()!=m_absorberSD)
+    return;
+
+  // the jitters are drawn from an engine of their own, so that the additional
+  // windows do not shift the random numbers of the main window (and of the
+  // other modules): its output is the same with or without them
+  if(!m_windowsRandomEngine && (m_coincidenceWindowJitter > 0.0 || m_offsetJitter > 0.0))
+    m_windowsRandomEngine = new CLHEP::HepJamesRandom(CLHEP::HepRandom::getTheEngine()->getSeed()+1);
+
+  G4double windowLength = window.window;
+  if(m_coincidenceWindowJitter > 0.0)
+    windowLength = CLHEP::RandGauss::shoot(m_windowsRandomEngine,window.window,m_coincidenceWindowJitter);
+  G4double offset = window.offset;
+  if(m_offsetJitter > 0.0)
+    offset = CLHEP::RandGauss::shoot(m_windowsRandomEngine,window.offset,m_offsetJitter);
+
+  window.coincidencePulses.push_back(new GateCoincidencePulse(window.outputName,new GatePulse(pulse),windowLength,offset));
+}
+
+
 void GateCoincidenceSorter::ProcessCompletedCoincidenceWindow4CC(GateCoincidencePulse *coincidence)
 {
 
@@ -314,7 +415,7 @@ void GateCoincidenceSorter::ProcessCompletedCoincidenceWindow4CC(GateCoincidence
 }
 
 // look for valid coincidences
-void GateCoincidenceSorter::ProcessCompletedCoincidenceWindow(GateCoincidencePulse *coincidence)
+void GateCoincidenceSorter::ProcessCompletedCoincidenceWindow(GateCoincidencePulse *coincidence, multiple_policy_t policy, G4double window)
 {
   G4int i, j, nPulses;
   G4int nGoods, maxGoods;
@@ -342,7 +443,7 @@ void GateCoincidenceSorter::ProcessCompletedCoincidenceWindow(GateCoincidencePul
   }
   else // nPulses>2 multiples
   {
-    if(m_multiplesPolicy==kKillAll)
+    if(policy==kKillAll)
     {
       delete coincidence;
       return;
@@ -352,12 +453,12 @@ void GateCoincidenceSorter::ProcessCompletedCoincidenceWindow(GateCoincidencePul
     // we only want to pair with the first pulse to avoid invalid pairs, or double counting
     PairWithFirstPulseOnly = m_allPulseOpenCoincGate | coincidence->IsDelayed();
 
-    if(m_multiplesPolicy==kTakeAllGoods)
+    if(policy==kTakeAllGoods)
     {
       for(i=0; i<(PairWithFirstPulseOnly?1:(nPulses-1)); i++) // iterate over all pairs (single window) or just pairs with initial event (multi-window)
         for(j=i+1; j<nPulses; j++)
           if(!IsForbiddenCoincidence(coincidence->at(i),coincidence->at(j)) )
-            m_digitizer->StoreCoincidencePulse(CreateSubPulse(coincidence, i, j));
+            m_digitizer->StoreCoincidencePulse(CreateSubPulse(coincidence, i, j, window));
       delete coincidence; // valid pulses extracted so we can delete
       return;
     }
@@ -376,16 +477,16 @@ void GateCoincidenceSorter::ProcessCompletedCoincidenceWindow(GateCoincidencePul
     }
 
     // all the Keep* policies pass on a multi-coincidence rather than breaking into pairs
-    if( ( (m_multiplesPolicy==kKeepIfAnyIsGood) /*&& (nGoods>0)*/          ) || // if nGoods = 0, we don't get here
-        ( (m_multiplesPolicy==kKeepIfOnlyOneGood) && (nGoods==1)           ) ||
-        ( (m_multiplesPolicy==kKeepIfAllAreGoods) && (nGoods==(nPulses*(nPulses-1)/2)) ) )
+    if( ( (policy==kKeepIfAnyIsGood) /*&& (nGoods>0)*/          ) || // if nGoods = 0, we don't get here
+        ( (policy==kKeepIfOnlyOneGood) && (nGoods==1)           ) ||
+        ( (policy==kKeepIfAllAreGoods) && (nGoods==(nPulses*(nPulses-1)/2)) ) )
     {
       m_digitizer->StoreCoincidencePulse(coincidence);
       return; // don't delete the coincidence
     }
-    if((m_multiplesPolicy==kKeepIfAnyIsGood)   ||
-       (m_multiplesPolicy==kKeepIfOnlyOneGood) ||
-       (m_multiplesPolicy==kKeepIfAllAreGoods) )
+    if((policy==kKeepIfAnyIsGood)   ||
+       (policy==kKeepIfOnlyOneGood) ||
+       (policy==kKeepIfAllAreGoods) )
     {
       delete coincidence;
       return;
@@ -416,15 +517,15 @@ void GateCoincidenceSorter::ProcessCompletedCoincidenceWindow(GateCoincidencePul
       return;
     }
 
-    if(m_multiplesPolicy==kTakeWinnerIfIsGood)
+    if(policy==kTakeWinnerIfIsGood)
     {
       if(!IsForbiddenCoincidence(coincidence->at(winner_i),coincidence->at(winner_j)) )
-        m_digitizer->StoreCoincidencePulse(CreateSubPulse(coincidence, winner_i, winner_j));
+        m_digitizer->StoreCoincidencePulse(CreateSubPulse(coincidence, winner_i, winner_j, window));
       delete coincidence;
       return;
     }
 
-    if(m_multiplesPolicy==kKillAllIfMultipleGoods)
+    if(policy==kKillAllIfMultipleGoods)
     {
       if(nGoods>1)
       {
@@ -436,18 +537,18 @@ void GateCoincidenceSorter::ProcessCompletedCoincidenceWindow(GateCoincidencePul
         for(i=0; i<(coincidence->IsDelayed()?1:(nPulses-1)); i++)
           for(j=i+1; j<nPulses; j++)
             if(!IsForbiddenCoincidence(coincidence->at(i),coincidence->at(j)))
-              m_digitizer->StoreCoincidencePulse(CreateSubPulse(coincidence, i, j));
+              m_digitizer->StoreCoincidencePulse(CreateSubPulse(coincidence, i, j, window));
         delete coincidence;
         return;
       }
     }
 
     maxGoods = PairWithFirstPulseOnly?(nPulses-1):(nPulses*(nPulses-1)/2);
-    if(m_multiplesPolicy==kTakeWinnerIfAllAreGoods)
+    if(policy==kTakeWinnerIfAllAreGoods)
     {
       if(nGoods==maxGoods)
       {
-        m_digitizer->StoreCoincidencePulse(CreateSubPulse(coincidence, winner_i, winner_j));
+        m_digitizer->StoreCoincidencePulse(CreateSubPulse(coincidence, winner_i, winner_j, window));
         delete coincidence;
         return;
       }
@@ -458,7 +559,7 @@ void GateCoincidenceSorter::ProcessCompletedCoincidenceWindow(GateCoincidencePul
       }
     }
 
-    if(m_multiplesPolicy==kTakeWinnerOfGoods)
+    if(policy==kTakeWinnerOfGoods)
     {
       // find winner
       maxE = 0.0;
@@ -476,7 +577,7 @@ void GateCoincidenceSorter::ProcessCompletedCoincidenceWindow(GateCoincidencePul
             }
           }
         }
-      m_digitizer->StoreCoincidencePulse(CreateSubPulse(coincidence, winner_i, winner_j));
+      m_digitizer->StoreCoincidencePulse(CreateSubPulse(coincidence, winner_i, winner_j, window));
       delete coincidence; // valid pulses extracted so we can delete
       return;
     }
@@ -487,12 +588,12 @@ void GateCoincidenceSorter::ProcessCompletedCoincidenceWindow(GateCoincidencePul
 
 }
 
-GateCoincidencePulse* GateCoincidenceSorter::CreateSubPulse(GateCoincidencePulse* coincidence, G4int i, G4int j)
+GateCoincidencePulse* GateCoincidenceSorter::CreateSubPulse(GateCoincidencePulse* coincidence, G4int i, G4int j, G4double window)
 {
   GatePulse* pulse1 = new GatePulse(coincidence->at(i));
   GatePulse* pulse2 = new GatePulse(coincidence->at(j));
   G4double offset = coincidence->GetStartTime() - pulse1->GetTime();
-  GateCoincidencePulse *newCoincPulse = new GateCoincidencePulse(m_outputName,pulse1,m_coincidenceWindow,offset);
+  GateCoincidencePulse *newCoincPulse = new GateCoincidencePulse(coincidence->GetListName(),pulse1,window,offset);
   newCoincPulse->push_back(pulse2);
   return newCoincPulse;
 }
@@ -16,6 +16,9 @@ See LICENSE.md for further details
 #include "G4UIcmdWithAString.hh"
 #include "G4UIcmdWithAnInteger.hh"
 #include "G4UIcmdWithABool.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include <sstream>
 
 GateCoincidenceSorterMessenger::GateCoincidenceSorterMessenger(GateCoincidenceSorter* itsCoincidenceSorter)
     : GateClockDependentMessenger(itsCoincidenceSorter)
@@ -80,6 +83,28 @@ GateCoincidenceSorterMessenger::GateCoincidenceSorterMessenger(GateCoincidenceSo
   SetTriggerOnlyByAbsorberCmd = new G4UIcmdWithABool(cmdName,this);
   SetTriggerOnlyByAbsorberCmd->SetGuidance("Specify if only the pulses in the absorber can open a coincidencee window");
 
+  cmdName = GetDirectoryName()+"addWindow";
+  addWindowCmd = new G4UIcommand(cmdName,this);
+  addWindowCmd->SetGuidance("Add a coincidence window evaluated on the same sorted singles, with its own output");
+  addWindowCmd->SetGuidance("Parameters: output name, window, window unit, offset, offset unit, multiples policy");
+  G4UIparameter* param;
+  param = new G4UIparameter("outputName",'s',false);
+  addWindowCmd->SetParameter(param);
+  param = new G4UIparameter("window",'d',false);
+  addWindowCmd->SetParameter(param);
+  param = new G4UIparameter("windowUnit",'s',true);
+  param->SetDefaultValue("ns");
+  addWindowCmd->SetParameter(param);
+  param = new G4UIparameter("offset",'d',true);
+  param->SetDefaultValue("0");
+  addWindowCmd->SetParameter(param);
+  param = new G4UIparameter("offsetUnit",'s',true);
+  param->SetDefaultValue("ns");
+  addWindowCmd->SetParameter(param);
+  param = new G4UIparameter("policy",'s',true);
+  param->SetDefaultValue("keepIfAllAreGoods");
+  addWindowCmd->SetParameter(param);
+
 }
 
 
@@ -95,6 +120,7 @@ GateCoincidenceSorterMessenger::~GateCoincidenceSorterMessenger()
     delete setPresortBufferSizeCmd;
     delete AllPulseOpenCoincGateCmd;
     delete SetTriggerOnlyByAbsorberCmd;
+    delete addWindowCmd;
 
 }
 
@@ -126,6 +152,17 @@ void GateCoincidenceSorterMessenger::SetNewValue(G4UIcommand* aCommand, G4String
     { GetCoincidenceSorter()->SetAllPulseOpenCoincGate(AllPulseOpenCoincGateCmd->GetNewBoolValue(newValue)); }
   else if (aCommand == SetTriggerOnlyByAbsorberCmd)
     { GetCoincidenceSorter()->SetIfTriggerOnlyByAbsorber(SetTriggerOnlyByAbsorberCmd->GetNewBoolValue(newValue));}
+  else if (aCommand == addWindowCmd)
+    {
+     G4String outputName, windowUnit, offsetUnit, policy;
+     G4double window, offset;
+     std::istringstream is(newValue);
+     is >> outputName >> window >> windowUnit >> offset >> offsetUnit >> policy;
+     GetCoincidenceSorter()->AddWindow(outputName,
+                                       window*G4UIcommand::ValueOf(windowUnit),
+                                       offset*G4UIcommand::ValueOf(offsetUnit),
+                                       policy);
+    }
   else
     GateClockDependentMessenger::SetNewValue(aCommand,newValue);
 }
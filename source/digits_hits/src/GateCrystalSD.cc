@@ -16,6 +16,8 @@
 #include "G4VProcess.hh"
 
 #include "G4TransportationManager.hh"
+#include "G4RunManager.hh"
+#include "G4Run.hh"
 
 #include "GateVSystem.hh"
 #include "GateRotationMove.hh"
@@ -36,7 +38,7 @@ const G4String GateCrystalSD::theCrystalCollectionName = "crystalCollection";
 //------------------------------------------------------------------------------
 // Constructor
 GateCrystalSD::GateCrystalSD(const G4String& name)
-:G4VSensitiveDetector(name),m_system(0)
+:G4VSensitiveDetector(name),m_system(0),m_volumeInfoCacheRunID(-1)
 {
   collectionName.insert(theCrystalCollectionName);
 }
@@ -68,6 +70,13 @@ void GateCrystalSD::Initialize(G4HCofThisEvent*HCE)
 
   // Add the hit collection to the G4HCofThisEvent
   HCE->AddHitsCollection(HCID,crystalCollection);
+
+  // The geometry may change between time slices (runs): the volume data are recomputed
+  G4int runID = G4RunManager::GetRunManager()->GetCurrentRun()->GetRunID();
+  if (runID != m_volumeInfoCacheRunID) {
+    m_volumeInfoCache.clear();
+    m_volumeInfoCacheRunID = runID;
+  }
 }
 //------------------------------------------------------------------------------
 
@@ -129,18 +138,19 @@ G4bool GateCrystalSD::ProcessHits(G4Step*aStep, G4TouchableHistory*)
 
   // Get the scanner position and rotation angle
 /*  GateSystemComponent* baseComponent = GetSystem()->GetBaseComponent();*/
-  GateVSystem* system = FindSystem(volumeID);
+  const VolumeInfo& volumeInfo = GetVolumeInfo(volumeID);
+  GateVSystem* system = volumeInfo.system;
   GateSystemComponent* baseComponent = system->GetBaseComponent();
   G4ThreeVector scannerPos = baseComponent->GetCurrentTranslation();
   G4double scannerRotAngle = 0;
 
 
-  if ( baseComponent->FindRotationMove() )
-    scannerRotAngle = baseComponent->FindRotationMove()->GetCurrentAngle();
-  else if ( baseComponent->FindOrbitingMove() )
-    scannerRotAngle = baseComponent->FindOrbitingMove()->GetCurrentAngle();
-  else if ( baseComponent->FindEccentRotMove() )
-    scannerRotAngle = baseComponent->FindEccentRotMove()->GetCurrentAngle();
+  if ( volumeInfo.rotationMove )
+    scannerRotAngle = volumeInfo.rotationMove->GetCurrentAngle();
+  else if ( volumeInfo.orbitingMove )
+    scannerRotAngle = volumeInfo.orbitingMove->GetCurrentAngle();
+  else if ( volumeInfo.eccentRotMove )
+    scannerRotAngle = volumeInfo.eccentRotMove->GetCurrentAngle();
 
 
   // deposit energy in the current step
@@ -178,8 +188,7 @@ G4bool GateCrystalSD::ProcessHits(G4Step*aStep, G4TouchableHistory*)
 
 //Seb Modif 24/02/2009
 /*  GateOutputVolumeID outputVolumeID = GetSystem()->ComputeOutputVolumeID(aHit->GetVolumeID());*/
-  GateOutputVolumeID outputVolumeID = system->ComputeOutputVolumeID(aHit->GetVolumeID());
-  aHit->SetOutputVolumeID(outputVolumeID);
+  aHit->SetOutputVolumeID(volumeInfo.outputVolumeID);
 
   // Insert the new hit into the hit collection
   crystalCollection->insert( aHit );
@@ -189,6 +198,25 @@ G4bool GateCrystalSD::ProcessHits(G4Step*aStep, G4TouchableHistory*)
 //------------------------------------------------------------------------------
 
 
+//------------------------------------------------------------------------------
+const GateCrystalSD::VolumeInfo& GateCrystalSD::GetVolumeInfo(const GateVolumeID& volumeID)
+{
+  std::unordered_map<GateVolumeID,VolumeInfo,GateVolumeIDHash>::iterator it = m_volumeInfoCache.find(volumeID);
+  if (it != m_volumeInfoCache.end())
+    return it->second;
+
+  VolumeInfo& info = m_volumeInfoCache[volumeID];
+  info.system = FindSystem(volumeID);
+  info.outputVolumeID = info.system->ComputeOutputVolumeID(volumeID);
+  GateSystemComponent* baseComponent = info.system->GetBaseComponent();
+  info.rotationMove = baseComponent->FindRotationMove();
+  info.orbitingMove = baseComponent->FindOrbitingMove();
+  info.eccentRotMove = baseComponent->FindEccentRotMove();
+  return info;
+}
+//------------------------------------------------------------------------------
+
+
 //------------------------------------------------------------------------------
 //! Next method underwent an important modification to be compatible with the multi-system approach
 G4int GateCrystalSD::PrepareCreatorAttachment(GateVVolume* aCreator)
@@ -23,6 +23,8 @@
 
 GateDeadTime::GateDeadTime(GatePulseProcessorChain* itsChain, const G4String& itsName)
   : GateVPulseProcessor(itsChain,itsName)
+  , m_volumeCreator(0)
+  , m_initDoneRunID(-1)
   , m_bufferSize(0)
   , m_bufferMode(0)
 {
@@ -44,11 +46,9 @@ GateDeadTime::~GateDeadTime()
 
 void GateDeadTime::ProcessOnePulse(const GatePulse* inputPulse, GatePulseList& outputPulseList)
 {
-  static G4int m_init_done_run_id = -1;
-
   if (!inputPulse) return;
 
-  if (inputPulse->GetRunID() != m_init_done_run_id) {
+  if (inputPulse->GetRunID() != m_initDoneRunID) {
     // initialise the DeadTime buffer and table
     CheckVolumeName(m_volumeName);
     if (!m_testVolume) {
@@ -60,7 +60,7 @@ void GateDeadTime::ProcessOnePulse(const GatePulse* inputPulse, GatePulseList& o
       G4cout << "deadtime set at  " << m_deadTime << " ps"<< Gateendl ;
       G4cout << "mode = " << (m_isParalysable ? "paralysable":"non-paralysable") << Gateendl ;
     }
-    m_init_done_run_id = inputPulse->GetRunID();
+    m_initDoneRunID = inputPulse->GetRunID();
   }
 
   if (inputPulse->GetEnergy()==0) {
@@ -74,7 +74,12 @@ void GateDeadTime::ProcessOnePulse(const GatePulse* inputPulse, GatePulseList& o
   G4int m_generalDetId = 0; // a unique number for each detector part
                             // that depends of the depth of application
                             // of the dead time
-  size_t m_depth = (size_t)(aVolumeID->GetCreatorDepth(m_volumeName));
+  // the creator is compared by address instead of by name
+  size_t m_depth = 0;
+  while ( (m_depth<aVolumeID->size()) && (aVolumeID->GetCreator(m_depth)!=m_volumeCreator) )
+    m_depth++;
+  if (m_depth==aVolumeID->size())
+    m_depth = (size_t)(-1);
 
   m_generalDetId = aVolumeID->GetCopyNo(m_depth);
 
@@ -86,11 +91,8 @@ void GateDeadTime::ProcessOnePulse(const GatePulse* inputPulse, GatePulseList& o
     }
   */
 
-  G4int multFactor = 1;
-  for (G4int i = 1 ; i < numberOfHigherLevels + 1; i++) {
-    multFactor *= numberOfComponentForLevel[i-1];
-    m_generalDetId += aVolumeID->GetCopyNo(m_depth-i)*multFactor;
-  }
+  for (G4int i = 1 ; i < numberOfHigherLevels + 1; i++)
+    m_generalDetId += aVolumeID->GetCopyNo(m_depth-i)*m_levelMultipliers[i-1];
   //////////////////////////////////////////////////////////////
 
   // FIND TIME OF PULSE
@@ -163,6 +165,7 @@ void GateDeadTime::CheckVolumeName(G4String val)
 
   if (anInserterStore->FindCreator(val)) {
     m_volumeName = val;
+    m_volumeCreator = anInserterStore->FindCreator(val);
 
     FindLevelsParams(anInserterStore);
     m_testVolume = 1;
@@ -207,8 +210,10 @@ void GateDeadTime::FindLevelsParams(GateObjectStore*  anInserterStore)
   }
 
   numberTotalOfComponentInSystem = 1;
+  m_levelMultipliers.resize(numberOfHigherLevels);
   for (G4int i2 = 0 ; i2 < numberOfHigherLevels ; i2++) {
     numberTotalOfComponentInSystem = numberTotalOfComponentInSystem * numberOfComponentForLevel[i2];
+    m_levelMultipliers[i2] = numberTotalOfComponentInSystem;
     if (nVerboseLevel>5)
       G4cout << "Level : " << i2 << " has "
              << numberOfComponentForLevel[i2] << " elements\n";
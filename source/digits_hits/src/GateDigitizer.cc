@@ -19,6 +19,8 @@
 #include "GateVPulseProcessor.hh"
 #include "GateVSystem.hh"
 
+#include <algorithm>
+
 typedef std::pair<G4String,GatePulseList*> 	GatePulseListAlias;
 
 GateDigitizer* GateDigitizer::theDigitizer=0;
@@ -134,29 +136,28 @@ void GateDigitizer::DescribeSorters(size_t indent)
 
 //-----------------------------------------------------------------
 // Clear the array of pulse-lists
+// The containers and the slots keep their memory for the next event
 void GateDigitizer::ErasePulseListVector()
 {
-  while (m_pulseListVector.size()) {
+  size_t i;
+  for (i=0; i<m_pulseListVector.size(); ++i) {
     if (nVerboseLevel>1)
-      G4cout << "[GateDigitizer::ErasePulseListVector]: Erasing pulse-list '" << m_pulseListVector.back()->GetListName() << "'\n";
-    delete m_pulseListVector.back();
-    m_pulseListVector.erase(m_pulseListVector.end()-1);
+      G4cout << "[GateDigitizer::ErasePulseListVector]: Erasing pulse-list '" << m_pulseListVector[i]->GetListName() << "'\n";
+    delete m_pulseListVector[i];
   }
-  while (m_coincidencePulseVector.size()) {
+  m_pulseListVector.clear();
+  for (i=0; i<m_coincidencePulseVector.size(); ++i) {
     if (nVerboseLevel>1)
       G4cout << "[GateDigitizer::ErasePulseListVector]: Erasing coincidence pulse\n";
-    delete m_coincidencePulseVector.back();
-    m_coincidencePulseVector.erase(m_coincidencePulseVector.end()-1);
-  }
-  while (m_pulseListAliasVector.size()) {
-    if (nVerboseLevel>1)
-      G4cout << "[GateDigitizer::ErasePulseListVector]: Erasing alias '" << m_pulseListAliasVector.back().first << "'\n";
-    m_pulseListAliasVector.erase(m_pulseListAliasVector.end()-1);
+    delete m_coincidencePulseVector[i];
   }
-  while (m_coincidencePulseListAliasVector.size()) {
-    if (nVerboseLevel>1)
-      G4cout << "[GateDigitizer::ErasePulseListVector]: Erasing alias '" << m_coincidencePulseListAliasVector.back().first << "'\n";
-    m_coincidencePulseListAliasVector.erase(m_coincidencePulseListAliasVector.end()-1);
+  m_coincidencePulseVector.clear();
+
+  std::fill(m_pulseListAliasSlots.begin(),m_pulseListAliasSlots.end(),(GatePulseList*)0);
+  std::fill(m_pulseListNameSlots.begin(),m_pulseListNameSlots.end(),(GatePulseList*)0);
+  for (i=0; i<m_coincidencePulseAliasSlots.size(); ++i) {
+    m_coincidencePulseAliasSlots[i].clear();
+    m_coincidencePulseNameSlots[i].clear();
   }
 }
 //-----------------------------------------------------------------
@@ -171,6 +172,9 @@ void GateDigitizer::StorePulseList(GatePulseList* newPulseList)
       G4cout << "[GateDigitizer::StorePulseList]: Storing new pulse-list '" << newPulseList->GetListName() << "'\n";
        if(newPulseList->size()>0){
     m_pulseListVector.push_back(newPulseList);
+    G4int slot = GetPulseListSlot(newPulseList->GetListName());
+    if (!m_pulseListNameSlots[slot])
+      m_pulseListNameSlots[slot] = newPulseList;
        }
   }
 }
@@ -186,6 +190,7 @@ void GateDigitizer::StoreCoincidencePulse(GateCoincidencePulse* newCoincidencePu
       G4cout << "[GateDigitizer::StoreCoincidencePulse]: Storing new coincidence pulse\n";
        // G4cout<<"first pulse evtID"<<newCoincidencePulse->at(0)->GetEventID()<<"first pulse time+"<<newCoincidencePulse->at(0)->GetTime()<<G4endl;
     m_coincidencePulseVector.push_back(newCoincidencePulse);
+    m_coincidencePulseNameSlots[GetCoincidencePulseSlot(newCoincidencePulse->GetListName())].push_back(newCoincidencePulse);
   }
 }
 //-----------------------------------------------------------------
@@ -194,12 +199,24 @@ void GateDigitizer::StoreCoincidencePulse(GateCoincidencePulse* newCoincidencePu
 //-----------------------------------------------------------------
 // Store a new alias for a pulse-list
 void GateDigitizer::StorePulseListAlias(const G4String& aliasName,GatePulseList* aPulseList)
+{
+  if (aPulseList)
+    StorePulseListAlias(GetPulseListSlot(aliasName),aPulseList);
+}
+//-----------------------------------------------------------------
+
+
+//-----------------------------------------------------------------
+// Store a new alias for a pulse-list into a slot (the first alias stored
+// in an event is kept)
+void GateDigitizer::StorePulseListAlias(G4int slot,GatePulseList* aPulseList)
 {
   if (aPulseList) {
     if (nVerboseLevel>1)
-      G4cout << "[GateDigitizer::StorePulseListAlias]: Storing new alias '" << aliasName
-             << "' for list '" << aPulseList->GetListName() << "'"<< Gateendl;
-    m_pulseListAliasVector.push_back(GatePulseListAlias(aliasName,aPulseList));
+      G4cout << "[GateDigitizer::StorePulseListAlias]: Storing new alias in slot " << slot
+             << " for list '" << aPulseList->GetListName() << "'"<< Gateendl;
+    if (!m_pulseListAliasSlots[slot])
+      m_pulseListAliasSlots[slot] = aPulseList;
   }
 }
 //-----------------------------------------------------------------
@@ -208,12 +225,22 @@ void GateDigitizer::StorePulseListAlias(const G4String& aliasName,GatePulseList*
 //-----------------------------------------------------------------
 // Store a new alias for a coincidence pulse
 void GateDigitizer::StoreCoincidencePulseAlias(const G4String& aliasName,GateCoincidencePulse* aPulse)
+{
+  if (aPulse)
+    StoreCoincidencePulseAlias(GetCoincidencePulseSlot(aliasName),aPulse);
+}
+//-----------------------------------------------------------------
+
+
+//-----------------------------------------------------------------
+// Store a new alias for a coincidence pulse into a slot
+void GateDigitizer::StoreCoincidencePulseAlias(G4int slot,GateCoincidencePulse* aPulse)
 {
   if (aPulse) {
     if (nVerboseLevel>1)
-      G4cout << "[GateDigitizer::StoreCoincidencePulseListAlias]: Storing new alias '" << aliasName
-             << "' for coincidence '" << aPulse->GetListName() << "'"<< Gateendl;
-    m_coincidencePulseListAliasVector.push_back(GateCoincidencePulseListAlias(aliasName,aPulse));
+      G4cout << "[GateDigitizer::StoreCoincidencePulseListAlias]: Storing new alias in slot " << slot
+             << " for coincidence '" << aPulse->GetListName() << "'"<< Gateendl;
+    m_coincidencePulseAliasSlots[slot].push_back(aPulse);
   }
 }
 //-----------------------------------------------------------------
@@ -226,58 +253,108 @@ GatePulseList* GateDigitizer::FindPulseList(const G4String& pulseListName)
   if (nVerboseLevel>1)
     G4cout << "[GateDigitizer::FindPulseList]: Looking for pulse-list '" << pulseListName << "'"<< Gateendl;
 
-  size_t i;
-  for (i=0; i<m_pulseListAliasVector.size(); ++i)
-    if ( m_pulseListAliasVector[i].first == pulseListName) {
-      if (nVerboseLevel>1)
-        G4cout << "[GateDigitizer::FindPulseList]: Found pulse-list '" << pulseListName << "'"<< Gateendl;
-      return m_pulseListAliasVector[i].second;
-    }
-  for (i=0; i<m_pulseListVector.size(); ++i)
-    if ( m_pulseListVector[i]->GetListName() == pulseListName) {
-      if (nVerboseLevel>1)
-        G4cout << "[GateDigitizer::FindPulseList]: Found pulse-list alias '" << pulseListName << "'"<< Gateendl;
-      return m_pulseListVector[i];
-    }
-  if (nVerboseLevel>1)
-    G4cout << "[GateDigitizer::FindPulseList]: Could not find pulse-list '" << pulseListName << "'"<< Gateendl;
-  return 0;
+  std::unordered_map<std::string,G4int>::const_iterator it = m_pulseListSlotMap.find(pulseListName);
+  if (it == m_pulseListSlotMap.end()) {
+    if (nVerboseLevel>1)
+      G4cout << "[GateDigitizer::FindPulseList]: Could not find pulse-list '" << pulseListName << "'"<< Gateendl;
+    return 0;
+  }
+  return FindPulseList(it->second);
 }
 //-----------------------------------------------------------------
 
 
 //-----------------------------------------------------------------
-// Find a pulse-list from the array of pulse-list
-std::vector<GateCoincidencePulse*> GateDigitizer::FindCoincidencePulse(const G4String& pulseName)
+// Find a pulse-list from its slot, the aliases have the priority
+GatePulseList* GateDigitizer::FindPulseList(G4int slot)
 {
+  GatePulseList* pulseList = m_pulseListAliasSlots[slot];
+  if (!pulseList)
+    pulseList = m_pulseListNameSlots[slot];
+  if (nVerboseLevel>1) {
+    if (pulseList)
+      G4cout << "[GateDigitizer::FindPulseList]: Found pulse-list '" << pulseList->GetListName() << "' in slot " << slot << Gateendl;
+    else
+      G4cout << "[GateDigitizer::FindPulseList]: Could not find pulse-list in slot " << slot << Gateendl;
+  }
+  return pulseList;
+}
+//-----------------------------------------------------------------
 
 
-  std::vector<GateCoincidencePulse*> ans;
+//-----------------------------------------------------------------
+// Slot of a pulse-list name, a new slot is created for an unknown name
+G4int GateDigitizer::GetPulseListSlot(const G4String& pulseListName)
+{
+  std::pair<std::unordered_map<std::string,G4int>::iterator,bool> inserted =
+    m_pulseListSlotMap.insert(std::make_pair(std::string(pulseListName),(G4int)m_pulseListAliasSlots.size()));
+  if (inserted.second) {
+    if (nVerboseLevel>1)
+      G4cout << "[GateDigitizer::GetPulseListSlot]: Binding pulse-list '" << pulseListName
+             << "' to slot " << inserted.first->second << Gateendl;
+    m_pulseListAliasSlots.push_back(0);
+    m_pulseListNameSlots.push_back(0);
+  }
+  return inserted.first->second;
+}
+//-----------------------------------------------------------------
+
+
+//-----------------------------------------------------------------
+// Find a pulse-list from the array of pulse-list
+std::vector<GateCoincidencePulse*> GateDigitizer::FindCoincidencePulse(const G4String& pulseName)
+{
   if (nVerboseLevel>1)
     G4cout << "[GateDigitizer::FindCoincidencePulse]: Looking for coincidence pulse '" << pulseName << "'"<< Gateendl;
 
-  size_t i;
-  for (i=0; i<m_coincidencePulseListAliasVector.size(); ++i)
-    if ( m_coincidencePulseListAliasVector[i].first == pulseName) {
-      if (nVerboseLevel>1)
-        G4cout << "[GateDigitizer::FindCoincidencePulse]: Found pulse-list '" << pulseName << "'"<< Gateendl;
-      ans.push_back(m_coincidencePulseListAliasVector[i].second);
-    }
-  for (i=0; i<m_coincidencePulseVector.size(); ++i){
-    if ( m_coincidencePulseVector[i]->GetListName() == pulseName) {
-      if (nVerboseLevel>1)
-        G4cout << "[GateDigitizer::FindCoincidencePulse]: Found coincidence pulse '" << pulseName << "'"<< Gateendl;
-      ans.push_back(m_coincidencePulseVector[i]);
-    }
+  std::unordered_map<std::string,G4int>::const_iterator it = m_coincidencePulseSlotMap.find(pulseName);
+  if (it == m_coincidencePulseSlotMap.end()) {
+    if (nVerboseLevel>1)
+      G4cout << "[GateDigitizer::FindCoincidencePulse]: Cound not find coincidence pulse '" << pulseName << "'"<< Gateendl;
+    return std::vector<GateCoincidencePulse*>();
   }
+  return FindCoincidencePulse(it->second);
+}
+//-----------------------------------------------------------------
+
+
+//-----------------------------------------------------------------
+// Find the coincidence pulses of a slot, the aliases come first
+std::vector<GateCoincidencePulse*> GateDigitizer::FindCoincidencePulse(G4int slot)
+{
+  const std::vector<GateCoincidencePulse*>& aliases = m_coincidencePulseAliasSlots[slot];
+  const std::vector<GateCoincidencePulse*>& pulses = m_coincidencePulseNameSlots[slot];
   if (nVerboseLevel>1)
-    G4cout << "[GateDigitizer::FindCoincidencePulse]: Cound not find coincidence pulse '" << pulseName << "'"<< Gateendl;
+    G4cout << "[GateDigitizer::FindCoincidencePulse]: Found " << aliases.size() << " alias(es) and "
+           << pulses.size() << " coincidence pulse(s) in slot " << slot << Gateendl;
 
+  std::vector<GateCoincidencePulse*> ans;
+  ans.reserve(aliases.size()+pulses.size());
+  ans.insert(ans.end(),aliases.begin(),aliases.end());
+  ans.insert(ans.end(),pulses.begin(),pulses.end());
   return ans;
 }
 //-----------------------------------------------------------------
 
 
+//-----------------------------------------------------------------
+// Slot of a coincidence pulse name, a new slot is created for an unknown name
+G4int GateDigitizer::GetCoincidencePulseSlot(const G4String& pulseName)
+{
+  std::pair<std::unordered_map<std::string,G4int>::iterator,bool> inserted =
+    m_coincidencePulseSlotMap.insert(std::make_pair(std::string(pulseName),(G4int)m_coincidencePulseAliasSlots.size()));
+  if (inserted.second) {
+    if (nVerboseLevel>1)
+      G4cout << "[GateDigitizer::GetCoincidencePulseSlot]: Binding coincidence pulse '" << pulseName
+             << "' to slot " << inserted.first->second << Gateendl;
+    m_coincidencePulseAliasSlots.push_back(std::vector<GateCoincidencePulse*>());
+    m_coincidencePulseNameSlots.push_back(std::vector<GateCoincidencePulse*>());
+  }
+  return inserted.first->second;
+}
+//-----------------------------------------------------------------
+
+
 //-----------------------------------------------------------------
 // Integrates a new pulse-processor chain
 void GateDigitizer::StoreNewPulseProcessorChain(GatePulseProcessorChain* processorChain)
@@ -14,29 +14,35 @@
 // gate
 #include "GateDoseActor.hh"
 #include "GateMiscFunctions.hh"
+#include "GateConfiguration.h"
 
 // g4
 #include <G4EmCalculator.hh>
 #include <G4VoxelLimits.hh>
 #include <G4NistManager.hh>
 #include <G4PhysicalConstants.hh>
+#include <G4SystemOfUnits.hh>
 #include <G4Gamma.hh>
 #include <G4Proton.hh>
 #include <G4Positron.hh>
 #include <G4Deuteron.hh>
 #include <G4Electron.hh>
+#include <G4Threading.hh>
 
 #include "G4MaterialTable.hh"
 #include "G4ParticleTable.hh"
 #include "G4ParticleDefinition.hh"
 #include "G4ProcessManager.hh"
 
+#include <algorithm>
+
 //-----------------------------------------------------------------------------
 GateDoseActor::GateDoseActor(G4String name, G4int depth):
   GateVImageActor(name,depth) {
   GateDebugMessageInc("Actor",4,"GateDoseActor() -- begin\n");
 
   mCurrentEvent=-1;
+  mLastMergedEvent=-1;
   //Edep
   mIsEdepImageEnabled = false;
   mIsEdepSquaredImageEnabled = false;
@@ -47,6 +53,7 @@ GateDoseActor::GateDoseActor(G4String name, G4int depth):
   mIsDoseUncertaintyImageEnabled = false;
   mIsDoseNormalisationEnabled = false;
   mIsDoseEfficiencyEnabled = false;
+  mDoseEfficiencyMinZ = 0;
   mIsDoseEfficiencyByZEnabled = false;
   //DoseToWater
   mIsDoseToWaterImageEnabled = false;
@@ -60,14 +67,20 @@ GateDoseActor::GateDoseActor(G4String name, G4int depth):
   mIsDoseToOtherMaterialUncertaintyImageEnabled = false;
   mIsDoseToOtherMaterialNormalisationEnabled = false;
   mOtherMaterial = "G4Water";
+  mOtherMaterialDensity = 1;
+  mStoppingPowerRatioTableBins = 400;
+  mStoppingPowerRatioTableTolerance = 1e-3;
   //Others
   mIsNumberOfHitsImageEnabled = false;
+  mIsNumberOfHitsTrackingEnabled = false;
   mIsLastHitEventImageEnabled = false;
+  mIsSparseStorageEnabled = false;
   mDoseAlgorithmType = "VolumeWeighting";
   mImportMassImage = "";
   mExportMassImage = "";
   mVolumeFilter = "";
   mMaterialFilter = "";
+  pUserSteppingActionInVoxel = &GateDoseActor::UserSteppingActionInVoxelT<false>;
   mTestFlag = false;
   mDoseByRegionsFlag = false;
 
@@ -220,7 +233,11 @@ void GateDoseActor::Construct() {
       mIsDoseToOtherMaterialSquaredImageEnabled || mIsDoseToOtherMaterialUncertaintyImageEnabled)
     {
       mLastHitEventImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
-      mLastHitEventImage.Allocate();
+      if (mIsSparseStorageEnabled) {
+        mSparseLastHitEventImage.SetLayout(mLastHitEventImage, 1);
+        mSparseLastHitEventImage.SetBackgroundValue(0, -1);
+      }
+      else mLastHitEventImage.Allocate();
       mIsLastHitEventImageEnabled = true;
     }
   //Edep
@@ -231,6 +248,7 @@ void GateDoseActor::Construct() {
     // Force the computation of squared image if uncertainty is enabled
     if (mIsEdepUncertaintyImageEnabled) mEdepImage.EnableSquaredImage(true);
     mEdepImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
+    mEdepImage.EnableSparseStorage(mIsSparseStorageEnabled);
     mEdepImage.Allocate();
     mEdepImage.SetFilename(mEdepFilename);
   }
@@ -242,6 +260,7 @@ void GateDoseActor::Construct() {
     mDoseImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
     // Force the computation of squared image if uncertainty is enabled
     if (mIsDoseUncertaintyImageEnabled) mDoseImage.EnableSquaredImage(true);
+    mDoseImage.EnableSparseStorage(mIsSparseStorageEnabled);
     mDoseImage.Allocate();
     mDoseImage.SetFilename(mDoseFilename);
   }
@@ -252,6 +271,7 @@ void GateDoseActor::Construct() {
     // Force the computation of squared image if uncertainty is enabled
     if (mIsDoseToWaterUncertaintyImageEnabled) mDoseToWaterImage.EnableSquaredImage(true);
     mDoseToWaterImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
+    mDoseToWaterImage.EnableSparseStorage(mIsSparseStorageEnabled);
     mDoseToWaterImage.Allocate();
     mDoseToWaterImage.SetFilename(mDoseToWaterFilename);
   }
@@ -262,65 +282,39 @@ void GateDoseActor::Construct() {
     // Force the computation of squared image if uncertainty is enabled
     if (mIsDoseToOtherMaterialUncertaintyImageEnabled) mDoseToOtherMaterialImage.EnableSquaredImage(true);
     mDoseToOtherMaterialImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
+    mDoseToOtherMaterialImage.EnableSparseStorage(mIsSparseStorageEnabled);
     mDoseToOtherMaterialImage.Allocate();
     mDoseToOtherMaterialImage.SetFilename(mDoseToOtherMaterialFilename);
   }
   //Efficiency option
-  if (mIsDoseEfficiencyEnabled){
-    std::ifstream inFile(mDoseEfficiencyFile);
-    if (! inFile) {
-      GateError("Cannot open dose efficiency file!");
-    }
-    std::vector<double> mDoseEfficiencyParameters;
-    std::string line;
-    int lineno = 0;
-    int NbLines = ParseNextContentLine<int,1>(inFile,lineno,mDoseEfficiencyFile)[0];
-    //   std::cout<<NbLines<<std::endl;
-    for (int k = 0; k < NbLines; k++) {
-      //    std::cout<<k<<std::endl;
-      mDoseEfficiencyParameters = ParseNextContentLine<double,2>(inFile,lineno,mDoseEfficiencyFile);
-      mDoseEnergy.push_back(mDoseEfficiencyParameters[0]);
-      mDoseEfficiency.push_back(mDoseEfficiencyParameters[1]);
-      GateMessage("Actor", 5, "[DoseActor] mDoseEfficiencyParameters: "<<mDoseEfficiencyParameters[0]<<"\t"<<mDoseEfficiencyParameters[1]<< Gateendl);
-      if (k>0 && mDoseEnergy[k]<mDoseEnergy[k-1]){GateError("The energies of the Efficiency file must be ordered from lowest to highest - simulation abort!");}
+  if (mIsDoseEfficiencyEnabled) mDoseEfficiencyCurve.Read(mDoseEfficiencyFile);
+  //Efficiency option by Z (by ion atomic number)
+  if (mIsDoseEfficiencyByZEnabled) {
+    mDoseEfficiencyCurvesByZ.resize(mDoseEfficiencyFileByZ.size());
+    for (unsigned int i=0; i<mDoseEfficiencyFileByZ.size(); i++)
+      mDoseEfficiencyCurvesByZ[i].Read(mDoseEfficiencyFileByZ[i]);
+    // Curves are indexed by the (integer) charge of the particle. When the
+    // same Z is given several times, the first one is used. Without any
+    // curve, no Z is found and no efficiency is applied.
+    mDoseEfficiencyCurveIndexByZ.clear();
+    if (!mDoseZByZ.empty()) {
+      mDoseEfficiencyMinZ = *std::min_element(mDoseZByZ.begin(), mDoseZByZ.end());
+      int maxZ = *std::max_element(mDoseZByZ.begin(), mDoseZByZ.end());
+      mDoseEfficiencyCurveIndexByZ.assign(maxZ-mDoseEfficiencyMinZ+1, -1);
+      for (unsigned int i=0; i<mDoseZByZ.size(); i++) {
+        int & index = mDoseEfficiencyCurveIndexByZ[mDoseZByZ[i]-mDoseEfficiencyMinZ];
+        if (index < 0) index = i;
+      }
     }
-    GateMessage("Actor", 0, "[DoseActor] : "<<mDoseEfficiencyFile<<" loaded successfully!"<< Gateendl);
   }
-  //Efficiency option by Z (by ion atomic number)
-    if (mIsDoseEfficiencyByZEnabled){
-		std::ifstream inFile;
-		std::vector<double> mDoseEfficiencyParameters;
-		std::string line;
-		double previousEnergy=0;
-		int lineno = 0;
-		int NbLines = 0;
-		for (unsigned int i=0; i<mDoseEfficiencyFileByZ.size(); i++){
-			std::vector<double> EnergyTemp;
-			std::vector<double> EfficiencyTemp;
-			inFile.open(mDoseEfficiencyFileByZ.at(i));
-			if (! inFile) {
-				GateError("Cannot open dose efficiency file! "<<mDoseEfficiencyFileByZ.at(i)<<Gateendl);
-				}
-			NbLines = ParseNextContentLine<int,1>(inFile,lineno,mDoseEfficiencyFileByZ.at(i))[0];
-			for (int k = 0; k < NbLines; k++) {
-			  if (k>0) {previousEnergy=mDoseEfficiencyParameters[0];}
-			  mDoseEfficiencyParameters = ParseNextContentLine<double,2>(inFile,lineno,mDoseEfficiencyFileByZ.at(i));
-			  EnergyTemp.push_back(mDoseEfficiencyParameters[0]);
-			  EfficiencyTemp.push_back(mDoseEfficiencyParameters[1]);
-			  GateMessage("Actor", 5, "[DoseActor] mDoseEfficiencyParameters: "<<mDoseEfficiencyParameters[0]<<"\t"<<mDoseEfficiencyParameters[1]<< Gateendl);
-			  if (k>0 && mDoseEfficiencyParameters[0]<previousEnergy){GateError("The energies of the Efficiency file must be ordered from lowest to highest - simulation abort!");}
-			}
-			mDoseEnergyByZ.push_back(EnergyTemp);
-			mDoseEfficiencyByZ.push_back(EfficiencyTemp);
-			GateMessage("Actor", 0, "[DoseActor] : "<<mDoseEfficiencyFileByZ.at(i)<<" loaded successfully!"<< Gateendl);
-			inFile.close();
-		}
-	}
-  
+
   //HIT
   if (mIsNumberOfHitsImageEnabled) {
     mNumberOfHitsImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
     mNumberOfHitsImage.Allocate();
+#ifdef GATE_USE_MT
+    mIsNumberOfHitsTrackingEnabled = G4Threading::IsWorkerThread();
+#endif
   }
 
   if (mIsDoseImageEnabled &&
@@ -348,6 +342,12 @@ void GateDoseActor::Construct() {
       GateWarning("importMassImage command is only compatible with MassWeighting algorithm. Ignored. ");
   }
 
+  mStepFilter.Initialize("DoseActor " + GetObjectName(), mVolumeFilter, mMaterialFilter);
+  if (mDoseAlgorithmType == "MassWeighting" || mStepFilter.IsEnabled())
+    pUserSteppingActionInVoxel = &GateDoseActor::UserSteppingActionInVoxelT<true>;
+  else
+    pUserSteppingActionInVoxel = &GateDoseActor::UserSteppingActionInVoxelT<false>;
+
   if (mDoseByRegionsFlag) {
     if(mDoseByRegionsInputFilename == "")
       {
@@ -426,7 +426,9 @@ void GateDoseActor::SaveData() {
   }
 
   if (mIsLastHitEventImageEnabled) {
-    mLastHitEventImage.Fill(-1); // reset
+    // reset
+    if (mIsSparseStorageEnabled) mSparseLastHitEventImage.Clear();
+    else mLastHitEventImage.Fill(-1);
   }
 
   if (mIsNumberOfHitsImageEnabled) {
@@ -480,12 +482,53 @@ void GateDoseActor::SaveData() {
 
 //-----------------------------------------------------------------------------
 void GateDoseActor::ResetData() {
-  if (mIsLastHitEventImageEnabled) mLastHitEventImage.Fill(-1);
+  if (mIsLastHitEventImageEnabled) {
+    if (mIsSparseStorageEnabled) mSparseLastHitEventImage.Clear();
+    else mLastHitEventImage.Fill(-1);
+  }
   if (mIsEdepImageEnabled) mEdepImage.Reset();
   if (mIsDoseImageEnabled) mDoseImage.Reset();
   if (mIsDoseToWaterImageEnabled) mDoseToWaterImage.Reset();
   if (mIsDoseToOtherMaterialImageEnabled) mDoseToOtherMaterialImage.Reset();
-  if (mIsNumberOfHitsImageEnabled) mNumberOfHitsImage.Fill(0);
+  if (mIsNumberOfHitsImageEnabled) {
+    mNumberOfHitsImage.Fill(0);
+    mNumberOfHitsTouchedVoxels.clear();
+  }
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateDoseActor::MergeDataFrom(GateVActor * workerActor) {
+  GateDoseActor * worker = dynamic_cast<GateDoseActor*>(workerActor);
+  if (mDoseByRegionsFlag)
+    GateError("The DoseActor " << GetObjectName() << ": dose by regions is not supported in multithreaded mode yet.");
+
+  if (mIsEdepImageEnabled) mEdepImage.Merge(worker->mEdepImage);
+  if (mIsDoseImageEnabled) mDoseImage.Merge(worker->mDoseImage);
+  if (mIsDoseToWaterImageEnabled) mDoseToWaterImage.Merge(worker->mDoseToWaterImage);
+  if (mIsDoseToOtherMaterialImageEnabled) mDoseToOtherMaterialImage.Merge(worker->mDoseToOtherMaterialImage);
+  if (mIsNumberOfHitsImageEnabled) {
+    if (worker->mIsNumberOfHitsTrackingEnabled) {
+      // Only the voxels hit since the last merge are visited and cleared
+      for(unsigned int i=0; i<worker->mNumberOfHitsTouchedVoxels.size(); i++) {
+        const int index = worker->mNumberOfHitsTouchedVoxels[i];
+        mNumberOfHitsImage.AddValue(index, worker->mNumberOfHitsImage.GetValue(index));
+        worker->mNumberOfHitsImage.SetValue(index, 0);
+      }
+      worker->mNumberOfHitsTouchedVoxels.clear();
+    }
+    else {
+      mNumberOfHitsImage.MergeDataByAddition(worker->mNumberOfHitsImage);
+      worker->mNumberOfHitsImage.Fill(0);
+    }
+  }
+
+  // Number of events used for the uncertainty is the total over all
+  // threads. The worker event counter is kept (it is compared to
+  // mLastHitEventImage), only the events since its last merge are added.
+  mCurrentEvent += worker->mCurrentEvent - worker->mLastMergedEvent;
+  worker->mLastMergedEvent = worker->mCurrentEvent;
 }
 //-----------------------------------------------------------------------------
 
@@ -496,6 +539,37 @@ void GateDoseActor::BeginOfRunAction(const G4Run * r) {
   GateDebugMessage("Actor", 3, "GateDoseActor -- Begin of Run\n");
   mDose2WaterWarningFlag = true;
   // ResetData(); // Do no reset here !! (when multiple run);
+
+  // Stopping power ratio tables are built once the physics tables are
+  // available. Electrons (also used for gammas) and protons are built
+  // here, other particles when first seen.
+  if (mIsDoseToWaterImageEnabled)
+    InitializeStoppingPowerRatioTable(mDoseToWaterRatioTable, G4NistManager::Instance()->FindOrBuildMaterial("G4_WATER"));
+  if (mIsDoseToOtherMaterialImageEnabled) {
+    const G4Material * m = G4Material::GetMaterial(mOtherMaterial, false);
+    if (!m) {
+      //FIXME
+      //CREATE THE MISSING MATERIAL (look into the Gate db)
+      GateError("Material not defined - abort simulation");
+    }
+    mOtherMaterialDensity = m->GetDensity();
+    InitializeStoppingPowerRatioTable(mDoseToOtherMaterialRatioTable, m);
+  }
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateDoseActor::InitializeStoppingPowerRatioTable(GateStoppingPowerRatioTable & table, const G4Material * target) {
+  // Only the first run builds the tables (and checks their tolerance): the
+  // materials defined later get their tables when first seen
+  if (table.IsInitialized() && table.GetTargetMaterial() == target) return;
+  table.SetTargetMaterial(target);
+  table.SetEnergyRange(1*keV, 10*GeV, mStoppingPowerRatioTableBins);
+  table.SetTolerance(mStoppingPowerRatioTableTolerance);
+  table.Initialize(emcalc);
+  table.BuildTables(G4Electron::Electron());
+  table.BuildTables(G4Proton::Proton());
 }
 //-----------------------------------------------------------------------------
 
@@ -520,12 +594,14 @@ void GateDoseActor::UserPreTrackActionInVoxel(const int /*index*/, const G4Track
 
 
 //-----------------------------------------------------------------------------
-void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* step) {
+template<bool UseVoxelizedMass>
+void GateDoseActor::UserSteppingActionInVoxelT(const int index, const G4Step* step) {
   GateDebugMessageInc("Actor", 4, "GateDoseActor -- UserSteppingActionInVoxel - begin\n");
   GateDebugMessageInc("Actor", 4, "enedepo = " << step->GetTotalEnergyDeposit() << Gateendl);
   GateDebugMessageInc("Actor", 4, "weight = " <<  step->GetTrack()->GetWeight() << Gateendl);
   const double weight = step->GetTrack()->GetWeight();
-  const double edep = step->GetTotalEnergyDeposit()*weight;
+  // with the 'raycast' hit type, only the part of the step in this voxel
+  const double edep = step->GetTotalEnergyDeposit()*weight*mStepHitFraction;
   //current material
   G4Material * current_material = step->GetPreStepPoint()->GetMaterial();
   //Get current particle
@@ -544,16 +620,20 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
     return;
   }
 
-  if (mVolumeFilter != "" && mVolumeFilter+"_phys" != step->GetPreStepPoint()->GetPhysicalVolume()->GetName())
-    return;
-
-  if (mMaterialFilter != "" && mMaterialFilter != current_material->GetName())
+  if (UseVoxelizedMass && mStepFilter.Rejects(step->GetPreStepPoint()))
     return;
 
   // compute sameEvent
   // sameEvent is false the first time some energy is deposited for each primary particle
   bool sameEvent=true;
-  if (mIsLastHitEventImageEnabled) {
+  if (mIsLastHitEventImageEnabled && mIsSparseStorageEnabled) {
+    double * lastHitEvent = mSparseLastHitEventImage.GetValues(index);
+    if (mCurrentEvent != *lastHitEvent) {
+      sameEvent = false;
+      *lastHitEvent = mCurrentEvent;
+    }
+  }
+  else if (mIsLastHitEventImageEnabled) {
     GateDebugMessage("Actor", 2,  "GateDoseActor -- UserSteppingActionInVoxel: Last event in index = " << mLastHitEventImage.GetValue(index) << Gateendl);
     if (mCurrentEvent != mLastHitEventImage.GetValue(index)) {
       sameEvent = false;
@@ -568,11 +648,11 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
 
   //---------------------------------------------------------------------------------
   // Mass weighting OR filter
-  if (mDoseAlgorithmType == "MassWeighting" || mMaterialFilter != "" || mVolumeFilter != "")
+  if (UseVoxelizedMass)
     density = mVoxelizedMass.GetDoselMass(index)/mDoseImage.GetVoxelVolume();
   //---------------------------------------------------------------------------------
 
-  if (mMaterialFilter != "") {
+  if (UseVoxelizedMass && mStepFilter.HasMaterialFilter()) {
     GateDebugMessage("Actor", 3,  "GateDoseActor -- UserSteppingActionInVoxel: material filter debug = " << Gateendl
                      << " material name        = " << step->GetPreStepPoint()->GetMaterial()->GetName() << Gateendl
                      << " density              = " << G4BestUnit(mVoxelizedMass.GetPartialMassWithMatName(index)/mVoxelizedMass.GetDoselVolume(), "Volumic Mass") << Gateendl
@@ -580,7 +660,7 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
                      << " partial cubic volume = " << G4BestUnit(mVoxelizedMass.GetDoselVolume(), "Volume") << Gateendl);
   }
 
-  if (mVolumeFilter != "") {
+  if (UseVoxelizedMass && mStepFilter.HasVolumeFilter()) {
     GateDebugMessage("Actor", 3,  "GateDoseActor -- UserSteppingActionInVoxel: volume filter debug = " << Gateendl
                      << " volume name          = " << step->GetPreStepPoint()->GetPhysicalVolume()->GetName() << Gateendl
                      << " Dose scored inside volume filtered volume !" << Gateendl);
@@ -623,16 +703,7 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
 
   //Efficiency
     if(mIsDoseEfficiencyEnabled){
-      double efficiency=1;
-      for (unsigned int k=0; k<mDoseEnergy.size(); k++){
-        if(mDoseEnergy[k]>energy){
-          efficiency=mDoseEfficiency[k-1]+(mDoseEfficiency[k]-mDoseEfficiency[k-1])/(mDoseEnergy[k]-mDoseEnergy[k-1])*(energy-mDoseEnergy[k-1]);
-          k=mDoseEnergy.size();
-        }
-        else if(k==mDoseEnergy.size()-1){
-          GateMessage("Actor", 0, "WARNING particle energy larger than energies available in the file: "<<mDoseEfficiencyFile<<" Efficiency = 1 instead"<<Gateendl);
-        }
-      }
+      double efficiency = mDoseEfficiencyCurve.GetEfficiency(energy);
       if(mTestFlag){
         G4double dedx = emcalc->ComputeElectronicDEDX(energy, p, current_material);
         G4cout<<"Particle : "<<p->GetParticleName()<<"\t energy : "<<energy<<"\t material : "<<current_material->GetName()<<"\t dedx : "<<dedx<<"\t efficiency : "<<efficiency<<"\t dose : "<<dose;
@@ -641,34 +712,24 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
       if(mTestFlag){G4cout<<"\t effective dose : "<<dose<<G4endl;}
     }
   //Efficiency option by Z (by ion atomic number)
-    if(mIsDoseEfficiencyByZEnabled){		
-          if (p->GetPDGCharge()!=0){
-		    for (unsigned i=0; i<mDoseZByZ.size(); i++){
-				//check that the current atomic number found belongs to one in the table
-				if (mDoseZByZ.at(i)==p->GetPDGCharge()) {
-				  double efficiency=1;
-				  for (unsigned int k=0; k<mDoseEnergyByZ[i].size(); k++){
-					if(mDoseEnergyByZ[i][k]>energy){
-					  efficiency=mDoseEfficiencyByZ[i][k-1]+(mDoseEfficiencyByZ[i][k]-mDoseEfficiencyByZ[i][k-1])/(mDoseEnergyByZ[i][k]-mDoseEnergyByZ[i][k-1])*(energy-mDoseEnergyByZ[i][k-1]);
-					  k=mDoseEnergyByZ[i].size();
-					}
-					else if(k==mDoseEnergyByZ[i].size()-1){
-					  GateMessage("Actor", 0, "WARNING particle energy larger than energies available in the file: "<<mDoseEfficiencyFileByZ.at(i)<<" Efficiency = 1 instead"<<Gateendl);
-					}
-				  }
-				  if(mTestFlag){
-					G4double dedx = emcalc->ComputeElectronicDEDX(energy, p, current_material);
-					G4cout<<"Particle : "<<p->GetParticleName()<<"\t energy : "<<energy<<"\t material : "<<current_material->GetName()<<"\t dedx : "<<dedx<<"\t efficiency : "<<efficiency<<"\t dose : "<<dose;
-				  }
-				  dose*=efficiency;
-				  if(mTestFlag){G4cout<<"\t effective dose : "<<dose<<G4endl;}
-				  i = mDoseZByZ.size();
-					;}
-				else {;}
-		  }
-	  }
+    if(mIsDoseEfficiencyByZEnabled){
+      const double charge = p->GetPDGCharge();
+      const int z = static_cast<int>(charge);
+      const int iz = z - mDoseEfficiencyMinZ;
+      //check that the current atomic number found belongs to one in the table
+      if (charge != 0 && z == charge && iz >= 0 &&
+          iz < static_cast<int>(mDoseEfficiencyCurveIndexByZ.size()) &&
+          mDoseEfficiencyCurveIndexByZ[iz] >= 0) {
+        double efficiency = mDoseEfficiencyCurvesByZ[mDoseEfficiencyCurveIndexByZ[iz]].GetEfficiency(energy);
+        if(mTestFlag){
+          G4double dedx = emcalc->ComputeElectronicDEDX(energy, p, current_material);
+          G4cout<<"Particle : "<<p->GetParticleName()<<"\t energy : "<<energy<<"\t material : "<<current_material->GetName()<<"\t dedx : "<<dedx<<"\t efficiency : "<<efficiency<<"\t dose : "<<dose;
+        }
+        dose*=efficiency;
+        if(mTestFlag){G4cout<<"\t effective dose : "<<dose<<G4endl;}
+      }
     }
-    
+
     GateDebugMessage("Actor", 2,  "GateDoseActor -- UserSteppingActionInVoxel:\tdose = "
                      << G4BestUnit(dose, "Dose")
                      << " rho = "
@@ -680,59 +741,15 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
   double doseToWater = 0;
   if (mIsDoseToWaterImageEnabled)
     {
-      double cut =  DBL_MAX;
-      // dedx
-      double DEDX=0, DEDX_Water=0;
-      //other material
-      static G4Material * water = G4NistManager::Instance()->FindOrBuildMaterial("G4_WATER");
-
-
       //Accounting for particles with dedx=0; i.e. gamma and neutrons
       //For gamma we consider the dedx of electrons instead - testing with 1.3 MeV photon beam or 150 MeV protons or 1500 MeV carbon ion beam showed that the error induced is 0
       //		when comparing dose and dosetowater in the material G4_WATER
       //For neutrons the dose is neglected - testing with 1.3 MeV photon beam or 150 MeV protons or 1500 MeV carbon ion beam showed that the error induced is < 0.01%
       //		when comparing dose and dosetowater in the material G4_WATER (we are systematically missing a little bit of dose of course with this solution)
-      if (p == G4Gamma::Gamma())  p = G4Electron::Electron();
-      DEDX = emcalc->ComputeTotalDEDX(energy, p, current_material, cut);
-      DEDX_Water = emcalc->ComputeTotalDEDX(energy, p, water, cut);
-      //In current implementation, dose deposited directly by neutrons is neglected - the below lines prevent "inf or NaN"
-      if (DEDX==0 || DEDX_Water==0){
-      	doseToWater=0;
-      }
-      else{
-        doseToWater = dose*(DEDX_Water/1.0)/(DEDX/(density*e_SI));
-      }
-
-//G4cout<<"Dose To Water " << doseToWater << G4endl;
-
-      //------------------------------------
-      //Alternative way of converting dose to water is to keep the dose from particles having dedx=0 equal to the dedx of electrons
-      //------------------------------------
-      /*
-      //if calculation for a given particle does not work using DEDX (neutron etc, use an electron instead)
-      if(DEDX == 0) {
-      DEDX = emcalc->ComputeTotalDEDX(energy, G4Electron::Electron(), current_material, cut);
-      DEDX_Water = emcalc->ComputeTotalDEDX(energy, G4Electron::Electron(), water, cut);
-      }
-
-      if (DEDX_Water == 0 or DEDX == 0)
-      {
-      doseToWater = 0.0; // to avoid inf or NaN
-      GateWarning("DEDX = 0 in doseToWater, Edep ommited");
-      G4cout<<"PartName: "<< p->GetParticleName()<<" Edep: "<<edep/gray<<G4endl;
-      doseToWater = 0.0;
-      }
-      else doseToWater = edep/density/volume/gray*(DEDX_Water/1.0)/(DEDX/(density*e_SI));
-      //~ else {
-      //~ if (mDose2WaterWarningFlag) {
-      //~ GateMessage("Actor", 0, "WARNING: DoseToWater with a particle which is not proton/electron/positron/gamma/deuteron: results could be wrong." << G4endl);
-      //~
-      //~ mDose2WaterWarningFlag = false;
-      //~ }
-
-      //~ }
-      //~ else	doseToWater=dose;
-      */
+      const G4ParticleDefinition * pw = (p == G4Gamma::Gamma() ? G4Electron::Electron() : p);
+      // DEDX_Water/DEDX, 0 if one of them is 0 (prevents "inf or NaN")
+      double ratio = mDoseToWaterRatioTable.GetRatio(pw, current_material, energy);
+      doseToWater = dose*ratio*(density*e_SI);
 
       GateDebugMessage("Actor", 2,  "GateDoseActor -- UserSteppingActionInVoxel:\tdose to water = "
                        << G4BestUnit(doseToWater, "Dose to water")
@@ -743,27 +760,8 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
   //DoseToOtherMaterial
   double DoseToOtherMaterial = 0;
   if (mIsDoseToOtherMaterialImageEnabled){
-    double cut = DBL_MAX;
-    G4String material;
-    const G4MaterialTable* matTbl = G4Material::GetMaterialTable();
-    bool IsMaterialInMDB = false;
-    double Density_OtherMaterial = 1;
-
-    // check if the material has already been created in the simulation
-    for(size_t k=0; k < G4Material::GetNumberOfMaterials(); k++){
-      material = (*matTbl)[k]->GetName();
-      if(material==mOtherMaterial){
-        IsMaterialInMDB=true;
-        Density_OtherMaterial = (*matTbl)[k]->GetDensity();
-        k=G4Material::GetNumberOfMaterials();
-      }
-    }
-    // create the material if not already created in the simulation
-    if(!IsMaterialInMDB){
-      //FIXME
-      //CREATE THE MISSING MATERIAL (look into the Gate db)
-      GateError("Material not defined - abort simulation");
-    }
+    // the material has been checked at begin of run
+    double Density_OtherMaterial = mOtherMaterialDensity;
 
 
     //deterimine density ratio for dose to other material
@@ -771,20 +769,16 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
     double densityRatio=	density/current_material->GetDensity();
     Density_OtherMaterial/=densityRatio;
 
-    // dedx
-    double DEDX=0, DEDX_OtherMaterial=0;
     //current material
     double current_density = density;
 
-    //other material
-    static G4Material* OtherMaterial = G4Material::GetMaterial(mOtherMaterial,true);
-
-
     if(mTestFlag){
       // DISPLAY parameters of particles having DEDX=0
       // Mainly gamma and neutron
-      DEDX = emcalc->ComputeTotalDEDX(energy, p, current_material, cut);
-      DEDX_OtherMaterial = emcalc->ComputeTotalDEDX(energy, p, OtherMaterial, cut);
+      const double cut = DBL_MAX;
+      const G4Material * OtherMaterial = mDoseToOtherMaterialRatioTable.GetTargetMaterial();
+      double DEDX = emcalc->ComputeTotalDEDX(energy, p, current_material, cut);
+      double DEDX_OtherMaterial = emcalc->ComputeTotalDEDX(energy, p, OtherMaterial, cut);
       if(DEDX==0){
         G4cout<<"Particle : "<<p->GetParticleName()<<"\t energy : "<<energy<<"\t current material : "<<current_material->GetName()<<"\t dedx : "<<DEDX<<"\t density : "<<current_density*e_SI<<"\t dose : "<<dose<<G4endl;
         G4cout<<"Particle : "<<p->GetParticleName()<<"\t energy : "<<energy<<"\t other material : "<<mOtherMaterial<<"\t dedx other : "<<DEDX_OtherMaterial<<"\t density other : "<<Density_OtherMaterial*e_SI<<"\t dose to other: "<<DoseToOtherMaterial<<G4endl;
@@ -804,15 +798,9 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
     //For neutrons the dose is neglected - testing with 1.3 MeV photon beam or 150 MeV protons or 1500 MeV carbon ion beam showed that the error induced is < 0.01%
     //		we are systematically missing a little bit of dose of course with this solution
     if (p == G4Gamma::Gamma())  p = G4Electron::Electron();
-    DEDX = emcalc->ComputeTotalDEDX(energy, p, current_material, cut);
-    DEDX_OtherMaterial = emcalc->ComputeTotalDEDX(energy, p, OtherMaterial, cut);
-    //In current implementation, dose deposited directly by neutrons is neglected - the below lines prevent "inf or NaN"
-    if (DEDX==0 || DEDX_OtherMaterial==0){
-      DoseToOtherMaterial=0;
-    }
-    else{
-      DoseToOtherMaterial = dose*(DEDX_OtherMaterial/(Density_OtherMaterial*e_SI))/(DEDX/(current_density*e_SI));
-    }
+    // DEDX_OtherMaterial/DEDX, 0 if one of them is 0 (prevents "inf or NaN")
+    double ratio = mDoseToOtherMaterialRatioTable.GetRatio(p, current_material, energy);
+    DoseToOtherMaterial = dose*ratio*(current_density*e_SI)/(Density_OtherMaterial*e_SI);
 
     GateDebugMessage("Actor", 2,  "GateDoseActor -- UserSteppingActionInVoxel:\tdose to OtherMaterial = "
                      << G4BestUnit(DoseToOtherMaterial, "Dose to OtherMaterial")
@@ -868,7 +856,12 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
       else mDoseToOtherMaterialImage.AddValue(index, DoseToOtherMaterial);
     }
 
-  if (mIsNumberOfHitsImageEnabled) mNumberOfHitsImage.AddValue(index, weight);
+  if (mIsNumberOfHitsImageEnabled) {
+    const bool firstHit = (mNumberOfHitsImage.GetValue(index) == 0);
+    mNumberOfHitsImage.AddValue(index, weight);
+    if (mIsNumberOfHitsTrackingEnabled && firstHit && mNumberOfHitsImage.GetValue(index) != 0)
+      mNumberOfHitsTouchedVoxels.push_back(index);
+  }
 
   //Dose regions
   if (mDoseByRegionsFlag) {
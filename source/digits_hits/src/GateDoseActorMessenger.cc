@@ -42,8 +42,11 @@ GateDoseActorMessenger::GateDoseActorMessenger(GateDoseActor* sensor)
   pEnableDoseToOtherMaterialNormToIntegralCmd= 0;
   pEnableDoseToOtherMaterialSquaredCmd= 0;
   pEnableDoseToOtherMaterialUncertaintyCmd= 0;
+  pSetStoppingPowerRatioTableBinsCmd= 0;
+  pSetStoppingPowerRatioTableToleranceCmd= 0;
   //Others
   pEnableNumberOfHitsCmd= 0;
+  pEnableSparseStorageCmd= 0;
   pSetDoseAlgorithmCmd= 0;
   pImportMassImageCmd= 0;
   pExportMassImageCmd= 0;
@@ -88,8 +91,11 @@ GateDoseActorMessenger::~GateDoseActorMessenger()
   if(pEnableDoseToOtherMaterialSquaredCmd) delete pEnableDoseToOtherMaterialSquaredCmd;
   if(pEnableDoseToOtherMaterialUncertaintyCmd) delete pEnableDoseToOtherMaterialUncertaintyCmd;
   if(pSetOtherMaterialCmd) delete pSetOtherMaterialCmd;
+  if(pSetStoppingPowerRatioTableBinsCmd) delete pSetStoppingPowerRatioTableBinsCmd;
+  if(pSetStoppingPowerRatioTableToleranceCmd) delete pSetStoppingPowerRatioTableToleranceCmd;
   //Others
   if(pEnableNumberOfHitsCmd) delete pEnableNumberOfHitsCmd;
+  if(pEnableSparseStorageCmd) delete pEnableSparseStorageCmd;
   if(pSetDoseAlgorithmCmd) delete pSetDoseAlgorithmCmd;
   if(pImportMassImageCmd) delete pImportMassImageCmd;
   if(pExportMassImageCmd) delete pExportMassImageCmd;
@@ -205,6 +211,18 @@ void GateDoseActorMessenger::BuildCommands(G4String base)
   pSetOtherMaterialCmd = new G4UIcmdWithAString(n, this);
   guid = G4String("Set Other Material Name");
   pSetOtherMaterialCmd->SetGuidance(guid);
+  n = base+"/setStoppingPowerRatioTableBins";
+  pSetStoppingPowerRatioTableBinsCmd = new G4UIcmdWithAnInteger(n, this);
+  guid = G4String("Set the number of log-energy bins (1 keV to 10 GeV) of the stopping power ratio tables used for dose to water/other material (0 = exact computation at each step, default 400)");
+  pSetStoppingPowerRatioTableBinsCmd->SetGuidance(guid);
+  pSetStoppingPowerRatioTableBinsCmd->SetParameterName("Bins",false);
+  pSetStoppingPowerRatioTableBinsCmd->SetRange("Bins>=0");
+  n = base+"/setStoppingPowerRatioTableTolerance";
+  pSetStoppingPowerRatioTableToleranceCmd = new G4UIcmdWithADouble(n, this);
+  guid = G4String("Warn if the relative error of the stopping power ratio tables, checked against the exact value, is larger than this tolerance (0 = no check, default 1e-3)");
+  pSetStoppingPowerRatioTableToleranceCmd->SetGuidance(guid);
+  pSetStoppingPowerRatioTableToleranceCmd->SetParameterName("Tolerance",false);
+  pSetStoppingPowerRatioTableToleranceCmd->SetRange("Tolerance>=0");
 
   //Others
   n = base+"/enableNumberOfHits";
@@ -212,6 +230,11 @@ void GateDoseActorMessenger::BuildCommands(G4String base)
   guid = G4String("Enable number of hits computation");
   pEnableNumberOfHitsCmd->SetGuidance(guid);
 
+  n = base+"/enableSparseStorage";
+  pEnableSparseStorageCmd = new G4UIcmdWithABool(n, this);
+  guid = G4String("Store edep/dose images (and their squared/uncertainty) by blocks of 8x8x8 voxels allocated when first reached, dense images are only built when saving (large grids mostly empty)");
+  pEnableSparseStorageCmd->SetGuidance(guid);
+
   n = base+"/setDoseAlgorithm";
   pSetDoseAlgorithmCmd = new G4UIcmdWithAString(n, this);
   guid = G4String("Set the alogrithm used in the dose calculation");
@@ -300,8 +323,11 @@ void GateDoseActorMessenger::SetNewValue(G4UIcommand* cmd, G4String newValue)
   if (cmd == pEnableDoseToOtherMaterialNormToMaxCmd) pDoseActor->EnableDoseToOtherMaterialNormalisationToMax(pEnableDoseToOtherMaterialNormToMaxCmd->GetNewBoolValue(newValue));
   if (cmd == pEnableDoseToOtherMaterialNormToIntegralCmd) pDoseActor->EnableDoseToOtherMaterialNormalisationToIntegral(pEnableDoseToOtherMaterialNormToIntegralCmd->GetNewBoolValue(newValue));
   if (cmd == pSetOtherMaterialCmd) pDoseActor->SetOtherMaterial(newValue);
+  if (cmd == pSetStoppingPowerRatioTableBinsCmd) pDoseActor->SetStoppingPowerRatioTableBins(pSetStoppingPowerRatioTableBinsCmd->GetNewIntValue(newValue));
+  if (cmd == pSetStoppingPowerRatioTableToleranceCmd) pDoseActor->SetStoppingPowerRatioTableTolerance(pSetStoppingPowerRatioTableToleranceCmd->GetNewDoubleValue(newValue));
   //Others
   if (cmd == pEnableNumberOfHitsCmd) pDoseActor->EnableNumberOfHitsImage(pEnableNumberOfHitsCmd->GetNewBoolValue(newValue));
+  if (cmd == pEnableSparseStorageCmd) pDoseActor->EnableSparseStorage(pEnableSparseStorageCmd->GetNewBoolValue(newValue));
   if (cmd == pSetDoseAlgorithmCmd) pDoseActor->SetDoseAlgorithmType(newValue);
   if (cmd == pImportMassImageCmd) pDoseActor->ImportMassImage(newValue);
   if (cmd == pExportMassImageCmd) pDoseActor->ExportMassImage(newValue);
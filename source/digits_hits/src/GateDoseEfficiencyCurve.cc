@@ -0,0 +1,71 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+#include "GateDoseEfficiencyCurve.hh"
+#include "GateMiscFunctions.hh"
+#include "GateMessageManager.hh"
+
+#include <fstream>
+
+//-----------------------------------------------------------------------------
+GateDoseEfficiencyCurve::GateDoseEfficiencyCurve()
+{
+  mLastBin = 0;
+  mIsAboveRangeWarningDone = false;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateDoseEfficiencyCurve::Read(G4String filename)
+{
+  mFilename = filename;
+  mEnergy.clear();
+  mEfficiency.clear();
+  mSlope.clear();
+  mLastBin = 0;
+  mIsAboveRangeWarningDone = false;
+
+  std::ifstream inFile(filename);
+  if (! inFile) {
+    GateError("Cannot open dose efficiency file! " << filename << Gateendl);
+  }
+  int lineno = 0;
+  int NbLines = ParseNextContentLine<int,1>(inFile,lineno,filename)[0];
+  if (NbLines < 1) {
+    GateError("The efficiency file " << filename << " must contain at least one point - simulation abort!");
+  }
+  for (int k = 0; k < NbLines; k++) {
+    std::vector<double> parameters = ParseNextContentLine<double,2>(inFile,lineno,filename);
+    mEnergy.push_back(parameters[0]);
+    mEfficiency.push_back(parameters[1]);
+    GateMessage("Actor", 5, "[DoseActor] mDoseEfficiencyParameters: "<<parameters[0]<<"\t"<<parameters[1]<< Gateendl);
+    if (k>0 && mEnergy[k]<mEnergy[k-1]){GateError("The energies of the Efficiency file must be ordered from lowest to highest - simulation abort!");}
+  }
+
+  // Slopes are precomputed, the interpolation is then a single multiply-add
+  mSlope.resize(mEnergy.size(), 0.0);
+  for (size_t k = 0; k+1 < mEnergy.size(); k++) {
+    double dE = mEnergy[k+1]-mEnergy[k];
+    if (dE > 0) mSlope[k] = (mEfficiency[k+1]-mEfficiency[k])/dE;
+  }
+  GateMessage("Actor", 0, "[DoseActor] : "<<filename<<" loaded successfully!"<< Gateendl);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+double GateDoseEfficiencyCurve::GetEfficiencyAboveLastPoint()
+{
+  if (!mIsAboveRangeWarningDone) {
+    GateMessage("Actor", 0, "WARNING particle energy larger than energies available in the file: "<<mFilename<<" Efficiency = 1 instead"<<Gateendl);
+    mIsAboveRangeWarningDone = true;
+  }
+  return 1.0;
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,47 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See LICENSE.md for further details
+----------------------*/
+
+#include "GateDoseStepFilter.hh"
+#include "GateMessageManager.hh"
+
+#include <G4Material.hh>
+#include <G4PhysicalVolumeStore.hh>
+
+//-----------------------------------------------------------------------------
+GateDoseStepFilter::GateDoseStepFilter()
+  : mHasVolumeFilter(false), mHasMaterialFilter(false), mMaterial(0)
+{}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateDoseStepFilter::Initialize(const G4String& actorName, const G4String& volumeName, const G4String& materialName)
+{
+  mHasVolumeFilter = (volumeName != "");
+  mVolumes.clear();
+  if (mHasVolumeFilter) {
+    G4PhysicalVolumeStore * store = G4PhysicalVolumeStore::GetInstance();
+    for (size_t i=0; i<store->size(); i++)
+      if ((*store)[i]->GetName() == volumeName+"_phys")
+        mVolumes.push_back((*store)[i]);
+    if (mVolumes.empty())
+      GateWarning(actorName << ": volume filter '" << volumeName
+                  << "' does not match any volume, no dose will be scored.");
+  }
+
+  // a material not (yet) defined never matches
+  mHasMaterialFilter = (materialName != "");
+  mMaterial = 0;
+  if (mHasMaterialFilter) {
+    mMaterial = G4Material::GetMaterial(materialName, false);
+    if (!mMaterial)
+      GateWarning(actorName << ": material filter '" << materialName
+                  << "' does not match any material, no dose will be scored.");
+  }
+}
+//-----------------------------------------------------------------------------
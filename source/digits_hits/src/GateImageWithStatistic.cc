@@ -14,6 +14,8 @@
 #include "GateImageWithStatistic.hh"
 #include "GateMessageManager.hh"
 #include "GateMiscFunctions.hh"
+#include "GateConfiguration.h"
+#include "G4Threading.hh"
 
 //-----------------------------------------------------------------------------
 /// Constructor
@@ -24,6 +26,8 @@ GateImageWithStatistic::GateImageWithStatistic()  {
   mOverWriteFilesFlag = true;
   mNormalizedToMax = false;
   mNormalizedToIntegral = false;
+  mIsTouchedVoxelsTrackingEnabled = false;
+  mIsSparseStorageEnabled = false;
 }
 //-----------------------------------------------------------------------------
 
@@ -127,6 +131,15 @@ void GateImageWithStatistic::SetResolutionAndHalfSizeCylinder(const G4ThreeVecto
 
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::Allocate() {
+  if (mIsSparseStorageEnabled) {
+    // Blocks are allocated on first touch, they also are the list of
+    // touched voxels used by Merge
+    mValueImage.Deallocate();
+    bool withSquared = (mIsSquaredImageEnabled || mIsUncertaintyImageEnabled);
+    mSparseImage.SetLayout(mValueImage, withSquared ? 3 : 1);
+    mIsTouchedVoxelsTrackingEnabled = false;
+    return;
+  }
   mValueImage.Allocate();
   if (mIsUncertaintyImageEnabled) {
     mUncertaintyImage.Allocate();
@@ -142,12 +155,29 @@ void GateImageWithStatistic::Allocate() {
     if (mIsValuesMustBeScaled) mScaledSquaredImage.Allocate();
   }
   if (mIsValuesMustBeScaled) mScaledValueImage.Allocate();
+#ifdef GATE_USE_MT
+  // Worker images are merged (sparsely) into the master images
+  if (G4Threading::IsWorkerThread()) EnableTouchedVoxelsTracking(true);
+#endif
+  if (mIsTouchedVoxelsTrackingEnabled) {
+    mTouchedVoxelsMask.assign(mValueImage.GetNumberOfValues(), false);
+    mTouchedVoxels.clear();
+  }
 }
 //-----------------------------------------------------------------------------
 
 
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::Reset(double val) {
+  if (mIsSparseStorageEnabled) {
+    mSparseImage.Clear();
+    mSparseImage.SetBackgroundValue(ValueChannel, val);
+    if (mIsSquaredImageEnabled || mIsUncertaintyImageEnabled) {
+      mSparseImage.SetBackgroundValue(SquaredChannel, val*val);
+      mSparseImage.SetBackgroundValue(TempChannel, 0.0);
+    }
+    return;
+  }
   mValueImage.Fill(val);
   if (mIsUncertaintyImageEnabled) {
     mUncertaintyImage.Fill(0.0);
@@ -163,12 +193,31 @@ void GateImageWithStatistic::Reset(double val) {
     if (mIsValuesMustBeScaled) mScaledSquaredImage.Fill(0.0);
   }
   if (mIsValuesMustBeScaled) mScaledValueImage.Fill(0.0);
+  if (mIsTouchedVoxelsTrackingEnabled) ResetTouchedVoxels();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateImageWithStatistic::ResetTouchedVoxels() {
+  for(unsigned int i=0; i<mTouchedVoxels.size(); i++)
+    mTouchedVoxelsMask[mTouchedVoxels[i]] = false;
+  mTouchedVoxels.clear();
 }
 //-----------------------------------------------------------------------------
 
 
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::Fill(double value) {
+  if (mIsSparseStorageEnabled) {
+    const int n = mSparseImage.GetNumberOfChannels();
+    mSparseImage.SetBackgroundValue(ValueChannel, value);
+    for(size_t b=0; b<mSparseImage.GetNumberOfAllocatedBlocks(); b++) {
+      double * p = mSparseImage.GetBlockValues(b);
+      for(int v=0; v<GateBlockSparseImage::kBlockNumberOfVoxels; v++) p[v*n+ValueChannel] = value;
+    }
+    return;
+  }
   mValueImage.Fill(value);
 }
 //-----------------------------------------------------------------------------
@@ -176,6 +225,10 @@ void GateImageWithStatistic::Fill(double value) {
 
 //-----------------------------------------------------------------------------
 double GateImageWithStatistic::GetValue(const int index) {
+  if (mIsSparseStorageEnabled) {
+    const double * p = mSparseImage.FindValues(index);
+    return (p ? p[ValueChannel] : mSparseImage.GetBackgroundValue(ValueChannel));
+  }
   return mValueImage.GetValue(index);
 }
 //-----------------------------------------------------------------------------
@@ -183,6 +236,11 @@ double GateImageWithStatistic::GetValue(const int index) {
 
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::SetValue(const int index, double value) {
+  if (mIsSparseStorageEnabled) {
+    mSparseImage.GetValues(index)[ValueChannel] = value;
+    return;
+  }
+  TouchVoxel(index);
   mValueImage.SetValue(index, value);
 }
 //-----------------------------------------------------------------------------
@@ -191,6 +249,11 @@ void GateImageWithStatistic::SetValue(const int index, double value) {
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::AddValue(const int index, double value) {
   GateDebugMessage("Actor", 2, "AddValue index=" << index << " value=" << value << Gateendl);
+  if (mIsSparseStorageEnabled) {
+    mSparseImage.GetValues(index)[ValueChannel] += value;
+    return;
+  }
+  TouchVoxel(index);
   mValueImage.AddValue(index, value);
 }
 //-----------------------------------------------------------------------------
@@ -199,6 +262,11 @@ void GateImageWithStatistic::AddValue(const int index, double value) {
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::AddTempValue(const int index, double value) {
   GateDebugMessage("Actor", 2, "AddTempValue index=" << index << " value=" << value << Gateendl);
+  if (mIsSparseStorageEnabled) {
+    mSparseImage.GetValues(index)[TempChannel] += value;
+    return;
+  }
+  TouchVoxel(index);
   mTempImage.AddValue(index, value);
 }
 //-----------------------------------------------------------------------------
@@ -208,6 +276,16 @@ void GateImageWithStatistic::AddTempValue(const int index, double value) {
 void GateImageWithStatistic::AddValueAndUpdate(const int index, double value) {
 
   GateDebugMessageInc("Actor", 2, "AddValue and update -- start: "<<mTempImage.GetSize() << Gateendl);
+  if (mIsSparseStorageEnabled) {
+    double * p = mSparseImage.GetValues(index);
+    double tmp = p[TempChannel];
+    p[ValueChannel] += tmp;
+    p[SquaredChannel] += tmp*tmp;
+    p[TempChannel] = value;
+    GateDebugMessageDec("Actor", 2, "AddValue and update -- end"<< Gateendl);
+    return;
+  }
+  TouchVoxel(index);
   double tmp = mTempImage.GetValue(index);
   mValueImage.AddValue(index, tmp);
   if (mIsSquaredImageEnabled || mIsUncertaintyImageEnabled) mSquaredImage.AddValue(index, tmp*tmp);
@@ -240,6 +318,11 @@ void GateImageWithStatistic::SaveData(int numberOfEvents, bool normalise) {
     mUncertaintyFilename = GetSaveCurrentFilename(mUncertaintyInitialFilename);
   }
 
+  if (mIsSparseStorageEnabled) {
+    SaveSparseData(numberOfEvents, normalise);
+    return;
+  }
+
   double factor=1.0;
   if (mIsSquaredImageEnabled || mIsUncertaintyImageEnabled) { UpdateImage(); }
   if (mIsSquaredImageEnabled) { UpdateSquaredImage(); }
@@ -310,6 +393,15 @@ void GateImageWithStatistic::SaveData(int numberOfEvents, bool normalise) {
 
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::UpdateImage() {
+  if (mIsSparseStorageEnabled) {
+    if (mSparseImage.GetNumberOfChannels() <= TempChannel) return;
+    for(size_t b=0; b<mSparseImage.GetNumberOfAllocatedBlocks(); b++) {
+      double * p = mSparseImage.GetBlockValues(b);
+      for(int v=0; v<GateBlockSparseImage::kBlockNumberOfVoxels; v++, p+=3)
+        p[ValueChannel] += p[TempChannel];
+    }
+    return;
+  }
   GateImageDouble::iterator pi = mValueImage.begin();
   GateImageDouble::iterator pt = mTempImage.begin();
   GateImageDouble::const_iterator pe = mValueImage.end();
@@ -324,6 +416,17 @@ void GateImageWithStatistic::UpdateImage() {
 
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::UpdateSquaredImage() {
+  if (mIsSparseStorageEnabled) {
+    if (mSparseImage.GetNumberOfChannels() <= TempChannel) return;
+    for(size_t b=0; b<mSparseImage.GetNumberOfAllocatedBlocks(); b++) {
+      double * p = mSparseImage.GetBlockValues(b);
+      for(int v=0; v<GateBlockSparseImage::kBlockNumberOfVoxels; v++, p+=3) {
+        p[SquaredChannel] += p[TempChannel]*p[TempChannel];
+        p[TempChannel] = 0;
+      }
+    }
+    return;
+  }
   GateImageDouble::iterator pi = mSquaredImage.begin();
   GateImageDouble::iterator pt = mTempImage.begin();
   GateImageDouble::const_iterator pe = mSquaredImage.end();
@@ -337,9 +440,67 @@ void GateImageWithStatistic::UpdateSquaredImage() {
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+void GateImageWithStatistic::Merge(GateImageWithStatistic & image)
+{
+  if (mIsSparseStorageEnabled || image.mIsSparseStorageEnabled) {
+    MergeSparse(image);
+    return;
+  }
+
+  bool withSquared = (mIsSquaredImageEnabled || mIsUncertaintyImageEnabled);
+  if (!image.mIsTouchedVoxelsTrackingEnabled) {
+    if (withSquared) {
+      image.UpdateImage();
+      image.UpdateSquaredImage();
+    }
+    mValueImage.MergeDataByAddition(image.mValueImage);
+    if (withSquared) mSquaredImage.MergeDataByAddition(image.mSquaredImage);
+    image.Reset();
+    return;
+  }
+
+  // Sparse merge: the temp value is the (complete) last event of the
+  // worker in this voxel, it is flushed to the value and squared images
+  for(unsigned int i=0; i<image.mTouchedVoxels.size(); i++) {
+    const int index = image.mTouchedVoxels[i];
+    double value = image.mValueImage.GetValue(index);
+    image.mValueImage.SetValue(index, 0.0);
+    if (withSquared) {
+      double tmp = image.mTempImage.GetValue(index);
+      mValueImage.AddValue(index, value + tmp);
+      mSquaredImage.AddValue(index, image.mSquaredImage.GetValue(index) + tmp*tmp);
+      image.mTempImage.SetValue(index, 0.0);
+      image.mSquaredImage.SetValue(index, 0.0);
+    }
+    else mValueImage.AddValue(index, value);
+  }
+  image.ResetTouchedVoxels();
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::UpdateUncertaintyImage(int numberOfEvents)
 {
+  if (mIsSparseStorageEnabled) {
+    // the uncertainty image must be allocated (done by SaveData)
+    const double background =
+      ComputeRelativeUncertainty(mSparseImage.GetBackgroundValue(ValueChannel),
+                                 mSparseImage.GetBackgroundValue(SquaredChannel), numberOfEvents);
+    mUncertaintyImage.Fill(background);
+    for(size_t b=0; b<mSparseImage.GetNumberOfAllocatedBlocks(); b++) {
+      const double * p = mSparseImage.GetBlockValues(b);
+      const int blockId = mSparseImage.GetBlockId(b);
+      for(int v=0; v<GateBlockSparseImage::kBlockNumberOfVoxels; v++, p+=3) {
+        int index = mSparseImage.GetVoxelIndex(blockId, v);
+        if (index < 0) continue;
+        mUncertaintyImage.SetValue(index, ComputeRelativeUncertainty(p[ValueChannel], p[SquaredChannel], numberOfEvents));
+      }
+    }
+    return;
+  }
+
   GateImageDouble::iterator po = mUncertaintyImage.begin();
   GateImageDouble::iterator pi;
   GateImageDouble::iterator pii;
@@ -360,12 +521,7 @@ void GateImageWithStatistic::UpdateUncertaintyImage(int numberOfEvents)
      *po = sqrt( (N*squared - mean*mean) / ((N-1)*(mean*mean)) );
      else *po = 1;*/
 
-    // Chetty2006 p1250 : relative statistical uncertainty
-    // exactly same than Ma2002
-    if (mean != 0.0 && N != 1 && squared != 0.0){
-      *po = sqrt( (1.0/(N-1))*(squared/N - pow(mean/N, 2)))/(mean/N);
-    }
-    else *po = 1;
+    *po = ComputeRelativeUncertainty(mean, squared, N);
 
     /*
     // Ma2002 p1679 : relative statistical uncertainty (estimation)
@@ -389,4 +545,103 @@ void GateImageWithStatistic::UpdateUncertaintyImage(int numberOfEvents)
 }
 //-----------------------------------------------------------------------------
 
+
+//-----------------------------------------------------------------------------
+double GateImageWithStatistic::ComputeRelativeUncertainty(double mean, double squared, int N)
+{
+  // Chetty2006 p1250 : relative statistical uncertainty
+  // exactly same than Ma2002
+  if (mean != 0.0 && N != 1 && squared != 0.0)
+    return sqrt( (1.0/(N-1))*(squared/N - pow(mean/N, 2)))/(mean/N);
+  return 1;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateImageWithStatistic::SaveSparseData(int numberOfEvents, bool normalise)
+{
+  const int n = mSparseImage.GetNumberOfChannels();
+  if (mIsSquaredImageEnabled || mIsUncertaintyImageEnabled) {
+    UpdateImage();
+    UpdateSquaredImage();
+  }
+
+  // Same scaling than the dense images, the scale factor is not modified
+  double factor = (mIsValuesMustBeScaled ? mScaleFactor : 1.0);
+  double scale = factor;
+  if (normalise) {
+    double sum = 0.0;
+    double max = 0.0;
+    // Voxels of the blocks not allocated have the background value
+    long nbOfBackgroundVoxels = mSparseImage.GetNumberOfBackgroundVoxels();
+    if (nbOfBackgroundVoxels > 0) {
+      double background = mSparseImage.GetBackgroundValue(ValueChannel);
+      if (background > max) max = background;
+      sum += background*factor*nbOfBackgroundVoxels;
+    }
+    for(size_t b=0; b<mSparseImage.GetNumberOfAllocatedBlocks(); b++) {
+      const double * p = mSparseImage.GetBlockValues(b);
+      const int blockId = mSparseImage.GetBlockId(b);
+      for(int v=0; v<GateBlockSparseImage::kBlockNumberOfVoxels; v++, p+=n) {
+        if (mSparseImage.GetVoxelIndex(blockId, v) < 0) continue;
+        if (p[ValueChannel] > max) max = p[ValueChannel];
+        sum += p[ValueChannel]*factor;
+      }
+    }
+    if (mNormalizedToMax) scale = factor*1.0/max;
+    if (mNormalizedToIntegral) scale = factor*1.0/sum;
+  }
+
+  GateMessage("Actor", 1, "Save " << mFilename << " with scaling = " << scale
+              << " (sparse storage: " << mSparseImage.GetNumberOfAllocatedBlocks() << " blocks, "
+              << mSparseImage.GetMemorySize()/(1024*1024) << " MB)\n");
+
+  // A single dense image at a time, released after writing
+  mScaledValueImage.Allocate();
+  mSparseImage.CopyChannelToImage(ValueChannel, mScaledValueImage, scale);
+  mScaledValueImage.Write(mFilename);
+  if (mIsSquaredImageEnabled) {
+    mSparseImage.CopyChannelToImage(SquaredChannel, mScaledValueImage, scale*scale);
+    mScaledValueImage.Write(mSquaredFilename);
+  }
+  mScaledValueImage.Deallocate();
+
+  if (mIsUncertaintyImageEnabled) {
+    mUncertaintyImage.Allocate();
+    UpdateUncertaintyImage(numberOfEvents);
+    mUncertaintyImage.Write(mUncertaintyFilename);
+    mUncertaintyImage.Deallocate();
+  }
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateImageWithStatistic::MergeSparse(GateImageWithStatistic & image)
+{
+  if (!mIsSparseStorageEnabled || !image.mIsSparseStorageEnabled)
+    GateError("Cannot merge an image with sparse storage and an image with dense storage");
+
+  // As in Merge, the temp value of the worker is its last event in the
+  // voxel and is flushed. New blocks start with the background value.
+  const int n = mSparseImage.GetNumberOfChannels();
+  bool withSquared = (mIsSquaredImageEnabled || mIsUncertaintyImageEnabled);
+  GateBlockSparseImage & sparse = image.mSparseImage;
+  for(size_t b=0; b<sparse.GetNumberOfAllocatedBlocks(); b++) {
+    const double * pi = sparse.GetBlockValues(b);
+    double * po = mSparseImage.GetBlockValuesFromId(sparse.GetBlockId(b));
+    for(int v=0; v<GateBlockSparseImage::kBlockNumberOfVoxels; v++, pi+=n, po+=n) {
+      if (withSquared) {
+        double tmp = pi[TempChannel];
+        po[ValueChannel] += pi[ValueChannel] + tmp;
+        po[SquaredChannel] += pi[SquaredChannel] + tmp*tmp;
+      }
+      else po[ValueChannel] += pi[ValueChannel];
+    }
+  }
+  sparse.Clear();
+}
+//-----------------------------------------------------------------------------
+
 #endif /* end #define GATEIMAGEWITHSTATISTIC_CC */
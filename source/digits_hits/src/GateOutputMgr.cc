@@ -41,6 +41,7 @@
 #include "GateToRoot.hh"
 
 #include "GateToTree.hh"
+#include "GateAsyncBlockWriter.hh"
 
 GateOutputMgr* GateOutputMgr::instance = 0;
 
@@ -268,6 +269,14 @@ void GateOutputMgr::RecordEndOfAcquisition()
       m_outputModules[iMod]->RecordEndOfAcquisition();
   }
 
+  // All the blocks handed to the writer thread are on disk at the end of the acquisition
+  GateAsyncBlockWriter& writer = GateAsyncBlockWriter::instance();
+  if (writer.is_enabled()) {
+    writer.wait();
+    if (nVerboseLevel > 1)
+      G4cout << "     Time waiting for the output writer thread (sec) := " << writer.get_waiting_time() << Gateendl;
+  }
+
 #ifdef G4ANALYSIS_USE_ROOT
   if (m_digiMode==kofflineMode)
     GateHitFileReader::GetInstance()->TerminateAfterAcquisition();
@@ -313,6 +322,22 @@ void GateOutputMgr::RecordVoxels(GateVGeometryVoxelStore* voxelStore)
 }
 //----------------------------------------------------------------------------------
 
+//----------------------------------------------------------------------------------
+void GateOutputMgr::SetAsynchronousWriting(G4bool flag)
+{
+  GateAsyncBlockWriter::instance().set_enabled(flag);
+}
+//----------------------------------------------------------------------------------
+
+
+//----------------------------------------------------------------------------------
+void GateOutputMgr::SetAsynchronousQueueSize(size_t queueSize)
+{
+  GateAsyncBlockWriter::instance().set_capacity(queueSize);
+}
+//----------------------------------------------------------------------------------
+
+
 //----------------------------------------------------------------------------------
 void GateOutputMgr::Describe(size_t /*indent*/)
 {
@@ -450,6 +475,17 @@ void GateOutputMgr::CheckFileNameForAllOutput()
 }
 //----------------------------------------------------------------------------------
 
+//----------------------------------------------------------------------------------
+G4int GateOutputMgr::GetNumberOfEnabledModules()
+{
+  G4int nbModuleEnabled = 0;
+  std::vector<GateVOutputModule*>::iterator aIt;
+  for ( aIt = m_outputModules.begin(); aIt != m_outputModules.end(); aIt++)
+    if ( (*aIt)->IsEnabled() ) nbModuleEnabled++;
+  return nbModuleEnabled;
+}
+//----------------------------------------------------------------------------------
+
 //----------------------------------------------------------------------------------
 void GateOutputMgr::BeginOfRunAction(const G4Run* /*aRun*/)
 {
@@ -16,6 +16,7 @@
 #include "G4UIcmdWithADoubleAndUnit.hh"
 #include "G4UIcmdWith3VectorAndUnit.hh"
 #include "G4UIcmdWithoutParameter.hh"
+#include "G4UIcmdWithABool.hh"
 
 //------------------------------------------------------------------------------
 GateOutputMgrMessenger::GateOutputMgrMessenger(GateOutputMgr* outputMgr)
@@ -43,6 +44,17 @@ GateOutputMgrMessenger::GateOutputMgrMessenger(GateOutputMgr* outputMgr)
   cmdName = GetDirectoryName()+"allowNoOutput";
   AllowNoOutputCmd = new G4UIcmdWithoutParameter(cmdName,this);
   AllowNoOutputCmd->SetGuidance("Allow to launch a simulation without any output nor actor");
+
+  cmdName = GetDirectoryName()+"setAsynchronousWriting";
+  AsynchronousWritingCmd = new G4UIcmdWithABool(cmdName,this);
+  AsynchronousWritingCmd->SetGuidance("Write the blocks of the numpy, binary and ASCII outputs in a background thread");
+  AsynchronousWritingCmd->SetParameterName("flag",false);
+
+  cmdName = GetDirectoryName()+"setAsynchronousQueueSize";
+  AsynchronousQueueSizeCmd = new G4UIcmdWithAnInteger(cmdName,this);
+  AsynchronousQueueSizeCmd->SetGuidance("Maximal size (MB) of the blocks waiting for the background writer, the simulation waits when it is reached");
+  AsynchronousQueueSizeCmd->SetParameterName("size",false);
+  AsynchronousQueueSizeCmd->SetRange("size>0");
 }
 //------------------------------------------------------------------------------
 
@@ -53,6 +65,8 @@ GateOutputMgrMessenger::~GateOutputMgrMessenger()
   delete DescribeCmd;
   delete VerboseCmd;
   delete AllowNoOutputCmd;
+  delete AsynchronousWritingCmd;
+  delete AsynchronousQueueSizeCmd;
   delete pGateOutputMess;
 }
 //------------------------------------------------------------------------------
@@ -67,6 +81,10 @@ void GateOutputMgrMessenger::SetNewValue(G4UIcommand* command, G4String newValue
     m_outputMgr->Describe();
   } else if( command == AllowNoOutputCmd ) {
     m_outputMgr->AllowNoOutput();
+  } else if( command == AsynchronousWritingCmd ) {
+    m_outputMgr->SetAsynchronousWriting(AsynchronousWritingCmd->GetNewBoolValue(newValue));
+  } else if( command == AsynchronousQueueSizeCmd ) {
+    m_outputMgr->SetAsynchronousQueueSize((size_t)AsynchronousQueueSizeCmd->GetNewIntValue(newValue) << 20);
   } else
   GateMessenger::SetNewValue(command, newValue);
 }
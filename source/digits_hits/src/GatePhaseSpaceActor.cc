@@ -328,7 +328,7 @@ void GatePhaseSpaceActor::UserSteppingAction(const GateVVolume *, const G4Step *
       const bool mPositionIsSet = false;
       const G4ThreeVector mPosition;
       const GateVImageActor::StepHitType mStepHitType = GateVImageActor::PreStepHitType;
-      auto index = GateVImageActor::GetIndexFromStepPosition2(mVolume, step, mMask, mPositionIsSet, mPosition, mStepHitType);
+      auto index = GateVImageActor::GetIndexFromStepPosition2(mVolume, step, mMask, mPositionIsSet, mPosition, mStepHitType, &mMaskDepthCache);
       auto value = mMask.GetValue(index);
       if (value == 1) return; // do nothing
     }
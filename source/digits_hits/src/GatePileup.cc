@@ -15,13 +15,15 @@ See LICENSE.md for further details
 #include "GatePileupMessenger.hh"
 #include "GateTools.hh"
 
+#include <algorithm>
+
 
 GatePileup::GatePileup(GatePulseProcessorChain* itsChain,
       	      	      	 const G4String& itsName)
   : GateVPulseProcessor(itsChain,itsName),
     m_depth(1),
     m_pileup(0),
-    m_waiting("")
+    m_waitingOrder(0)
 {
   m_messenger = new GatePileupMessenger(this);
 }
@@ -31,6 +33,10 @@ GatePileup::GatePileup(GatePulseProcessorChain* itsChain,
 
 GatePileup::~GatePileup()
 {
+  std::unordered_map<GateOutputVolumeID,WaitingBlock,GateOutputVolumeIDHash>::iterator block;
+  for (block = m_waitingBlocks.begin() ; block != m_waitingBlocks.end() ; ++block)
+    for (size_t i=0 ; i<block->second.size() ; ++i)
+      delete block->second[i].pulse;
   delete m_messenger;
 }
 
@@ -39,26 +45,37 @@ GatePulseList* GatePileup::ProcessPulseList(const GatePulseList* inputPulseList)
 {
   G4double minTime = inputPulseList->ComputeStartTime();
   GatePulseList* ans = new GatePulseList(GetObjectName());
-  std::vector<GatePulseIterator> toDel;
-  GatePulseIterator iter;
-  for (iter = m_waiting.begin() ; iter != m_waiting.end() ; ++iter ){
-    if ( (*iter)->GetTime()+m_pileup<minTime) {
-    	ans->push_back( (*iter) );
-	toDel.push_back(iter);
-    }
-  }
-  for (int i= (int)toDel.size()-1;i>=0;i--){
-    m_waiting.erase( toDel[i] );
+
+  // Pulses whose pileup window is over, taken from the top of the heap
+  std::vector<WaitingPulse> done;
+  while ( !m_waitingTimes.empty() && (m_waitingTimes.front().time+m_pileup<minTime) ) {
+    WaitingTime top = m_waitingTimes.front();
+    std::pop_heap(m_waitingTimes.begin(), m_waitingTimes.end(), IsLaterWaitingTime());
+    m_waitingTimes.pop_back();
+
+    WaitingBlock& block = *top.block;
+    size_t i = 0;
+    while ( (i<block.size()) && (block[i].order!=top.order) ) ++i;
+    // already gone, or its time changed since (a later entry was pushed)
+    if ( (i==block.size()) || (block[i].pulse->GetTime()!=top.time) )
+      continue;
+    done.push_back(block[i]);
+    block.erase(block.begin()+i);
   }
 
+  // The pulses leave in their order of creation
+  std::sort(done.begin(), done.end(), IsEarlierWaitingPulse());
+  for (size_t i=0 ; i<done.size() ; ++i)
+    ans->push_back(done[i].pulse);
+
   GatePulseConstIterator itr;
   for (itr = inputPulseList->begin() ; itr != inputPulseList->end() ; ++itr)
-      	ProcessOnePulse( *itr, m_waiting);
+      	ProcessOnePulse( *itr, *ans);
   return ans;
 }
 
 
-void GatePileup::ProcessOnePulse(const GatePulse* inputPulse,GatePulseList& outputPulseList)
+void GatePileup::ProcessOnePulse(const GatePulse* inputPulse,GatePulseList& )
 {
   const GateOutputVolumeID& blockID  = inputPulse->GetOutputVolumeID().Top(m_depth);
 
@@ -70,32 +87,46 @@ void GatePileup::ProcessOnePulse(const GatePulse* inputPulse,GatePulseList& outp
     return;
   }
 
-  GatePulseIterator iter;
-  for (iter = outputPulseList.begin() ; iter != outputPulseList.end() ; ++iter )
-    if ( ((*iter)->GetOutputVolumeID().Top(m_depth) == blockID )
-         &&  (std::abs((*iter)->GetTime()-inputPulse->GetTime())<m_pileup) )
+  WaitingBlock& block = m_waitingBlocks[blockID];
+  WaitingBlock::iterator iter;
+  for (iter = block.begin() ; iter != block.end() ; ++iter )
+    if ( std::abs(iter->pulse->GetTime()-inputPulse->GetTime())<m_pileup )
       break;
 
-  if ( iter != outputPulseList.end() ){
-     G4double energySum = (*iter)->GetEnergy() + inputPulse->GetEnergy();
-     if ( inputPulse->GetEnergy() > (*iter)->GetEnergy() ){
-     	G4double time = std::max( (*iter)->GetTime() ,inputPulse->GetTime());
-      	**iter = *inputPulse;
-	(*iter)->SetTime(time);
+  GatePulse* outputPulse;
+  G4double previousTime = -1.;
+  if ( iter != block.end() ){
+     outputPulse = iter->pulse;
+     previousTime = outputPulse->GetTime();
+     G4double energySum = outputPulse->GetEnergy() + inputPulse->GetEnergy();
+     if ( inputPulse->GetEnergy() > outputPulse->GetEnergy() ){
+     	G4double time = std::max( outputPulse->GetTime() ,inputPulse->GetTime());
+      	*outputPulse = *inputPulse;
+	outputPulse->SetTime(time);
      }
-     (*iter)->SetEnergy(energySum);
+     outputPulse->SetEnergy(energySum);
      if (nVerboseLevel>1)
       	  G4cout  << "Overwritten previous pulse for block " << blockID << " with new pulse with higer energy.\n"
       	          << "Resulting pulse is: \n"
-		  << **iter << Gateendl << Gateendl ;
+		  << *outputPulse << Gateendl << Gateendl ;
   } else {
-    GatePulse* outputPulse = new GatePulse(*inputPulse);
+    outputPulse = new GatePulse(*inputPulse);
     if (nVerboseLevel>1)
       	G4cout << "Created new pulse for block " << blockID << ".\n"
       	       << "Resulting pulse is: \n"
 	       << *outputPulse << Gateendl << Gateendl ;
-    outputPulseList.push_back(outputPulse);
+    WaitingPulse waiting = { outputPulse, m_waitingOrder++ };
+    block.push_back(waiting);
+    iter = block.end()-1;
   }
+
+  // The time of the pulse can only increase: the entry of its previous time is left
+  // in the heap and will be ignored
+  if (outputPulse->GetTime()==previousTime)
+    return;
+  WaitingTime waitingTime = { outputPulse->GetTime(), iter->order, &block };
+  m_waitingTimes.push_back(waitingTime);
+  std::push_heap(m_waitingTimes.begin(), m_waitingTimes.end(), IsLaterWaitingTime());
 }
 
 
@@ -11,6 +11,7 @@ See LICENSE.md for further details
 #include "GateVSystem.hh"
 
 #include "G4UnitsTable.hh"
+#include <set>
 
 GatePulse::GatePulse(const void* itsMother)
     : m_runID(-1),
@@ -28,6 +29,22 @@ GatePulse::GatePulse(const void* itsMother)
       m_localPosError(0.0),
       m_mother(itsMother)
 {
+    // the interned strings are per thread, so is the cached empty name
+    static G4ThreadLocal const G4String* emptyName = 0;
+    if (!emptyName) emptyName = InternString("");
+    m_comptonVolumeName = m_RayleighVolumeName = emptyName;
+    m_Postprocess = m_processCreator = emptyName;
+}
+
+
+G4ThreadLocal G4Allocator<GatePulse>* GatePulseAllocator = 0;
+
+
+const G4String* GatePulse::InternString(const G4String& s)
+{
+    static G4ThreadLocal std::set<G4String>* strings = 0;
+    if (!strings) strings = new std::set<G4String>;
+    return &*strings->insert(s).first;
 }
 
 const GatePulse& GatePulse::CentroidMerge(const GatePulse* right)
@@ -41,10 +58,10 @@ const GatePulse& GatePulse::CentroidMerge(const GatePulse* right)
 
 
     // AE : Added in a real pulse no sense
-    m_Postprocess="NULL";         // PostStep process
+    m_Postprocess=InternString("NULL");         // PostStep process
     m_energyIniTrack=-1;         // Initial energy of the track
     m_energyFin=-1;         // final energy of the particle
-    m_processCreator="NULL";
+    m_processCreator=InternString("NULL");
     m_trackID=0;
     //-----------------
 
@@ -116,10 +133,10 @@ const GatePulse & GatePulse::MergePositionEnergyWin(const GatePulse* right){
 
 
     // AE : Added in a real pulse no sense
-    m_Postprocess="NULL";         // PostStep process
+    m_Postprocess=InternString("NULL");         // PostStep process
     m_energyIniTrack=0;         // Initial energy of the track
     m_energyFin=0;         // final energy of the particle
-    m_processCreator="NULL";
+    m_processCreator=InternString("NULL");
     m_trackID=0;
     //-----------------
 
@@ -33,6 +33,14 @@ GatePulseAdder::~GatePulseAdder()
 
 
 
+GatePulseList* GatePulseAdder::ProcessPulseList(const GatePulseList* inputPulseList)
+{
+  m_outputPulses.clear();
+  return GateVPulseProcessor::ProcessPulseList(inputPulseList);
+}
+
+
+
 void GatePulseAdder::ProcessOnePulse(const GatePulse* inputPulse,GatePulseList& outputPulseList)
 {
 #ifdef GATE_USE_OPTICAL
@@ -40,19 +48,22 @@ void GatePulseAdder::ProcessOnePulse(const GatePulse* inputPulse,GatePulseList&
   if (!inputPulse->IsOptical())
 #endif
   {
-    GatePulseIterator iter;
-    for (iter=outputPulseList.begin(); iter!= outputPulseList.end() ; ++iter)
-      if ( (*iter)->GetVolumeID()   == inputPulse->GetVolumeID() )
+    // Look for an output pulse in the same volume (hash first, then full volumeID)
+    const size_t key = GateVolumeIDHash()(inputPulse->GetVolumeID());
+    std::pair<OutputPulseMap::iterator,OutputPulseMap::iterator> range = m_outputPulses.equal_range(key);
+    OutputPulseMap::iterator iter;
+    for (iter=range.first; iter!= range.second ; ++iter)
+      if ( iter->second->GetVolumeID()   == inputPulse->GetVolumeID() )
       {
            if(m_positionPolicy==kTakeEnergyWin){
-                (*iter)->MergePositionEnergyWin(inputPulse);
+                iter->second->MergePositionEnergyWin(inputPulse);
 
 
 
 
            }
            else{
-               (*iter)->CentroidMerge( inputPulse );
+               iter->second->CentroidMerge( inputPulse );
            }
 
 
@@ -60,11 +71,11 @@ void GatePulseAdder::ProcessOnePulse(const GatePulse* inputPulse,GatePulseList&
 	  G4cout << "Merged previous pulse for volume " << inputPulse->GetVolumeID()
 		 << " with new pulse of energy " << G4BestUnit(inputPulse->GetEnergy(),"Energy") <<".\n"
 		 << "Resulting pulse is: \n"
-		 << **iter << Gateendl << Gateendl ;
+		 << *(iter->second) << Gateendl << Gateendl ;
 	break;
       }
 
-    if ( iter == outputPulseList.end() )
+    if ( iter == range.second )
     {
       GatePulse* outputPulse = new GatePulse(*inputPulse);
       outputPulse->SetEnergyIniTrack(-1);
@@ -74,6 +85,7 @@ void GatePulseAdder::ProcessOnePulse(const GatePulse* inputPulse,GatePulseList&
 		 << "Resulting pulse is: \n"
 		 << *outputPulse << Gateendl << Gateendl ;
       outputPulseList.push_back(outputPulse);
+      m_outputPulses.insert(std::make_pair(key,outputPulse));
     }
   }
 }
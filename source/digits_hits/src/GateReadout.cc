@@ -144,6 +144,7 @@ GatePulseList* GateReadout::ProcessPulseList(const GatePulseList* inputPulseList
   final_energy = (G4double*)calloc(n_pulses,sizeof(G4double));
   final_pulses = (GatePulse**)calloc(n_pulses,sizeof(GatePulse*));
   G4int final_nb_out_pulses = 0;
+  m_outputPulseIndex.clear();
 
   // Start loop on input pulses
   GatePulseConstIterator iterIn;
@@ -161,10 +162,9 @@ GatePulseList* GateReadout::ProcessPulseList(const GatePulseList* inputPulseList
       continue;
     }
 
-    // Loop inside the temporary output list to see if we have one pulse with same blockID as input
-    int this_output_pulse = 0;
-    for (this_output_pulse=0; this_output_pulse<final_nb_out_pulses; this_output_pulse++)
-      if (final_pulses[this_output_pulse]->GetOutputVolumeID().Top(m_depth) == blockID) break;
+    // Look in the temporary output list if we have one pulse with same blockID as input
+    // (the index of a new block is final_nb_out_pulses, its pulse is added below)
+    int this_output_pulse = m_outputPulseIndex.insert(std::make_pair(blockID,final_nb_out_pulses)).first->second;
 
     // Case: we found an output pulse with same blockID
     if ( this_output_pulse!=final_nb_out_pulses )
@@ -0,0 +1,131 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+#include "GateResolutionTable.hh"
+#include "GateVBlurringLaw.hh"
+#include "GateMiscFunctions.hh"
+#include "GateMessageManager.hh"
+#include "GateTools.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "G4UnitsTable.hh"
+
+#include <fstream>
+#include <sstream>
+#include <cmath>
+
+//-----------------------------------------------------------------------------
+GateResolutionTable::GateResolutionTable()
+{
+  m_nbCrystals = 0;
+  m_invStep = 0;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateResolutionTable::Read(const G4String& filename)
+{
+  m_source = filename;
+  m_energies.clear();
+  m_resolutions.clear();
+
+  std::ifstream inFile(filename);
+  if (!inFile) {
+    GateError("Cannot open resolution table file! " << filename << Gateendl);
+  }
+  int lineno = 0;
+  std::vector<int> sizes = ParseNextContentLine<int,2>(inFile,lineno,filename);
+  if (sizes[0] < 1 || sizes[1] < 1) {
+    GateError("The resolution table " << filename << " must contain at least one energy and one crystal - simulation abort!");
+  }
+  size_t nbEnergies = sizes[0];
+  m_nbCrystals = sizes[1];
+
+  // Energies and crystal rows have a variable number of values
+  std::istringstream energyLine(ReadNextContentLine(inFile,lineno,filename));
+  m_energies.resize(nbEnergies);
+  for (size_t k = 0; k < nbEnergies; k++) {
+    if (!(energyLine >> m_energies[k])) {
+      GateError("Line " << lineno << " of the resolution table " << filename << " must contain " << nbEnergies << " energies - simulation abort!");
+    }
+    m_energies[k] *= keV;
+    if (k>0 && m_energies[k]<=m_energies[k-1]) {
+      GateError("The energies of the resolution table " << filename << " must be ordered from lowest to highest - simulation abort!");
+    }
+  }
+
+  m_resolutions.resize(nbEnergies*m_nbCrystals);
+  for (size_t c = 0; c < m_nbCrystals; c++) {
+    std::istringstream crystalLine(ReadNextContentLine(inFile,lineno,filename));
+    for (size_t k = 0; k < nbEnergies; k++)
+      if (!(crystalLine >> m_resolutions[c*nbEnergies+k])) {
+        GateError("Line " << lineno << " of the resolution table " << filename << " must contain " << nbEnergies << " resolutions - simulation abort!");
+      }
+  }
+
+  ComputeBins();
+  G4cout << "[GateResolutionTable] " << filename << " loaded: " << m_nbCrystals
+         << " crystals, " << nbEnergies << " energies" << Gateendl;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateResolutionTable::Tabulate(const GateVBlurringLaw* law, G4double eMin, G4double eMax, size_t nbEnergies)
+{
+  if (nbEnergies < 2 || eMax <= eMin) {
+    GateError("The tabulation of the blurring law " << law->GetObjectName()
+              << " needs at least 2 energies and eMax > eMin - simulation abort!");
+  }
+  m_source = law->GetObjectName();
+  m_nbCrystals = 1;
+  m_energies.resize(nbEnergies);
+  m_resolutions.resize(nbEnergies);
+  G4double step = (eMax-eMin)/(nbEnergies-1);
+  for (size_t k = 0; k < nbEnergies; k++) {
+    m_energies[k] = eMin + k*step;
+    m_resolutions[k] = law->ComputeResolution(m_energies[k]);
+  }
+  ComputeBins();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateResolutionTable::ComputeBins()
+{
+  const size_t n = m_energies.size();
+  m_invWidths.assign(n > 1 ? n-1 : 0, 0.);
+  for (size_t k = 0; k+1 < n; k++)
+    m_invWidths[k] = 1./(m_energies[k+1]-m_energies[k]);
+
+  // The bin is computed directly when all the bins have the same width
+  m_invStep = 0;
+  if (n > 1) {
+    G4double width = m_energies[1]-m_energies[0];
+    G4bool isRegular = true;
+    for (size_t k = 1; k+1 < n && isRegular; k++)
+      isRegular = std::fabs((m_energies[k+1]-m_energies[k])-width) <= 1e-9*width;
+    if (isRegular) m_invStep = 1./width;
+  }
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateResolutionTable::Describe(size_t indent) const
+{
+  G4cout << GateTools::Indent(indent) << "Resolution table:\t" << m_source << Gateendl;
+  if (m_energies.empty()) return;
+  G4cout << GateTools::Indent(indent+1) << "Crystals:\t" << m_nbCrystals << Gateendl;
+  G4cout << GateTools::Indent(indent+1) << "Energies:\t" << m_energies.size() << " from "
+         << G4BestUnit(m_energies.front(),"Energy") << " to " << G4BestUnit(m_energies.back(),"Energy")
+         << (m_invStep > 0 ? " (regular grid)" : "") << Gateendl;
+}
+//-----------------------------------------------------------------------------
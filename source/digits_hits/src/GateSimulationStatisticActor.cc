@@ -187,4 +187,23 @@ void GateSimulationStatisticActor::ResetData()
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+void GateSimulationStatisticActor::MergeDataFrom(GateVActor * workerActor)
+{
+  // The number of runs is counted by the master itself
+  GateSimulationStatisticActor * worker = dynamic_cast<GateSimulationStatisticActor*>(workerActor);
+  mNumberOfEvents += worker->mNumberOfEvents;
+  mNumberOfTrack += worker->mNumberOfTrack;
+  mNumberOfSteps += worker->mNumberOfSteps;
+  mNumberOfGeometricalSteps += worker->mNumberOfGeometricalSteps;
+  mNumberOfPhysicalSteps += worker->mNumberOfPhysicalSteps;
+  worker->mNumberOfEvents = 0;
+  worker->mNumberOfTrack = 0;
+  worker->mNumberOfSteps = 0;
+  worker->mNumberOfGeometricalSteps = 0;
+  worker->mNumberOfPhysicalSteps = 0;
+}
+//-----------------------------------------------------------------------------
+
+
 #endif /* end #define GATESIMULATIONSTATISTICACTOR_CC */
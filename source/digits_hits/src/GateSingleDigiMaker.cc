@@ -42,7 +42,9 @@ void GateSingleDigiMaker::Digitize()
   if (nVerboseLevel>1)
     G4cout  << "[GateSingleDigiMaker::Digitize]: retrieving pulse-list '" << m_inputName << "'\n";
 
-  GatePulseList* pulseList = GateDigitizer::GetInstance()->FindPulseList(m_inputName);
+  if (m_inputSlot<0)
+    m_inputSlot = GateDigitizer::GetInstance()->GetPulseListSlot(m_inputName);
+  GatePulseList* pulseList = GateDigitizer::GetInstance()->FindPulseList(m_inputSlot);
 
   if (!pulseList) {
     if (nVerboseLevel>1)
@@ -0,0 +1,151 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+#include "GateStoppingPowerRatioTable.hh"
+#include "GateMessageManager.hh"
+
+#include <G4EmCalculator.hh>
+#include <G4Material.hh>
+#include <G4ParticleDefinition.hh>
+#include <G4SystemOfUnits.hh>
+#include <cfloat>
+#include <cmath>
+
+//-----------------------------------------------------------------------------
+GateStoppingPowerRatioTable::GateStoppingPowerRatioTable()
+{
+  mEmCalculator = 0;
+  mTargetMaterial = 0;
+  mTolerance = 0.0;
+  SetEnergyRange(1*keV, 10*GeV, 400);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateStoppingPowerRatioTable::SetEnergyRange(double emin, double emax, int nbins)
+{
+  if (nbins < 0 || (nbins > 0 && (emin <= 0 || emax <= emin))) {
+    GateError("Stopping power ratio table: wrong energy range [" << emin/MeV << " "
+              << emax/MeV << "] MeV with " << nbins << " bins");
+  }
+  mMinEnergy = emin;
+  mMaxEnergy = emax;
+  mNumberOfBins = nbins;
+  mLogMinEnergy = std::log(emin);
+  mInvLogBinWidth = (nbins > 0 ? nbins/(std::log(emax)-mLogMinEnergy) : 0.0);
+  mTables.clear();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateStoppingPowerRatioTable::Initialize(G4EmCalculator * calc)
+{
+  mEmCalculator = calc;
+  mTables.clear();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateStoppingPowerRatioTable::BuildTables(const G4ParticleDefinition * p)
+{
+  if (mNumberOfBins == 0) return;
+  const G4MaterialTable * table = G4Material::GetMaterialTable();
+  for (size_t i=0; i<table->size(); i++) GetTable(p, (*table)[i]);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+double GateStoppingPowerRatioTable::ComputeExactRatio(const G4ParticleDefinition * p,
+                                                      const G4Material * m,
+                                                      double energy)
+{
+  const double cut = DBL_MAX;
+  double dedx = mEmCalculator->ComputeTotalDEDX(energy, p, m, cut);
+  if (dedx == 0) return 0.0;
+  double dedxTarget = mEmCalculator->ComputeTotalDEDX(energy, p, mTargetMaterial, cut);
+  return dedxTarget/dedx;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+double GateStoppingPowerRatioTable::GetRatio(const G4ParticleDefinition * p,
+                                             const G4Material * m,
+                                             double energy)
+{
+  if (mNumberOfBins == 0 || energy < mMinEnergy || energy >= mMaxEnergy ||
+      p->GetParticleDefinitionID() < 0)
+    return ComputeExactRatio(p, m, energy);
+
+  const std::vector<double> & table = GetTable(p, m);
+  double x = (std::log(energy)-mLogMinEnergy)*mInvLogBinWidth;
+  int i = static_cast<int>(x);
+  if (i >= mNumberOfBins) i = mNumberOfBins-1;
+  // The ratio is 0 where one of the stopping powers is 0 (e.g. neutral
+  // particles or below a threshold): do not interpolate across it
+  if (table[i] == 0 || table[i+1] == 0) return ComputeExactRatio(p, m, energy);
+  return table[i] + (table[i+1]-table[i])*(x-i);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+const std::vector<double> &
+GateStoppingPowerRatioTable::GetTable(const G4ParticleDefinition * p, const G4Material * m)
+{
+  size_t id = p->GetParticleDefinitionID();
+  size_t index = m->GetIndex();
+  if (mTables.size() <= id) mTables.resize(id+1);
+  std::vector<std::vector<double> > & tables = mTables[id];
+  if (tables.size() <= index) tables.resize(index+1);
+  if (tables[index].empty()) BuildTable(p, m, tables[index]);
+  return tables[index];
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateStoppingPowerRatioTable::BuildTable(const G4ParticleDefinition * p,
+                                             const G4Material * m,
+                                             std::vector<double> & table)
+{
+  double binWidth = 1.0/mInvLogBinWidth;
+  table.resize(mNumberOfBins+1);
+  for (int i=0; i<=mNumberOfBins; i++)
+    table[i] = ComputeExactRatio(p, m, std::exp(mLogMinEnergy + i*binWidth));
+
+  if (mTolerance <= 0) return;
+
+  // Compare to the exact ratio in the middle of each bin (worst case of
+  // the linear interpolation)
+  double maxError = 0.0;
+  double maxErrorEnergy = 0.0;
+  for (int i=0; i<mNumberOfBins; i++) {
+    if (table[i] == 0 || table[i+1] == 0) continue;
+    double e = std::exp(mLogMinEnergy + (i+0.5)*binWidth);
+    double exact = ComputeExactRatio(p, m, e);
+    if (exact == 0) continue;
+    double error = std::fabs(0.5*(table[i]+table[i+1])/exact - 1.0);
+    if (error > maxError) { maxError = error; maxErrorEnergy = e; }
+  }
+  GateMessage("Actor", 2, "Stopping power ratio table " << p->GetParticleName()
+              << " in " << m->GetName() << " / " << mTargetMaterial->GetName()
+              << " max relative error = " << maxError << Gateendl);
+  if (maxError > mTolerance) {
+    GateWarning("Stopping power ratio table for " << p->GetParticleName()
+                << " in " << m->GetName() << " / " << mTargetMaterial->GetName()
+                << ": relative error " << maxError << " at " << maxErrorEnergy/MeV
+                << " MeV is larger than the tolerance " << mTolerance
+                << ". Consider increasing the number of bins.");
+  }
+}
+//-----------------------------------------------------------------------------
@@ -16,6 +16,7 @@
 #include "GateMaterialMuHandler.hh"
 
 #include <G4PhysicalConstants.hh>
+#include <G4Gamma.hh>
 
 //-----------------------------------------------------------------------------
 GateTLEDoseActor::GateTLEDoseActor(G4String name, G4int depth):
@@ -34,6 +35,7 @@ GateTLEDoseActor::GateTLEDoseActor(G4String name, G4int depth):
   mImportMassImage = "";
   mVolumeFilter = "";
   mMaterialFilter = "";
+  pUserSteppingActionInVoxel = &GateTLEDoseActor::UserSteppingActionInVoxelT<false>;
 }
 //-----------------------------------------------------------------------------
 
@@ -125,6 +127,12 @@ void GateTLEDoseActor::Construct() {
     mVoxelizedMass.Initialize(mVolumeName, &mDoseImage.GetValueImage());
   }
 
+  mStepFilter.Initialize("TLEDoseActor " + GetObjectName(), mVolumeFilter, mMaterialFilter);
+  if (mDoseAlgorithmType == "MassWeighting" || mStepFilter.IsEnabled())
+    pUserSteppingActionInVoxel = &GateTLEDoseActor::UserSteppingActionInVoxelT<true>;
+  else
+    pUserSteppingActionInVoxel = &GateTLEDoseActor::UserSteppingActionInVoxelT<false>;
+
   ConversionFactor = e_SI * 1.0e11;
   VoxelVolume = GetDoselVolume();
   ResetData();
@@ -186,16 +194,16 @@ void GateTLEDoseActor::BeginOfEventAction(const G4Event *e) {
 
 
 //-----------------------------------------------------------------------------
-void GateTLEDoseActor::UserSteppingActionInVoxel(const int index, const G4Step *step) {
+template<bool UseVoxelizedMass>
+void GateTLEDoseActor::UserSteppingActionInVoxelT(const int index, const G4Step *step) {
   G4StepPoint *PreStep(step->GetPreStepPoint());
   G4StepPoint *PostStep(step->GetPostStepPoint());
   G4ThreeVector prePosition = PreStep->GetPosition();
   G4ThreeVector postPosition = PostStep->GetPosition();
 
-  if (step->GetTrack()->GetDefinition()->GetParticleName() == "gamma") {
+  if (step->GetTrack()->GetDefinition() == G4Gamma::Gamma()) {
     // Filters conditions
-    if ((mVolumeFilter != "" && mVolumeFilter+"_phys" != step->GetPreStepPoint()->GetPhysicalVolume()->GetName()) ||
-        (mMaterialFilter != "" && mMaterialFilter != step->GetPreStepPoint()->GetMaterial()->GetName()))
+    if (UseVoxelizedMass && mStepFilter.Rejects(PreStep))
       return;
 
     double distance = step->GetStepLength();
@@ -205,7 +213,7 @@ void GateTLEDoseActor::UserSteppingActionInVoxel(const int index, const G4Step *
 
     //---------------------------------------------------------------------------------
     // Mass weighting OR filter
-    if (mDoseAlgorithmType == "MassWeighting" || mMaterialFilter != "" || mVolumeFilter != "") {
+    if (UseVoxelizedMass) {
       double muen = mMaterialHandler->GetMuEn(PreStep->GetMaterialCutsCouple(), energy);
       dose = energy * muen * distance / mVoxelizedMass.GetDoselMass(index) / gray * 0.1;
     }
@@ -227,6 +227,7 @@ void GateToRoot::Book()
   m_total_nb_primaries_hist = new TH1D(hist_name,hist_title,100,0,900000000000.);
 
   m_treeHit = new GateHitTree(GateHitConvertor::GetOutputAlias());
+  m_treeHit->SetDisabledBranches(m_disabledHitBranches);
   m_treeHit->Init(m_hitBuffer);
 
   // v. cuplov - optical photons
@@ -268,6 +269,12 @@ void GateToRoot::Book()
   for (size_t i=0; i<m_outputChannelList.size(); ++i)
     m_outputChannelList[i]->Book();
 
+  //! Basket size, auto-flush and auto-save once all the branches are created
+  m_storageSettings.apply(m_treeHit);
+  m_storageSettings.apply(OpticalTree);
+  for (size_t i=0; i<m_outputChannelList.size(); ++i)
+    if (m_outputChannelList[i]->GetTree())
+      m_storageSettings.apply(m_outputChannelList[i]->GetTree());
 
   m_working_root_directory = TDirectory::CurrentDirectory();
 
@@ -364,6 +371,7 @@ void GateToRoot::RecordBeginOfAcquisition()
           G4String msg = "Could not open the requested output ROOT file '" + m_fileName + ".root'!";
           G4Exception( "GateToRoot::RecordBeginOfAcquisition", "RecordBeginOfAcquisition", FatalException, msg );
 	}
+      m_storageSettings.apply(m_hfile);
       //! We book histos and ntuples only once per acquisition
       Book();
 
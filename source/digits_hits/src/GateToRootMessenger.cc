@@ -75,6 +75,41 @@ GateToRootMessenger::GateToRootMessenger(GateToRoot* gateToRoot)
   SaveRndmCmd->SetGuidance("Set the flag for change the seed at each Run");
   SaveRndmCmd->SetGuidance("1. true/false");
 
+  cmdName = GetDirectoryName()+"setCompression";
+  CompressionCmd = new G4UIcommand(cmdName,this);
+  CompressionCmd->SetGuidance("Set the compression of the ROOT file");
+  CompressionCmd->SetGuidance("1. algorithm: zlib, lzma, lz4, zstd or none");
+  CompressionCmd->SetGuidance("2. level from 1 to 9 (optional, ROOT default if omitted)");
+  G4UIparameter* algorithmParam = new G4UIparameter("algorithm",'s',false);
+  algorithmParam->SetParameterCandidates("zlib lzma lz4 zstd none");
+  CompressionCmd->SetParameter(algorithmParam);
+  G4UIparameter* levelParam = new G4UIparameter("level",'i',true);
+  levelParam->SetDefaultValue(-1);
+  CompressionCmd->SetParameter(levelParam);
+
+  cmdName = GetDirectoryName()+"setBasketSize";
+  BasketSizeCmd = new G4UIcmdWithAnInteger(cmdName,this);
+  BasketSizeCmd->SetGuidance("Set the size in bytes of the baskets of each branch of the trees");
+  BasketSizeCmd->SetParameterName("Size",false);
+  BasketSizeCmd->SetRange("Size>0");
+
+  cmdName = GetDirectoryName()+"setAutoFlush";
+  AutoFlushCmd = new G4UIcmdWithAnInteger(cmdName,this);
+  AutoFlushCmd->SetGuidance("Set how often the baskets of the trees are flushed to the file");
+  AutoFlushCmd->SetGuidance("1. number of entries if > 0, number of bytes if < 0, 0 disables it");
+  AutoFlushCmd->SetParameterName("N",false);
+
+  cmdName = GetDirectoryName()+"setAutoSave";
+  AutoSaveCmd = new G4UIcmdWithAnInteger(cmdName,this);
+  AutoSaveCmd->SetGuidance("Set how often the headers of the trees are saved in the file");
+  AutoSaveCmd->SetGuidance("1. number of entries if > 0, number of bytes if < 0");
+  AutoSaveCmd->SetParameterName("N",false);
+
+  cmdName = GetDirectoryName()+"disableHitBranch";
+  DisableHitBranchCmd = new G4UIcmdWithAString(cmdName,this);
+  DisableHitBranchCmd->SetGuidance("Do not book this branch of the Hits tree (may be repeated)");
+  DisableHitBranchCmd->SetParameterName("Name",false);
+
   cmdName = GetDirectoryName()+"setCoincidenceMask";
   CoincidenceMaskCmd = new G4UIcommand(cmdName,this);
   CoincidenceMaskCmd->SetGuidance("Set the mask for the coincidence ASCII output");
@@ -115,6 +150,11 @@ GateToRootMessenger::~GateToRootMessenger()
   delete CoincidenceMaskCmd;
   delete SingleMaskCmd;
   delete SaveRndmCmd;
+  delete CompressionCmd;
+  delete BasketSizeCmd;
+  delete AutoFlushCmd;
+  delete AutoSaveCmd;
+  delete DisableHitBranchCmd;
   for (size_t i = 0; i<OutputChannelCmdList.size() ; ++i)
     delete OutputChannelCmdList[i];
 }
@@ -139,6 +179,22 @@ void GateToRootMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
     m_gateToRoot->SetRootOpticalFlag(RootOpticalCmd->GetNewBoolValue(newValue));
   } else if (command == RootRecordCmd) {
 	  m_gateToRoot->SetRecordFlag(RootRecordCmd->GetNewBoolValue(newValue));
+  } else if (command == CompressionCmd) {
+    G4String algorithm;
+    G4int level = -1;
+    std::istringstream is(newValue);
+    is >> algorithm >> level;
+    if (!m_gateToRoot->GetStorageSettings().set_compression(algorithm, level))
+      GateError("Unknown ROOT compression algorithm '" << algorithm << "'");
+  } else if (command == BasketSizeCmd) {
+    m_gateToRoot->GetStorageSettings().basket_size = BasketSizeCmd->GetNewIntValue(newValue);
+  } else if (command == AutoFlushCmd) {
+    m_gateToRoot->GetStorageSettings().has_auto_flush = true;
+    m_gateToRoot->GetStorageSettings().auto_flush = AutoFlushCmd->GetNewIntValue(newValue);
+  } else if (command == AutoSaveCmd) {
+    m_gateToRoot->GetStorageSettings().auto_save = AutoSaveCmd->GetNewIntValue(newValue);
+  } else if (command == DisableHitBranchCmd) {
+    m_gateToRoot->DisableHitBranch(newValue);
 	} else if ( IsAnOutputChannelCmd(command) ) {
 
     ExecuteOutputChannelCmd(command,newValue);
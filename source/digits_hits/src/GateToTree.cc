@@ -172,6 +172,7 @@ GateToTree::GateToTree(const G4String &name, GateOutputMgr *outputMgr, DigiMode
 
     m_messenger = new GateToTreeMessenger(this);
     m_hits_enabled = false;
+    m_npy_one_file_per_column = false;
 }
 
 void GateToTree::RecordBeginOfAcquisition()
@@ -187,7 +188,7 @@ void GateToTree::RecordBeginOfAcquisition()
         auto name = removeExtension(fileName);
 
         G4String hits_filename = name + ".hits." + extension;
-        m_manager_hits.add_file(hits_filename, extension);
+        m_manager_hits.add_file(hits_filename, getFileKind(extension));
       }
 
       if(m_hitsParams_to_write.at("PDGEncoding").toSave())
@@ -351,7 +352,7 @@ void GateToTree::RecordBeginOfAcquisition()
       auto name = removeExtension(fileName);
 
       G4String hits_filename = name + ".optical." + extension;
-      m_manager_optical.add_file(hits_filename, extension);
+      m_manager_optical.add_file(hits_filename, getFileKind(extension));
     }
 
     if(m_opticalParams_to_write.at("NumScintillation").toSave())
@@ -998,6 +999,18 @@ void GateToTree::addFileName(const G4String &s)
   m_listOfFileName.push_back(s);
 }
 
+void GateToTree::setNumpyOneFilePerColumn(G4bool b)
+{
+  m_npy_one_file_per_column = b;
+}
+
+std::string GateToTree::getFileKind(const std::string &extension) const
+{
+  if(extension == "npy" && m_npy_one_file_per_column)
+    return "npycolumns";
+  return extension;
+}
+
 G4bool GateToTree::getHitsEnabled() const
 {
   return m_hits_enabled;
@@ -1027,7 +1040,7 @@ void GateToTree::addCollection(const std::string &str)
         auto name = removeExtension(fileName);
 
         G4String n_fileName = name + "." + str + "." + extension;
-        m.add_file(n_fileName, extension);
+        m.add_file(n_fileName, getFileKind(extension));
 
       }
       m_mmanager_singles.emplace(str, std::move(m));
@@ -1050,7 +1063,7 @@ void GateToTree::addCollection(const std::string &str)
         auto name = removeExtension(fileName);
 
         G4String n_fileName = name + "." + str + "." + extension;
-        m.add_file(n_fileName, extension);
+        m.add_file(n_fileName, getFileKind(extension));
       }
       m_mmanager_coincidences.emplace(str, std::move(m));
       return;
@@ -13,10 +13,15 @@ See LICENSE.md for further details
 
 #include "GateToTreeMessenger.hh"
 #include "GateToTree.hh"
+#include "GateRootTreeFile.hh"
+#include "GateMessageManager.hh"
+
+#include <sstream>
 
 
 #include "G4UIcmdWithAString.hh"
 #include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAnInteger.hh"
 #include "G4UIcmdWithoutParameter.hh"
 
 GateToTreeMessenger::GateToTreeMessenger(GateToTree *m) :
@@ -42,6 +47,32 @@ GateToTreeMessenger::GateToTreeMessenger(GateToTree *m) :
   cmdName = GetDirectoryName() + "addCollection";
   m_addCollectionCmd = new G4UIcmdWithAString(cmdName, this);
 
+  cmdName = GetDirectoryName() + "setNumpyOneFilePerColumn";
+  m_npyOneFilePerColumnCmd = new G4UIcmdWithABool(cmdName, this);
+  m_npyOneFilePerColumnCmd->SetGuidance("Write each variable of the .npy outputs in its own file (must be set before addCollection)");
+  m_npyOneFilePerColumnCmd->SetParameterName("flag", false);
+
+  cmdName = GetDirectoryName() + "setRootCompression";
+  m_rootCompressionCmd = new G4UIcommand(cmdName, this);
+  m_rootCompressionCmd->SetGuidance("Set the compression of the .root outputs: algorithm (zlib, lzma, lz4, zstd or none) and optional level");
+  auto algorithm_param = new G4UIparameter("algorithm", 's', false);
+  algorithm_param->SetParameterCandidates("zlib lzma lz4 zstd none");
+  m_rootCompressionCmd->SetParameter(algorithm_param);
+  auto level_param = new G4UIparameter("level", 'i', true);
+  level_param->SetDefaultValue(-1);
+  m_rootCompressionCmd->SetParameter(level_param);
+
+  cmdName = GetDirectoryName() + "setRootBasketSize";
+  m_rootBasketSizeCmd = new G4UIcmdWithAnInteger(cmdName, this);
+  m_rootBasketSizeCmd->SetGuidance("Set the size in bytes of the baskets of each branch of the .root outputs");
+  m_rootBasketSizeCmd->SetParameterName("size", false);
+  m_rootBasketSizeCmd->SetRange("size>0");
+
+  cmdName = GetDirectoryName() + "setRootAutoFlush";
+  m_rootAutoFlushCmd = new G4UIcmdWithAnInteger(cmdName, this);
+  m_rootAutoFlushCmd->SetGuidance("Flush the baskets of the .root outputs every N entries if N > 0, every -N bytes if N < 0, never if N = 0");
+  m_rootAutoFlushCmd->SetParameterName("N", false);
+
   for(auto &&m: m_gateToTree->getHitsParamsToWrite())
   {
     auto name = m.first;
@@ -85,6 +116,10 @@ GateToTreeMessenger::~GateToTreeMessenger()
   delete m_addFileNameCmd;
   delete m_enableHitsOutput;
   delete m_disableHitsOutput;
+  delete m_npyOneFilePerColumnCmd;
+  delete m_rootCompressionCmd;
+  delete m_rootBasketSizeCmd;
+  delete m_rootAutoFlushCmd;
 
 }
 
@@ -111,6 +146,27 @@ void GateToTreeMessenger::SetNewValue(G4UIcommand *icommand, G4String string)
   if(icommand == m_addCollectionCmd)
     m_gateToTree->addCollection(string);
 
+  if(icommand == m_npyOneFilePerColumnCmd)
+    m_gateToTree->setNumpyOneFilePerColumn(m_npyOneFilePerColumnCmd->GetNewBoolValue(string));
+
+  auto &root_settings = GateOutputRootTreeFile::storage_settings();
+  if(icommand == m_rootCompressionCmd)
+  {
+    std::string algorithm;
+    int level = -1;
+    std::istringstream is(string);
+    is >> algorithm >> level;
+    if(!root_settings.set_compression(algorithm, level))
+      GateError("Unknown ROOT compression algorithm '" << algorithm << "'");
+  }
+  if(icommand == m_rootBasketSizeCmd)
+    root_settings.basket_size = m_rootBasketSizeCmd->GetNewIntValue(string);
+  if(icommand == m_rootAutoFlushCmd)
+  {
+    root_settings.has_auto_flush = true;
+    root_settings.auto_flush = m_rootAutoFlushCmd->GetNewIntValue(string);
+  }
+
   auto c = static_cast<G4UIcmdWithoutParameter*>(icommand);
   if(m_maphits_cmdParameter_toTreeParameter.count(c))
   {
@@ -21,18 +21,48 @@ See LICENSE.md for further details
 #include "GateSteppingVerbose.hh"
 #include "G4SteppingManager.hh"
 #include "G4SliceTimer.hh"
+#include "G4Threading.hh"
 
 //class GateRecorderBase;
-GateUserActions* GateUserActions::pUserActions=0;
+G4ThreadLocal GateUserActions* GateUserActions::pUserActions=0;
 
 //-----------------------------------------------------------------------------
 GateUserActions::GateUserActions(GateRunManager* m)
 {
   GateMessage("Core", 4,"GateUserActions Constructor start.\n");
 
-  pUserActions = this;
-
   SetRunManager(m);
+  Initialize();
+
+  // Set fGate' user action classes to the GateRunmanager :
+  // Run/Event/Tracking/Stepping in order to get the callbacks
+  pRunManager->SetUserAction(runAction);
+  pRunManager->SetUserAction(eventAction);
+  pRunManager->SetUserAction(trackingAction);
+  pRunManager->SetUserAction(steppingAction);
+
+  //pRunManager->SetUserAction(dynamic_cast<G4UserRunAction *>(this)); //Don't know why this don't work
+  //pRunManager->SetUserAction(dynamic_cast<G4UserEventAction *>(this));
+  //pRunManager->SetUserAction(dynamic_cast<G4UserTrackingAction *>(this));
+  //pRunManager->SetUserAction(dynamic_cast<G4UserSteppingAction *>(this));
+
+  GateMessage("Core", 4,"GateUserActions Constructor end.\n");
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+GateUserActions::GateUserActions()
+{
+  GateMessage("Core", 4,"GateUserActions Constructor (thread " << G4Threading::G4GetThreadId() << ").\n");
+  SetRunManager(GateRunManager::GetRunManager());
+  Initialize();
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+void GateUserActions::Initialize()
+{
+  pUserActions = this;
 
   // Initialisation
   mCurrentRun = 0;
@@ -47,27 +77,12 @@ GateUserActions::GateUserActions(GateRunManager* m)
 
   mIsTimeStudyActivated = false;
 
-
-  // Set fGate' user action classes to the GateRunmanager :
-  // Run/Event/Tracking/Stepping in order to get the callbacks
-  GateRunAction* RunAction = new GateRunAction(this);
-  GateEventAction* EventAction = new GateEventAction(this);
-  GateTrackingAction* TrackingAction = new GateTrackingAction(this);
-  GateSteppingAction* SteppingAction = new GateSteppingAction(this);
-
-  pRunManager->SetUserAction(RunAction);
-  pRunManager->SetUserAction(EventAction);
-  pRunManager->SetUserAction(TrackingAction);
-  pRunManager->SetUserAction(SteppingAction);
-
-  //pRunManager->SetUserAction(dynamic_cast<G4UserRunAction *>(this)); //Don't know why this don't work
-  //pRunManager->SetUserAction(dynamic_cast<G4UserEventAction *>(this));
-  //pRunManager->SetUserAction(dynamic_cast<G4UserTrackingAction *>(this));
-  //pRunManager->SetUserAction(dynamic_cast<G4UserSteppingAction *>(this));
+  runAction = new GateRunAction(this);
+  eventAction = new GateEventAction(this);
+  trackingAction = new GateTrackingAction(this);
+  steppingAction = new GateSteppingAction(this);
 
   mTimer = new G4SliceTimer();
-
-  GateMessage("Core", 4,"GateUserActions Constructor end.\n");
 }
 //-----------------------------------------------------------------------------
 
@@ -8,15 +8,18 @@
 
 
 #include "G4Event.hh"
+#include "G4Threading.hh"
 
 #include "GateVActor.hh"
 #include "GateActorMessenger.hh"
 #include "GateActorManager.hh"
 #include "GateMiscFunctions.hh"
+#include "GateConfiguration.h"
 
 #include <sys/time.h>
 #include <stdio.h>
 #include <unistd.h>
+#include <algorithm>
 
 //-----------------------------------------------------------------------------
 GateVActor::GateVActor(G4String name, G4int depth)
@@ -37,6 +40,7 @@ GateVActor::GateVActor(G4String name, G4int depth)
   mVolume = 0;
   EnableSaveEveryNEvents(0);
   EnableSaveEveryNSeconds(0);
+  mNumberOfEventsSinceLastMerge = 0;
   mNumOfFilters = 0;
   mOverWriteFilesFlag = true;
   pFilterManager = new GateFilterManager(GetObjectName()+"_filter");
@@ -83,6 +87,41 @@ void GateVActor::EndOfEventAction(const G4Event*e)
 {
   int ne = e->GetEventID()+1;
 
+#ifdef GATE_USE_MT
+  // Worker threads do not save: their data are periodically merged into
+  // the master actor (about n events per save over all the threads, or
+  // every n seconds), which is then saved if needed.
+  if (G4Threading::IsWorkerThread()) {
+    bool merge = false;
+    mNumberOfEventsSinceLastMerge++;
+    if (mSaveEveryNEvents != 0) {
+      int n = std::max(1, mSaveEveryNEvents/std::max(1, G4Threading::GetNumberOfRunningWorkerThreads()));
+      merge = (ne % mSaveEveryNEvents == 0) || (mNumberOfEventsSinceLastMerge >= n);
+    }
+    if (mSaveEveryNSeconds != 0) {
+      struct timeval end;
+      gettimeofday(&end, NULL);
+      if (end.tv_sec - mTimeOfLastSaveEvent.tv_sec > mSaveEveryNSeconds) {
+        merge = true;
+        mTimeOfLastSaveEvent = end;
+      }
+    }
+    if (merge) {
+      mNumberOfEventsSinceLastMerge = 0;
+      GateActorManager::GetInstance()->MergeWorkerActorIntoMaster(this, ne);
+    }
+    return;
+  }
+#endif
+
+  SaveDataIfNeeded(ne);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateVActor::SaveDataIfNeeded(int ne)
+{
   // Save every n events
   if ((ne != 0) && (mSaveEveryNEvents != 0))
     if (ne % mSaveEveryNEvents == 0)  SaveData();
@@ -124,6 +163,15 @@ void GateVActor::AttachToVolume(G4String /*volumeName*/)
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+void GateVActor::MergeDataFrom(GateVActor * /*workerActor*/)
+{
+  GateError("The actor " << GetObjectName() << " (" << mTypeName
+            << ") does not support the multithreaded mode yet.");
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 void GateVActor::SaveData()
 {
@@ -20,7 +20,8 @@ GateVDigiMakerModule::GateVDigiMakerModule( GateDigitizer* itsDigitizer,
       	      	         	            const G4String& itsInputName)
   :GateClockDependent(itsDigitizer->GetObjectName() + "/" + itsInputName + "/digiMaker",false),
    m_digitizer(itsDigitizer),
-   m_inputName(itsInputName)
+   m_inputName(itsInputName),
+   m_inputSlot(-1)
 {
   G4String collectionName = itsInputName;
 
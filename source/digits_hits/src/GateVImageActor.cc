@@ -14,11 +14,18 @@
 #include "GateMiscFunctions.hh"
 #include "GateObjectStore.hh"
 #include "GateVImageVolume.hh"
+#include "GateImageRegularParametrisedVolume.hh"
+#include "GateImageNestedParametrisedVolume.hh"
 #include "GateUtilityForG4ThreeVector.hh"
 
 #include <G4Step.hh>
 #include <G4TouchableHistory.hh>
 #include <G4VoxelLimits.hh>
+#include <G4SystemOfUnits.hh>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
 
 //-----------------------------------------------------------------------------
 /// Constructor
@@ -33,7 +40,10 @@ GateVImageActor::GateVImageActor(G4String name, G4int depth):
   mVoxelSizeIsSet(false),
   mResolutionIsSet(false),
   mHalfSizeIsSet(false),
-  mPositionIsSet(false)
+  mPositionIsSet(false),
+  mVoxelCopyNumberType(NoVoxelCopyNumber),
+  mVoxelLogicalVolume(0),
+  mStepHitFraction(1.0)
 {
   GateMessageInc("Actor",4, "GateVImageActor() - begin\n");
   //pMessenger = new GateImageActorMessenger(this);
@@ -215,12 +225,52 @@ void GateVImageActor::Construct()
   GateMessage("Actor", 3, "GateVImageActor -- Construct(): voxelsize = " << mVoxelSize << Gateendl);
   GateMessage("Actor", 3, "GateVImageActor -- Construct(): hitType   = " << mStepHitTypeName << Gateendl);
 
+  if (mStepHitType == RayCastStepHitType && !IsRayCastStepHitTypeSupported())
+    GateError("GateVImageActor -- Construct: the 'raycast' stepHitType is not available for the actor " << GetObjectName());
+
+  InitializeVoxelCopyNumber();
+  mTouchableDepthCache = TouchableDepthCache();
+
   GateDebugMessageDec("Actor", 4, "GateVImageActor -- Construct: end\n");
 
 }
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+void GateVImageActor::InitializeVoxelCopyNumber()
+{
+  mVoxelCopyNumberType = NoVoxelCopyNumber;
+  mVoxelLogicalVolume = 0;
+
+  GateVImageVolume * volAsImage = dynamic_cast<GateVImageVolume*>(mVolume);
+  if (!volAsImage || !volAsImage->GetImage()) return;
+
+  // The actor grid must be exactly the grid of the image volume
+  const double tol = 1e-6*mm;
+  const GateImage * image = volAsImage->GetImage();
+  if (mPosition.mag() > tol ||
+      (mResolution - image->GetResolution()).mag() > 0.5 ||
+      (mVoxelSize - image->GetVoxelSize()).mag() > tol) return;
+
+  GateImageRegularParametrisedVolume * regular = dynamic_cast<GateImageRegularParametrisedVolume*>(mVolume);
+  // When equal materials are skipped, a step may cross several voxels
+  if (regular && !regular->GetSkipEqualMaterialsFlag()) {
+    mVoxelCopyNumberType = RegularVoxelCopyNumber;
+    mVoxelLogicalVolume = regular->GetVoxelLogicalVolume();
+  }
+  GateImageNestedParametrisedVolume * nested = dynamic_cast<GateImageNestedParametrisedVolume*>(mVolume);
+  if (nested) {
+    mVoxelCopyNumberType = NestedVoxelCopyNumber;
+    mVoxelLogicalVolume = nested->GetVoxelLogicalVolume();
+  }
+  if (mVoxelCopyNumberType != NoVoxelCopyNumber)
+    GateMessage("Actor", 2, "GateVImageActor -- " << GetObjectName()
+                << ": same grid as the image volume, voxel index taken from the copy numbers" << Gateendl);
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 void GateVImageActor::SetOriginTransformAndFlagToImage(GateImageWithStatistic & image)
 {
@@ -261,8 +311,9 @@ void GateVImageActor::SetStepHitType(G4String t)
   if (t == "random") { mStepHitType = RandomStepHitType; return; }
   if (t == "randomCylindricalCS") { mStepHitType = RandomStepHitTypeCylindricalCS; return;}
   if (t == "postCylindricalCS") { mStepHitType = PostStepHitTypeCylindricalCS; return;}
+  if (t == "raycast") { mStepHitType = RayCastStepHitType; return;}
 
-  GateError("GateVImageActor -- SetStepHitType: StepHitType is set to '" << t << "' while I only know 'pre', 'post', 'random' or 'middle'.");
+  GateError("GateVImageActor -- SetStepHitType: StepHitType is set to '" << t << "' while I only know 'pre', 'post', 'random', 'middle' or 'raycast'.");
 }
 //-----------------------------------------------------------------------------
 
@@ -311,11 +362,99 @@ void GateVImageActor::UserSteppingAction(const GateVVolume* , const G4Step * ste
 if (custmframe)
 
 else*/
+  if (mStepHitType == RayCastStepHitType) {
+    RayCastStepInVoxels(step);
+    return;
+  }
   int index = GetIndexFromStepPosition(GetVolume(), step);
   UserSteppingActionInVoxel(index, step);
 }
 //-----------------------------------------------------------------------------
 
+
+//-----------------------------------------------------------------------------
+void GateVImageActor::RayCastStepInVoxels(const G4Step * step)
+{
+  G4ThreeVector pre, post;
+  if (!GetStepPositionsInImageFrame(GetVolume(), step, mPositionIsSet, mPosition,
+                                    pre, post, &mTouchableDepthCache)) {
+    UserSteppingActionInVoxel(-1, step);
+    return;
+  }
+
+  // Segment p(t) = pre + t*d, t in [0,1]. Clip it to the image box.
+  const G4ThreeVector d = post - pre;
+  const G4ThreeVector halfSize = mImage.GetHalfSize();
+  const G4ThreeVector voxelSize = mImage.GetVoxelSize();
+  const G4ThreeVector resolution = mImage.GetResolution();
+  double tmin = 0.0;
+  double tmax = 1.0;
+  for (int a=0; a<3; a++) {
+    if (d[a] == 0) {
+      if (pre[a] < -halfSize[a] || pre[a] > halfSize[a]) tmax = -1.0;
+      continue;
+    }
+    double t0 = (-halfSize[a] - pre[a])/d[a];
+    double t1 = ( halfSize[a] - pre[a])/d[a];
+    if (t0 > t1) std::swap(t0, t1);
+    tmin = std::max(tmin, t0);
+    tmax = std::min(tmax, t1);
+  }
+
+  // Zero-length step (deposit at rest) or step outside the image: same as
+  // the 'pre' hit type
+  if (tmax <= tmin || d.mag2() == 0) {
+    UserSteppingActionInVoxel(mImage.GetIndexFromPostPositionAndDirection(pre, d), step);
+    return;
+  }
+
+  // First voxel: the one containing the middle of a tiny first segment,
+  // robust when the entry point is on a voxel boundary
+  int ijk[3], stepDir[3], n[3];
+  double tNext[3], tDelta[3];
+  const double tEntry = tmin + 1e-9*(tmax-tmin);
+  for (int a=0; a<3; a++) {
+    n[a] = (int)lrint(resolution[a]);
+    double x = (pre[a] + tEntry*d[a] + halfSize[a])/voxelSize[a];
+    ijk[a] = std::min(std::max((int)floor(x), 0), n[a]-1);
+    if (d[a] > 0) {
+      stepDir[a] = 1;
+      tDelta[a] = voxelSize[a]/d[a];
+      tNext[a] = (-halfSize[a] + (ijk[a]+1)*voxelSize[a] - pre[a])/d[a];
+    }
+    else if (d[a] < 0) {
+      stepDir[a] = -1;
+      tDelta[a] = -voxelSize[a]/d[a];
+      tNext[a] = (-halfSize[a] + ijk[a]*voxelSize[a] - pre[a])/d[a];
+    }
+    else {
+      stepDir[a] = 0;
+      tDelta[a] = DBL_MAX;
+      tNext[a] = DBL_MAX;
+    }
+  }
+
+  const int lineSize = mImage.GetLineSize();
+  const int planeSize = mImage.GetPlaneSize();
+  double t = tmin;
+  while (t < tmax) {
+    int a = 0;
+    if (tNext[1] < tNext[a]) a = 1;
+    if (tNext[2] < tNext[a]) a = 2;
+    const double tExit = std::min(tNext[a], tmax);
+    if (tExit > t) {
+      mStepHitFraction = tExit - t;
+      UserSteppingActionInVoxel(ijk[0] + ijk[1]*lineSize + ijk[2]*planeSize, step);
+    }
+    t = tExit;
+    ijk[a] += stepDir[a];
+    if (ijk[a] < 0 || ijk[a] >= n[a]) break;
+    tNext[a] += tDelta[a];
+  }
+  mStepHitFraction = 1.0;
+}
+//-----------------------------------------------------------------------------
+
 //-----------------------------------------------------------------------------
 int GateVImageActor::GetIndexFromTrackPosition(const GateVVolume * v , const G4Track * track)
 {
@@ -362,20 +501,75 @@ int GateVImageActor::GetIndexFromTrackPosition(const GateVVolume * v , const G4T
 //-----------------------------------------------------------------------------
 int GateVImageActor::GetIndexFromStepPosition(const GateVVolume * v, const G4Step * step)
 {
-  return GetIndexFromStepPosition2(v, step, mImage, mPositionIsSet, mPosition, mStepHitType);
+  // Fast path: the step is inside a voxel of the image volume which has
+  // the same grid as the actor. Steps do not cross voxel boundaries, so
+  // the pre, middle or random points are in the voxel of the pre step
+  // point. The post step point is excluded: on a boundary it is assigned
+  // to the next voxel.
+  if (mVoxelCopyNumberType != NoVoxelCopyNumber &&
+      (mStepHitType == PreStepHitType ||
+       mStepHitType == MiddleStepHitType ||
+       mStepHitType == RandomStepHitType)) {
+    const G4VTouchable * touchable = step->GetPreStepPoint()->GetTouchable();
+    if (touchable->GetVolume(0)->GetLogicalVolume() == mVoxelLogicalVolume) {
+      if (mVoxelCopyNumberType == RegularVoxelCopyNumber)
+        return touchable->GetReplicaNumber(0);
+      return mImage.GetIndexFromCoordinates(G4ThreeVector(touchable->GetReplicaNumber(1),
+                                                          touchable->GetReplicaNumber(2),
+                                                          touchable->GetReplicaNumber(0)));
+    }
+  }
+  return GetIndexFromStepPosition2(v, step, mImage, mPositionIsSet, mPosition, mStepHitType, &mTouchableDepthCache);
 }
 //-----------------------------------------------------------------------------
 
 
 //-----------------------------------------------------------------------------
-int GateVImageActor::GetIndexFromStepPosition2(const GateVVolume * v,
-                                               const G4Step * step,
-                                               const GateImage & image,
-                                               const bool mPositionIsSet,
-                                               const G4ThreeVector mPosition,
-                                               const StepHitType mStepHitType)
+int GateVImageActor::FindVolumeDepth(const G4VTouchable * touchable,
+                                     const G4LogicalVolume * target,
+                                     TouchableDepthCache * cache)
 {
-  if(v==0) return -1;
+  const int maxDepth = touchable->GetHistoryDepth();
+
+  // Same level as the previous step
+  if (cache && cache->target == target) {
+    int depth = maxDepth - cache->level;
+    if (depth >= 0 && depth < maxDepth &&
+        touchable->GetVolume(depth)->GetLogicalVolume() == cache->volume)
+      return depth;
+  }
+
+  // Walk the history, by pointer first then by name (a volume may be
+  // rebuilt with a new logical volume of the same name)
+  int depth = 0;
+  while (depth < maxDepth && touchable->GetVolume(depth)->GetLogicalVolume() != target) depth++;
+  if (depth >= maxDepth) {
+    depth = 0;
+    while (depth < maxDepth &&
+           touchable->GetVolume(depth)->GetLogicalVolume()->GetName() != target->GetName()) depth++;
+  }
+  if (depth >= maxDepth) return -1;
+
+  if (cache) {
+    cache->target = target;
+    cache->volume = touchable->GetVolume(depth)->GetLogicalVolume();
+    cache->level = maxDepth - depth;
+  }
+  return depth;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+bool GateVImageActor::GetStepPositionsInImageFrame(const GateVVolume * v,
+                                                   const G4Step * step,
+                                                   const bool mPositionIsSet,
+                                                   const G4ThreeVector & mPosition,
+                                                   G4ThreeVector & prePosition,
+                                                   G4ThreeVector & postPosition,
+                                                   TouchableDepthCache * cache)
+{
+  if(v==0) return false;
 
   const G4ThreeVector & worldPos = step->GetPostStepPoint()->GetPosition();
   const G4ThreeVector & worldPre =  step->GetPreStepPoint()->GetPosition() ;
@@ -388,24 +582,16 @@ int GateVImageActor::GetIndexFromStepPosition2(const GateVVolume * v,
 		   <<" -> target = "<<v->GetLogicalVolume()->GetName()<< Gateendl );
   GateDebugMessage("Step", 3, " worldPre = " << worldPre<< Gateendl);
   GateDebugMessage("Step", 3, " worldPos = " << worldPos<< Gateendl);
-  int depth = 0;
-  int transDepth = maxDepth;
-
-  while((depth<maxDepth) &&
-        (currentVol->GetName() != v->GetLogicalVolume()->GetName()))
-    //(currentVol != v->GetLogicalVolume())) //depth<=maxDepth or depth<maxDepth ? OK < only
-    {
-      depth++;
-      transDepth--;
-      currentVol = theTouchable->GetVolume(depth)->GetLogicalVolume();
-    }
-
-  if(depth>=maxDepth) return -1;
+  int depth = FindVolumeDepth(theTouchable, v->GetLogicalVolume(), cache);
+  if(depth<0) return false;
+  int transDepth = maxDepth - depth;
+  currentVol = theTouchable->GetVolume(depth)->GetLogicalVolume();
 
   GateDebugMessage("Step",3,"GateVImageActor -- GetIndexFromStepPosition: Logical volume "<<currentVol->GetName() <<" found! - Depth = "<<depth << Gateendl );
 
-  G4ThreeVector postPosition = theTouchable->GetHistory()->GetTransform(transDepth).TransformPoint(worldPos);
-  G4ThreeVector prePosition = theTouchable->GetHistory()->GetTransform(transDepth).TransformPoint(worldPre);
+  const G4AffineTransform & transform = theTouchable->GetHistory()->GetTransform(transDepth);
+  postPosition = transform.TransformPoint(worldPos);
+  prePosition = transform.TransformPoint(worldPre);
 
   if (mPositionIsSet) {
     GateDebugMessage("Step", 3, "GateVImageActor -- GetIndexFromStepPosition: Step postPosition (vol reference) = " << postPosition << Gateendl);
@@ -414,6 +600,23 @@ int GateVImageActor::GetIndexFromStepPosition2(const GateVVolume * v,
     prePosition -= mPosition;
     postPosition -= mPosition;
   }
+  return true;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+int GateVImageActor::GetIndexFromStepPosition2(const GateVVolume * v,
+                                               const G4Step * step,
+                                               const GateImage & image,
+                                               const bool mPositionIsSet,
+                                               const G4ThreeVector mPosition,
+                                               const StepHitType mStepHitType,
+                                               TouchableDepthCache * cache)
+{
+  G4ThreeVector prePosition, postPosition;
+  if (!GetStepPositionsInImageFrame(v, step, mPositionIsSet, mPosition, prePosition, postPosition, cache))
+    return -1;
 
   GateDebugMessage("Step", 2, "GateVImageActor -- GetIndexFromStepPosition:Actor  UserSteppingAction (type = " << mStepHitTypeName << ")\n"
 		   << "\tPreStep     = " << prePosition << Gateendl
@@ -0,0 +1,37 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See LICENSE.md for further details
+----------------------*/
+
+/*!
+  \class  GateActionInitialization
+  \brief  Builds the Gate user actions for the master and for each worker
+          thread (multithreaded mode, GATE_USE_MT).
+
+  In sequential mode the user actions are directly given to the run
+  manager by GateUserActions(GateRunManager*) and this class is not used.
+*/
+
+#ifndef GATEACTIONINITIALIZATION_HH
+#define GATEACTIONINITIALIZATION_HH
+
+#include "G4VUserActionInitialization.hh"
+
+//-----------------------------------------------------------------------------
+class GateActionInitialization : public G4VUserActionInitialization
+{
+public:
+  GateActionInitialization();
+  virtual ~GateActionInitialization();
+
+  /// Master thread: only the run action (actors are merged at end of run)
+  virtual void BuildForMaster() const;
+  /// Worker threads: all the user actions and the primary generator
+  virtual void Build() const;
+};
+//-----------------------------------------------------------------------------
+
+#endif /* end #define GATEACTIONINITIALIZATION_HH */
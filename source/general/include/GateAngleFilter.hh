@@ -46,6 +46,7 @@ public:
 private:
   G4ThreeVector mDirection;
   G4double mAngle;
+  G4double mCosAngle;
   GateAngleFilterMessenger * pAngleMessenger;
 
 };
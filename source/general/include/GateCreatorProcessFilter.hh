@@ -19,6 +19,9 @@
 #include "GateCreatorProcessFilterMessenger.hh"
 
 #include <list>
+#include <vector>
+
+class G4VProcess;
 
 class  GateCreatorProcessFilter : 
   public GateVFilter
@@ -30,6 +33,8 @@ class  GateCreatorProcessFilter :
     FCT_FOR_AUTO_CREATOR_FILTER(GateCreatorProcessFilter)
 
     virtual G4bool Accept(const G4Track*);
+    virtual void Initialize();
+    virtual G4bool IsTrackConstant() const { return true; }
 
     void AddCreatorProcess(const G4String& processName);
 
@@ -42,6 +47,9 @@ class  GateCreatorProcessFilter :
 
     GateCreatorProcessFilterMessenger * pMessenger;
 
+    // Processes already seen, with their decision (names compared once)
+    std::vector<const G4VProcess*> mKnownProcesses;
+    std::vector<G4bool> mKnownProcessesDecision;
 };
 
 MAKE_AUTO_CREATOR_FILTER(creatorProcessFilter,GateCreatorProcessFilter)
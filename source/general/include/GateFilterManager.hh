@@ -36,16 +36,39 @@ public:
   GateFilterManager(G4String name);
   virtual ~GateFilterManager();
 
+  // How the filters are combined (all must accept, or at least one)
+  enum OperatorType { kAnd, kOr };
+
   virtual G4bool Accept(const G4Step*) const;
   virtual G4bool Accept(const G4Track*) const;
 
-  void AddFilter(GateVFilter* filter){theFilters.push_back(filter);}
+  void AddFilter(GateVFilter* filter){theFilters.push_back(filter); mIsInitialized = false;}
   G4int GetNumberOfFilters(){return theFilters.size();}
+  void SetOperator(OperatorType o) { mOperator = o; }
+  OperatorType GetOperator() const { return mOperator; }
   void show();
 
+  // Initialize the filters and sort them: the track constant ones are
+  // fused in a single decision computed once per track, the others are
+  // evaluated at each step. Called at initialisation (or at first use).
+  void Initialize();
+
 protected:
+  G4bool AcceptTrackConstantFilters(const G4Track*) const;
+
   G4String mFilterName;
   std::vector<GateVFilter*> theFilters;
+  OperatorType mOperator;
+
+  bool mIsInitialized;
+  std::vector<GateVFilter*> mTrackConstantFilters;
+  std::vector<GateVFilter*> mStepFilters;
+
+  // Decision of the track constant filters for the last track
+  mutable const G4Track * mLastTrack;
+  mutable G4int mLastTrackID;
+  mutable G4int mLastEventID;
+  mutable G4bool mLastTrackDecision;
 
 private:
   
@@ -57,6 +57,10 @@ public:
   /// Allocates the data
   virtual void Allocate();
 
+  /// Releases the data, the layout (size, resolution, origin...) is kept
+  /// and the number of values is updated as in Allocate
+  void Deallocate();
+
   // Access to the image values
   /// Returns the value of the image at voxel of index provided
   inline PixelType GetValue(int index) const { return data[index]; }
@@ -94,6 +98,7 @@ public:
   PixelType GetNeighborValueFromCoordinate(const ESide & side, const G4ThreeVector & coord);
 
   void MergeDataByAddition(G4String filename);
+  void MergeDataByAddition(const GateImageT<PixelType> & image);
 
   // iterators
   iterator begin() { return data.begin(); }
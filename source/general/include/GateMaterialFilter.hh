@@ -16,6 +16,7 @@ See LICENSE.md for further details
 #include "GateVFilter.hh"
 #include "GateActorManager.hh"
 #include "GateMaterialFilterMessenger.hh"
+#include "G4Material.hh"
 
 class  GateMaterialFilter : 
   public GateVFilter
@@ -28,14 +29,21 @@ public:
 
   virtual G4bool Accept(const G4Step*);
   virtual G4bool Accept(const G4Track*);
+  virtual void Initialize();
   void Add(const G4String& materialName);
   virtual void show();
 
 private:
+ G4bool AcceptMaterial(const G4Material * m);
+
  std::vector<G4String> theMdef;
  GateMaterialFilterMessenger * pMatMessenger;
  
  int nFilteredParticles;
+
+ // Decision by material index (G4Material::GetIndex), names compared only once
+ enum { kUnknown = 0, kAccepted, kRejected };
+ std::vector<char> mDecisionByMaterialIndex;
 };
 
 MAKE_AUTO_CREATOR_FILTER(materialFilter,GateMaterialFilter)
@@ -36,6 +36,8 @@ public:
   FCT_FOR_AUTO_CREATOR_FILTER(GateParticleFilter)
 
   virtual G4bool Accept(const G4Track *);
+  virtual void Initialize();
+  virtual G4bool IsTrackConstant() const { return true; }
 
   void Add(const G4String &particleName);
   void AddZ(const G4int &particleZ);
@@ -57,6 +59,12 @@ private:
   GateParticleFilterMessenger *pPartMessenger;
 
   int nFilteredParticles;
+
+  // Decision for the name, Z, A and PDG lists, which only depends on the
+  // particle definition: computed once and cached by definition index
+  G4bool AcceptDefinition(const G4ParticleDefinition * p) const;
+  enum { kUnknown = 0, kAccepted, kRejected };
+  std::vector<char> mDecisionByDefinitionID;
 };
 
 MAKE_AUTO_CREATOR_FILTER(particleFilter, GateParticleFilter)
@@ -51,6 +51,7 @@ private:
   G4int    m_nTotalEvents;
   G4int    m_printModulo;
   G4int    m_nVerboseLevel;
+  G4int    m_lastRunID;
   G4bool   m_useGPS;
 };
 
@@ -24,6 +24,8 @@ See LICENSE.md for further details
 #include "TROOT.h"
 #include "TTree.h"
 
+#include <set>
+
 #include "G4PhysicalConstants.hh"
 #include "G4SystemOfUnits.hh"
 
@@ -213,8 +215,17 @@ class GateHitTree : public  TTree
       {}
     virtual inline ~GateHitTree() {}
 
+    //! Branches not created by Init
+    void SetDisabledBranches(const std::set<G4String>& names) { m_disabledBranches = names; }
+
     void Init(GateRootHitBuffer& buffer);
     static void SetBranchAddresses(TTree* hitTree,GateRootHitBuffer& buffer);
+
+  private:
+    void AddBranch(const char* name, void* address, const char* leaflist);
+
+    std::set<G4String> m_disabledBranches;
+    std::set<G4String> m_skippedBranches;
 };
 
 
@@ -20,6 +20,9 @@
   - RunInitialisation(): overload of G4RunManager()::RunInitialisation() that resets the geometry
   navigator.
 
+  - When GATE is built with GATE_USE_MT, GateRunManager derives from G4MTRunManager and lives in
+  the master thread; the user actions of the worker threads are built by GateActionInitialization.
+
   \sa GateSystemComponent, GateBoxCreatorComponent, GateArrayRepeater
 */
 
@@ -27,13 +30,23 @@
 #ifndef GateRunManager_h
 #define GateRunManager_h 1
 
+#include "GateConfiguration.h"
 #include "G4RunManager.hh"
+#ifdef GATE_USE_MT
+#include "G4MTRunManager.hh"
+#endif
 #include "GateHounsfieldToMaterialsBuilder.hh"
 
 class GateRunManagerMessenger;
 class GateDetectorConstruction;
 
-class GateRunManager : public G4RunManager
+#ifdef GATE_USE_MT
+typedef G4MTRunManager GateRunManagerBase;
+#else
+typedef G4RunManager GateRunManagerBase;
+#endif
+
+class GateRunManager : public GateRunManagerBase
 {
 public:
   //! Constructor
@@ -59,9 +72,24 @@ public:
   void RunInitialization();
 
   //! Return the instance of the run manager
+#ifdef GATE_USE_MT
+  //! (always the master one, worker threads own a G4WorkerRunManager)
+  static GateRunManager* GetRunManager()
+  {	return dynamic_cast<GateRunManager*>(G4MTRunManager::GetMasterRunManager()); }
+
+  //! The user actions and the current run belong to the calling thread
+  const G4UserSteppingAction* GetUserSteppingAction() const
+  {	return G4RunManager::GetRunManager()->GetUserSteppingAction(); }
+  const G4Run* GetCurrentRun() const
+  {	return G4RunManager::GetRunManager()->GetCurrentRun(); }
+#else
   static GateRunManager* GetRunManager()
   {	return dynamic_cast<GateRunManager*>(G4RunManager::GetRunManager()); }
 
+  //! Only meaningful with GATE_USE_MT, print a warning otherwise
+  void SetNumberOfThreads(G4int n);
+#endif
+
   bool GetGlobalOutputFlag() { return mGlobalOutputFlag; }
   void EnableGlobalOutput(bool b) { mGlobalOutputFlag = b; }
   void SetUserPhysicList(G4VUserPhysicsList * m) { mUserPhysicList = m; }
@@ -37,7 +37,15 @@ public:
   virtual G4bool Accept(const G4Step*);
   virtual G4bool Accept(const G4Track*);
 
- 
+  // Called once the geometry and the physics are built (and before the
+  // first event) to resolve the names given by the messenger to pointers
+  virtual void Initialize() {}
+
+  // True if the decision only depends on the track and not on the
+  // current step (e.g. particle type): GateFilterManager then evaluates
+  // it once per track
+  virtual G4bool IsTrackConstant() const { return false; }
+
   virtual void show();
 
  
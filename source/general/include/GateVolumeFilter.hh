@@ -41,7 +41,7 @@ public:
 
   virtual void show();
 
-  void Initialize();
+  virtual void Initialize();
 
 private:
 
@@ -0,0 +1,53 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See LICENSE.md for further details
+----------------------*/
+
+#include "GateActionInitialization.hh"
+#include "GateUserActions.hh"
+#include "GateActions.hh"
+#include "GatePrimaryGeneratorAction.hh"
+#include "GateMessageManager.hh"
+
+//-----------------------------------------------------------------------------
+GateActionInitialization::GateActionInitialization()
+  : G4VUserActionInitialization()
+{
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+GateActionInitialization::~GateActionInitialization()
+{
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+void GateActionInitialization::BuildForMaster() const
+{
+  GateMessage("Core", 4, "GateActionInitialization::BuildForMaster\n");
+  GateUserActions * actions = new GateUserActions();
+  SetUserAction(actions->GetRunAction());
+
+  // Not given to the master run manager (no event loop on the master), it
+  // is only created so that the /gate/generator commands exist on the master
+  // and can be broadcast to the workers.
+  new GatePrimaryGeneratorAction();
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+void GateActionInitialization::Build() const
+{
+  GateMessage("Core", 4, "GateActionInitialization::Build\n");
+  GateUserActions * actions = new GateUserActions();
+  SetUserAction(actions->GetRunAction());
+  SetUserAction(actions->GetEventAction());
+  SetUserAction(actions->GetTrackingAction());
+  SetUserAction(actions->GetSteppingAction());
+  SetUserAction(new GatePrimaryGeneratorAction());
+}
+//-----------------------------------------------------------------------------
@@ -15,6 +15,7 @@ GateAngleFilter::GateAngleFilter(G4String name)
 {
   //mDirection;
   mAngle = 360.;
+  mCosAngle = std::cos(mAngle);
   pAngleMessenger = new GateAngleFilterMessenger(this);
 
 }
@@ -27,7 +28,7 @@ G4bool GateAngleFilter::Accept(const G4Track* aTrack)
   G4ThreeVector stepdirection = aTrack->GetMomentumDirection();
   if(stepdirection.x()*mDirection.x()
      + stepdirection.y()*mDirection.y()
-     + stepdirection.z()*mDirection.z() < std::cos(mAngle) ) return false;
+     + stepdirection.z()*mDirection.z() < mCosAngle ) return false;
 
   return true;
 }
@@ -60,5 +61,6 @@ void GateAngleFilter::SetMomentum(G4ThreeVector direction)
 void GateAngleFilter::SetAngle(G4double angle)
 {
   mAngle = angle;
+  mCosAngle = std::cos(mAngle);
 }
 //---------------------------------------------------------------------------
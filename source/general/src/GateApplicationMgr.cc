@@ -21,6 +21,7 @@
 #include "GateVSource.hh"
 #include "GateSourceMgr.hh"
 #include "GateOutputMgr.hh"
+#include "GateConfiguration.h"
 #include <algorithm> /* min and max */
 
 GateApplicationMgr* GateApplicationMgr::instance = 0;
@@ -334,6 +335,20 @@ void GateApplicationMgr::StartDAQ()
   // filename given. In this case we disable the output module and send a warning.
   GateOutputMgr::GetInstance()->CheckFileNameForAllOutput();
 
+#ifdef GATE_USE_MT
+  // Only actors are merged across threads for now: output modules and
+  // time driven acquisitions are not supported in multithreaded mode
+  // (the events are tracked by the worker threads, the output modules would
+  // only receive the begin/end of run of the master thread)
+  if (GetOutputMode() && GateOutputMgr::GetInstance()->GetNumberOfEnabledModules() > 0)
+    GateError("Output modules are not supported in multithreaded mode (GATE_USE_MT), "
+              << GateOutputMgr::GetInstance()->GetNumberOfEnabledModules() << " module(s) enabled. "
+              << "Please disable them and use actors only, or a sequential build of Gate.\n");
+  if (!mATotalAmountOfPrimariesIsRequested && !mReadNumberOfPrimariesInAFileIsUsed)
+    GateError("Only a fixed number of primaries (setTotalNumberOfPrimaries or "
+              << "readNumberOfPrimariesInAFile) is supported in multithreaded mode (GATE_USE_MT).\n");
+#endif
+
   GateMessage("Acquisition", 0,"  \n");
   GateMessage("Acquisition", 0, "============= Source initialization =============\n");
 
@@ -27,24 +27,39 @@ GateCreatorProcessFilter::~GateCreatorProcessFilter()
 //---------------------------------------------------------------------------
 
 
+//---------------------------------------------------------------------------
+void GateCreatorProcessFilter::Initialize()
+{
+  mKnownProcesses.clear();
+  mKnownProcessesDecision.clear();
+}
+//---------------------------------------------------------------------------
+
 //---------------------------------------------------------------------------
 G4bool GateCreatorProcessFilter::Accept(const G4Track* aTrack) 
 {
   const G4VProcess *creatorProcess = aTrack->GetCreatorProcess();
   if (!creatorProcess) return false;
 
+  for (size_t i=0; i<mKnownProcesses.size(); i++)
+    if (mKnownProcesses[i] == creatorProcess) return mKnownProcessesDecision[i];
+
+  G4bool decision = false;
   G4String creatorProcessName = creatorProcess->GetProcessName();
   for (CreatorProcesses::const_iterator iter=creatorProcesses.begin(); iter!=creatorProcesses.end(); iter++)
     if (*iter==creatorProcessName)
-      return true;
-
-  return false;
+      decision = true;
+  mKnownProcesses.push_back(creatorProcess);
+  mKnownProcessesDecision.push_back(decision);
+  return decision;
 }
+//---------------------------------------------------------------------------
 
 //---------------------------------------------------------------------------
 void GateCreatorProcessFilter::AddCreatorProcess(const G4String& processName)
 {
   creatorProcesses.push_back(processName);
+  Initialize();
 }
 //---------------------------------------------------------------------------
 
@@ -9,6 +9,7 @@ See LICENSE.md for further details
 
 #include "GateFilterManager.hh"
 #include "GateMessageManager.hh"
+#include "GateActorManager.hh"
 
 
 //---------------------------------------------------------------------------
@@ -17,6 +18,12 @@ GateFilterManager::GateFilterManager(G4String name)
 {
   theFilters.clear();
   mFilterName = name;
+  mOperator = kAnd;
+  mIsInitialized = false;
+  mLastTrack = 0;
+  mLastTrackID = -1;
+  mLastEventID = -1;
+  mLastTrackDecision = true;
 }
 //---------------------------------------------------------------------------
 
@@ -39,31 +46,78 @@ GateFilterManager::~GateFilterManager()
 //---------------------------------------------------------------------------
 
 
+//---------------------------------------------------------------------------
+void GateFilterManager::Initialize()
+{
+  mTrackConstantFilters.clear();
+  mStepFilters.clear();
+  for(unsigned int i = 0;i<theFilters.size();i++) {
+    theFilters[i]->Initialize();
+    if (theFilters[i]->IsTrackConstant()) mTrackConstantFilters.push_back(theFilters[i]);
+    else mStepFilters.push_back(theFilters[i]);
+  }
+  mLastTrack = 0;
+  mIsInitialized = true;
+}
+//---------------------------------------------------------------------------
+
+
+//---------------------------------------------------------------------------
+G4bool GateFilterManager::AcceptTrackConstantFilters(const G4Track* aTrack) const
+{
+  // G4Track objects are recycled: the event and track IDs identify the track
+  G4int eventID = GateActorManager::GetInstance()->GetCurrentEventId();
+  if (aTrack != mLastTrack || aTrack->GetTrackID() != mLastTrackID || eventID != mLastEventID) {
+    mLastTrack = aTrack;
+    mLastTrackID = aTrack->GetTrackID();
+    mLastEventID = eventID;
+    // kAnd: accepted unless one filter rejects, kOr: the opposite
+    bool defaultDecision = (mOperator == kAnd);
+    mLastTrackDecision = defaultDecision;
+    for(unsigned int i = 0;i<mTrackConstantFilters.size();i++)
+      if (mTrackConstantFilters[i]->Accept(aTrack) != defaultDecision) {
+        mLastTrackDecision = !defaultDecision;
+        break;
+      }
+  }
+  return mLastTrackDecision;
+}
+//---------------------------------------------------------------------------
+
+
 //---------------------------------------------------------------------------
 G4bool GateFilterManager::Accept(const G4Step* aStep) const
 {
-//  std::vector<GateVFilter*>::iterator sit;
- // for(sit= theFilters.begin(); sit!=theFilters.end(); ++sit)
-      //if(!(*sit)->Accept(aStep)) return false;
+  if (!mIsInitialized) const_cast<GateFilterManager*>(this)->Initialize();
 
-  for(unsigned int i = 0;i<theFilters.size();i++)
-     if(!theFilters[i]->Accept(aStep)) return false;
+  if (mOperator == kAnd) {
+    if (!mTrackConstantFilters.empty() && !AcceptTrackConstantFilters(aStep->GetTrack())) return false;
+    for(unsigned int i = 0;i<mStepFilters.size();i++)
+      if(!mStepFilters[i]->Accept(aStep)) return false;
+    return true;
+  }
 
-  return true;
+  if (!mTrackConstantFilters.empty() && AcceptTrackConstantFilters(aStep->GetTrack())) return true;
+  for(unsigned int i = 0;i<mStepFilters.size();i++)
+    if(mStepFilters[i]->Accept(aStep)) return true;
+  return false;
 }
 //---------------------------------------------------------------------------
 
 //---------------------------------------------------------------------------
 G4bool GateFilterManager::Accept(const G4Track* aTrack) const
 {
-//  std::vector<GateVFilter*>::iterator sit;
- // for(sit= theFilters.begin(); sit!=theFilters.end(); ++sit)
-      //if(!(*sit)->Accept(aStep)) return false;
+  if (!mIsInitialized) const_cast<GateFilterManager*>(this)->Initialize();
 
+  if (mOperator == kAnd) {
     for(unsigned int i = 0;i<theFilters.size();i++)
       if(!theFilters[i]->Accept(aTrack)) return false;
+    return true;
+  }
 
-  return true;
+  for(unsigned int i = 0;i<theFilters.size();i++)
+    if(theFilters[i]->Accept(aTrack)) return true;
+  return false;
 }
 //---------------------------------------------------------------------------
 
@@ -71,7 +125,7 @@ G4bool GateFilterManager::Accept(const G4Track* aTrack) const
 
 //---------------------------------------------------------------------------
 void GateFilterManager::show(){
-  G4cout << "------Filter Manager: "<<mFilterName<<" ------\n";
+  G4cout << "------Filter Manager: "<<mFilterName<<" ("<<(mOperator == kAnd ? "and" : "or")<<") ------\n";
 
   std::vector<GateVFilter*>::iterator sit;
   for(sit= theFilters.begin(); sit!=theFilters.end(); ++sit)
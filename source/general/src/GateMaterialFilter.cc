@@ -34,29 +34,49 @@ GateMaterialFilter::~GateMaterialFilter()
 }
 //---------------------------------------------------------------------------
 
+//---------------------------------------------------------------------------
+void GateMaterialFilter::Initialize()
+{
+  // Resolve the names for the materials already built
+  const G4MaterialTable * table = G4Material::GetMaterialTable();
+  mDecisionByMaterialIndex.assign(table->size(), kUnknown);
+  for (size_t i = 0; i < table->size(); i++) {
+    mDecisionByMaterialIndex[i] = kRejected;
+    for (size_t j = 0; j < theMdef.size(); j++)
+      if (theMdef[j] == (*table)[i]->GetName()) mDecisionByMaterialIndex[i] = kAccepted;
+  }
+}
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+G4bool GateMaterialFilter::AcceptMaterial(const G4Material * m)
+{
+  // Materials created after Initialize are resolved at first use
+  size_t index = m->GetIndex();
+  if (index >= mDecisionByMaterialIndex.size()) mDecisionByMaterialIndex.resize(index+1, kUnknown);
+  char & decision = mDecisionByMaterialIndex[index];
+  if (decision == kUnknown) {
+    decision = kRejected;
+    for ( size_t i = 0; i < theMdef.size(); i++)
+      if ( theMdef[i] == m->GetName() ) decision = kAccepted;
+  }
+  if (decision == kRejected) return false;
+  nFilteredParticles++;
+  return true;
+}
+//---------------------------------------------------------------------------
+
 //---------------------------------------------------------------------------
 G4bool GateMaterialFilter::Accept(const G4Step* aStep) 
 {
-    for ( size_t i = 0; i < theMdef.size(); i++){
-      if ( theMdef[i] == aStep->GetPreStepPoint()->GetMaterial()->GetName() ) {
-        nFilteredParticles++;
-        return true;
-      } 
-    }
-  return false;
+  return AcceptMaterial(aStep->GetPreStepPoint()->GetMaterial());
 }
 //---------------------------------------------------------------------------
 
 //---------------------------------------------------------------------------
 G4bool GateMaterialFilter::Accept(const G4Track* aTrack) 
 {
-    for ( size_t i = 0; i < theMdef.size(); i++){ 	
-      if ( theMdef[i] == aTrack->GetMaterial()->GetName() ) {
-        nFilteredParticles++;
-        return true;
-      } 
-    }
-  return false;
+  return AcceptMaterial(aTrack->GetMaterial());
 }
 //---------------------------------------------------------------------------
 
@@ -67,6 +87,7 @@ void GateMaterialFilter::Add(const G4String& materialName)
     if ( theMdef[i] == materialName ) return;
   }
   theMdef.push_back(materialName);
+  mDecisionByMaterialIndex.clear();
 }
 //---------------------------------------------------------------------------
 
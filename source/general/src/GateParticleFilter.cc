@@ -9,6 +9,8 @@
 #include "GateUserActions.hh"
 #include "GateTrajectory.hh"
 
+#include <algorithm>
+
 //---------------------------------------------------------------------------
 GateParticleFilter::GateParticleFilter(G4String name)
   : GateVFilter(name)
@@ -30,107 +32,88 @@ GateParticleFilter::~GateParticleFilter()
 
 
 //---------------------------------------------------------------------------
-G4bool GateParticleFilter::Accept(const G4Track *aTrack)
+void GateParticleFilter::Initialize()
 {
-  std::vector<bool> acceptTemp;
+  mDecisionByDefinitionID.clear();
+}
+//---------------------------------------------------------------------------
+
 
+//---------------------------------------------------------------------------
+G4bool GateParticleFilter::AcceptDefinition(const G4ParticleDefinition * p) const
+{
   // Test the particle name, keep the particle if the name is in the list
-  acceptTemp.push_back(true);
   if (!thePdef.empty()) {
-    acceptTemp.back()=false;
-    for (size_t i = 0; i < thePdef.size(); i++) {
-      if (thePdef[i] == aTrack->GetDefinition()->GetParticleName() ||
-          (aTrack->GetDefinition()->GetParticleSubType() == "generic" && thePdef[i] == "GenericIon") ) {
-        nFilteredParticles++;
-        acceptTemp.back()=true;
-        break;
-      }
-    }
-  } // end thePdef !empty
-  if (!acceptTemp.back()) return false;
+    bool found = false;
+    for (size_t i = 0; i < thePdef.size() && !found; i++)
+      found = (thePdef[i] == p->GetParticleName() ||
+               (p->GetParticleSubType() == "generic" && thePdef[i] == "GenericIon"));
+    if (!found) return false;
+  }
 
   // Test the particle Z, keep the particle if Z is in the list
-  acceptTemp.push_back(true);
-  if (!thePdefZ.empty()) {
-    acceptTemp.back()=false;
-    for (size_t i = 0; i < thePdefZ.size(); i++) {
-      if (thePdefZ[i] == aTrack->GetDefinition()->GetAtomicNumber()) {
-        nFilteredParticles++;
-        acceptTemp.back()=true;
-        break;
-      }
-    }
-  } // end thePdefZ !empty
-  if (!acceptTemp.back()) return false;
-
-  //// Test the particle A
-  acceptTemp.push_back(true);
-  if (!thePdefA.empty()) {
-    acceptTemp.back()=false;
-    for (size_t i = 0; i < thePdefA.size(); i++) {
-      if (thePdefA[i] == aTrack->GetDefinition()->GetAtomicMass()) {
-        nFilteredParticles++;
-        acceptTemp.back()=true;
-        break;
-      }
-    }
-  } // end thePdefA !empty
-  if (!acceptTemp.back()) return false;
+  if (!thePdefZ.empty() &&
+      std::find(thePdefZ.begin(), thePdefZ.end(), p->GetAtomicNumber()) == thePdefZ.end()) return false;
+
+  // Test the particle A
+  if (!thePdefA.empty() &&
+      std::find(thePdefA.begin(), thePdefA.end(), p->GetAtomicMass()) == thePdefA.end()) return false;
 
   // Test the particle PDG
-  acceptTemp.push_back(true);
-  if (!thePdefPDG.empty()) {
-    acceptTemp.back()=false;
-    for (size_t i = 0; i < thePdefPDG.size(); i++) {
-      if (thePdefPDG[i] == aTrack->GetDefinition()->GetPDGEncoding()) {
-        nFilteredParticles++;
-        acceptTemp.back()=true;
-        break;
-      }
-    }
-  } // end thePdefPFG !empty
-  if (!acceptTemp.back()) return false;
+  if (!thePdefPDG.empty() &&
+      std::find(thePdefPDG.begin(), thePdefPDG.end(), p->GetPDGEncoding()) == thePdefPDG.end()) return false;
+
+  return true;
+}
+//---------------------------------------------------------------------------
+
+
+//---------------------------------------------------------------------------
+G4bool GateParticleFilter::Accept(const G4Track *aTrack)
+{
+  // Particle name, Z, A and PDG (string comparisons only at the first
+  // track of each particle type, ions included)
+  const G4ParticleDefinition * p = aTrack->GetDefinition();
+  G4int id = p->GetParticleDefinitionID();
+  if (id < 0) {
+    if (!AcceptDefinition(p)) return false;
+  }
+  else {
+    if (id >= (G4int)mDecisionByDefinitionID.size()) mDecisionByDefinitionID.resize(id+1, kUnknown);
+    char & decision = mDecisionByDefinitionID[id];
+    if (decision == kUnknown) decision = (AcceptDefinition(p) ? kAccepted : kRejected);
+    if (decision == kRejected) return false;
+  }
 
   // Test the parent
-  acceptTemp.push_back(true);
   if (!theParentPdef.empty()) {
-    acceptTemp.back()=false;
+    bool found = false;
     GateTrackIDInfo * trackInfo =
       GateUserActions::GetUserActions()->GetTrackIDInfo(aTrack->GetParentID());
-    while (trackInfo) {
-      for (size_t i = 0; i < theParentPdef.size(); i++) {
-        if (theParentPdef[i] == trackInfo->GetParticleName()) {
-          nFilteredParticles++;
-          acceptTemp.back()=true;
-          break;
-        }
-      }
-      if (acceptTemp.back() == true) break;
-      int id = trackInfo->GetParentID();
-      trackInfo = GateUserActions::GetUserActions()->GetTrackIDInfo(id);
+    while (trackInfo && !found) {
+      for (size_t i = 0; i < theParentPdef.size() && !found; i++)
+        found = (theParentPdef[i] == trackInfo->GetParticleName());
+      if (found) break;
+      int parentID = trackInfo->GetParentID();
+      trackInfo = GateUserActions::GetUserActions()->GetTrackIDInfo(parentID);
     }
+    if (!found) return false;
   } // end theParentPdef !empty
-  if (!acceptTemp.back()) return false;
 
   // Test the directParent
-  acceptTemp.push_back(true);
   if (!theDirectParentPdef.empty()) {
-    acceptTemp.back()=false;
+    bool found = false;
     GateTrackIDInfo * trackInfo =
       GateUserActions::GetUserActions()->GetTrackIDInfo(aTrack->GetParentID());
     if (trackInfo) {
-      for (size_t i = 0; i < theDirectParentPdef.size(); i++) {
-        if (theDirectParentPdef[i] == trackInfo->GetParticleName()) {
-          nFilteredParticles++;
-          acceptTemp.back()=true;
-          break;
-        }
-      }
+      for (size_t i = 0; i < theDirectParentPdef.size() && !found; i++)
+        found = (theDirectParentPdef[i] == trackInfo->GetParticleName());
     }
+    if (!found) return false;
   } // end theDirectParentPdef !empty
-  if (!acceptTemp.back()) return false;
 
   // Keep the track !
+  nFilteredParticles++;
   return true;
 }
 //---------------------------------------------------------------------------
@@ -142,6 +125,7 @@ void GateParticleFilter::Add(const G4String &particleName)
   for (size_t i = 0; i < thePdef.size(); i++) {
     if (thePdef[i] == particleName ) return;
   }
+  mDecisionByDefinitionID.clear();
   thePdef.push_back(particleName);
 }
 //---------------------------------------------------------------------------
@@ -153,6 +137,7 @@ void GateParticleFilter::AddZ(const G4int &particleZ)
   for (size_t i = 0; i < thePdefZ.size(); i++) {
     if (thePdefZ[i] == particleZ ) return;
   }
+  mDecisionByDefinitionID.clear();
   thePdefZ.push_back(particleZ);
 }
 //---------------------------------------------------------------------------
@@ -164,6 +149,7 @@ void GateParticleFilter::AddA(const G4int &particleA)
   for (size_t i = 0; i < thePdefA.size(); i++) {
     if (thePdefA[i] == particleA ) return;
   }
+  mDecisionByDefinitionID.clear();
   thePdefA.push_back(particleA);
 }
 //---------------------------------------------------------------------------
@@ -175,6 +161,7 @@ void GateParticleFilter::AddPDG(const G4int &particlePDG)
   for (size_t i = 0; i < thePdefPDG.size(); i++) {
     if (thePdefPDG[i] == particlePDG ) return;
   }
+  mDecisionByDefinitionID.clear();
   thePdefPDG.push_back(particlePDG);
 }
 //---------------------------------------------------------------------------
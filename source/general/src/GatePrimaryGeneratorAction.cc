@@ -11,6 +11,8 @@ See LICENSE.md for further details
 #include "G4GeneralParticleSource.hh"
 #include "G4ParticleGun.hh"
 #include "G4UImanager.hh"
+#include "G4RunManager.hh"
+#include "G4Run.hh"
 
 #include "Randomize.hh"
 #include "G4ios.hh"
@@ -36,6 +38,7 @@ GatePrimaryGeneratorAction::GatePrimaryGeneratorAction()
   m_nVerboseLevel = 0;
   m_particleGun  = 0;//new G4GeneralParticleSource();
   m_useGPS = false;
+  m_lastRunID = -1;
 }
 //---------------------------------------------------------------------------
 
@@ -90,19 +93,21 @@ void GatePrimaryGeneratorAction::GeneratePrimaries(G4Event* event)
 void GatePrimaryGeneratorAction::GenerateSimulationPrimaries(G4Event* event)
 {
   //! compute the right number of events per slice at this time
-  G4int eventID = event->GetEventID();
+  // In multithreaded mode the first event of a worker is not always
+  // event 0, so a new run is detected from the (thread local) run ID.
   GateSourceMgr* sourceMgr = GateSourceMgr::GetInstance();
-  if (eventID==0) {
-    const G4Run* currentRun = GateRunManager::GetRunManager()->GetCurrentRun();
+  const G4Run* currentRun = G4RunManager::GetRunManager()->GetCurrentRun();
+  if (currentRun->GetRunID() != m_lastRunID) {
     //if( currentRun->GetRunID()==0) sourceMgr->Initialization();
     sourceMgr->PrepareNextRun( currentRun );
+    m_lastRunID = currentRun->GetRunID();
     m_nEvents=0;
   }
 
   G4int numVertices = sourceMgr->PrepareNextEvent(event);
   //! stop the run if no particle has been generated by the source manager
   if (numVertices == 0) {
-    GateRunManager* runManager = GateRunManager::GetRunManager();
+    G4RunManager* runManager = G4RunManager::GetRunManager();
 
     runManager->AbortRun(true);
     if (m_nVerboseLevel>1) G4cout << "GatePrimaryGeneratorAction::GeneratePrimaries: numVertices == 0, run aborted \n";
@@ -17,6 +17,7 @@
 
 #include "GateOutputMgr.hh"
 #include "GateAnalysis.hh"
+#include "GateMessageManager.hh"
 
 static char *theDefaultOutputIDName[ROOT_OUTPUTIDSIZE] =
   {(char *)"baseID",
@@ -235,46 +236,59 @@ GateCrystalHit* GateRootHitBuffer::CreateHit()
 void GateHitTree::Init(GateRootHitBuffer& buffer)
 {
   SetAutoSave(1000);
-  Branch("PDGEncoding",    &buffer.PDGEncoding,"PDGEncoding/I");
-  Branch("trackID",        &buffer.trackID,"trackID/I");
-  Branch("parentID",       &buffer.parentID,"parentID/I");
-  Branch("trackLocalTime", &buffer.trackLocalTime,"trackLocalTime/D");
-  Branch("time",           &buffer.time,"time/D");
-  Branch("edep",           &buffer.edep,"edep/F");
-  Branch("stepLength",     &buffer.stepLength,"stepLength/F");
-  Branch("trackLength",    &buffer.trackLength,"trackLength/F");
-  Branch("posX",           &buffer.posX,"posX/F");
-  Branch("posY",           &buffer.posY,"posY/F");
-  Branch("posZ",           &buffer.posZ,"posZ/F");
-  Branch("localPosX",      &buffer.localPosX,"localPosX/F");
-  Branch("localPosY",      &buffer.localPosY,"localPosY/F");
-  Branch("localPosZ",      &buffer.localPosZ,"localPosZ/F");
-  Branch("momDirX",      &buffer.momDirX,"momDirX/F");
-  Branch("momDirY",      &buffer.momDirY,"momDirY/F");
-  Branch("momDirZ",      &buffer.momDirZ,"momDirZ/F");
+  AddBranch("PDGEncoding",    &buffer.PDGEncoding,"PDGEncoding/I");
+  AddBranch("trackID",        &buffer.trackID,"trackID/I");
+  AddBranch("parentID",       &buffer.parentID,"parentID/I");
+  AddBranch("trackLocalTime", &buffer.trackLocalTime,"trackLocalTime/D");
+  AddBranch("time",           &buffer.time,"time/D");
+  AddBranch("edep",           &buffer.edep,"edep/F");
+  AddBranch("stepLength",     &buffer.stepLength,"stepLength/F");
+  AddBranch("trackLength",    &buffer.trackLength,"trackLength/F");
+  AddBranch("posX",           &buffer.posX,"posX/F");
+  AddBranch("posY",           &buffer.posY,"posY/F");
+  AddBranch("posZ",           &buffer.posZ,"posZ/F");
+  AddBranch("localPosX",      &buffer.localPosX,"localPosX/F");
+  AddBranch("localPosY",      &buffer.localPosY,"localPosY/F");
+  AddBranch("localPosZ",      &buffer.localPosZ,"localPosZ/F");
+  AddBranch("momDirX",      &buffer.momDirX,"momDirX/F");
+  AddBranch("momDirY",      &buffer.momDirY,"momDirY/F");
+  AddBranch("momDirZ",      &buffer.momDirZ,"momDirZ/F");
 
   for (size_t d=0; d<ROOT_OUTPUTIDSIZE ; ++d)
-    Branch(outputIDName[d],(void *)(buffer.outputID+d),outputIDLeafList[d]);
-  Branch("photonID",       &buffer.photonID,"photonID/I");
-  Branch("nPhantomCompton",&buffer.nPhantomCompton,"nPhantomCompton/I");
-  Branch("nCrystalCompton",&buffer.nCrystalCompton,"nCrystalCompton/I");
-  Branch("nPhantomRayleigh",&buffer.nPhantomRayleigh,"nPhantomRayleigh/I");
-  Branch("nCrystalRayleigh",&buffer.nCrystalRayleigh,"nCrystalRayleigh/I");
-  Branch("primaryID",      &buffer.primaryID,"primaryID/I");
-  Branch("sourcePosX",     &buffer.sourcePosX,"sourcePosX/F");
-  Branch("sourcePosY",     &buffer.sourcePosY,"sourcePosY/F");
-  Branch("sourcePosZ",     &buffer.sourcePosZ,"sourcePosZ/F");
-  Branch("sourceID",       &buffer.sourceID,"sourceID/I");
-  Branch("eventID",        &buffer.eventID,"eventID/I");
-  Branch("runID",          &buffer.runID,"runID/I");
-  Branch("axialPos",       &buffer.axialPos,"axialPos/F");
-  Branch("rotationAngle",  &buffer.rotationAngle,"rotationAngle/F");
-  Branch("volumeID",       (void *)buffer.volumeID,"volumeID[10]/I");
-  Branch("processName",    (void *)buffer.processName,"processName/C");
-  Branch("comptVolName",   (void *)buffer.comptonVolumeName,"comptVolName/C");
-  Branch("RayleighVolName",   (void *)buffer.RayleighVolumeName,"RayleighVolName/C");
+    AddBranch(outputIDName[d],(void *)(buffer.outputID+d),outputIDLeafList[d]);
+  AddBranch("photonID",       &buffer.photonID,"photonID/I");
+  AddBranch("nPhantomCompton",&buffer.nPhantomCompton,"nPhantomCompton/I");
+  AddBranch("nCrystalCompton",&buffer.nCrystalCompton,"nCrystalCompton/I");
+  AddBranch("nPhantomRayleigh",&buffer.nPhantomRayleigh,"nPhantomRayleigh/I");
+  AddBranch("nCrystalRayleigh",&buffer.nCrystalRayleigh,"nCrystalRayleigh/I");
+  AddBranch("primaryID",      &buffer.primaryID,"primaryID/I");
+  AddBranch("sourcePosX",     &buffer.sourcePosX,"sourcePosX/F");
+  AddBranch("sourcePosY",     &buffer.sourcePosY,"sourcePosY/F");
+  AddBranch("sourcePosZ",     &buffer.sourcePosZ,"sourcePosZ/F");
+  AddBranch("sourceID",       &buffer.sourceID,"sourceID/I");
+  AddBranch("eventID",        &buffer.eventID,"eventID/I");
+  AddBranch("runID",          &buffer.runID,"runID/I");
+  AddBranch("axialPos",       &buffer.axialPos,"axialPos/F");
+  AddBranch("rotationAngle",  &buffer.rotationAngle,"rotationAngle/F");
+  AddBranch("volumeID",       (void *)buffer.volumeID,"volumeID[10]/I");
+  AddBranch("processName",    (void *)buffer.processName,"processName/C");
+  AddBranch("comptVolName",   (void *)buffer.comptonVolumeName,"comptVolName/C");
+  AddBranch("RayleighVolName",   (void *)buffer.RayleighVolumeName,"RayleighVolName/C");
   // HDS : record septal penetration
-  if (GateRootDefs::GetRecordSeptalFlag())	Branch("septalNb",   &buffer.septalNb,"septalNb/I");
+  if (GateRootDefs::GetRecordSeptalFlag())	AddBranch("septalNb",   &buffer.septalNb,"septalNb/I");
+
+  for (std::set<G4String>::const_iterator it = m_disabledBranches.begin(); it != m_disabledBranches.end(); ++it)
+    if (!m_skippedBranches.count(*it))
+      GateWarning("[GateHitTree] the disabled hit branch '" << *it << "' does not exist");
+}
+
+void GateHitTree::AddBranch(const char* name, void* address, const char* leaflist)
+{
+  if (m_disabledBranches.count(name)) {
+    m_skippedBranches.insert(name);
+    return;
+  }
+  Branch(name, address, leaflist);
 }
 
 void GateHitTree::SetBranchAddresses(TTree* hitTree,GateRootHitBuffer& buffer)
@@ -27,7 +27,7 @@
 #endif
 
 //----------------------------------------------------------------------------------------
-GateRunManager::GateRunManager():G4RunManager()
+GateRunManager::GateRunManager():GateRunManagerBase()
 {
   pMessenger = new GateRunManagerMessenger(this);
   mHounsfieldToMaterialsBuilder = new GateHounsfieldToMaterialsBuilder();
@@ -207,7 +207,7 @@ void GateRunManager::RunInitialization()
 
   // GateMessage("Core", 0, "Initialization of the run \n");
   // Perform a regular initialisation
-  G4RunManager::RunInitialization();
+  GateRunManagerBase::RunInitialization();
 
   // Initialization of the atom deexcitation processes
   // must be done after all other initialization
@@ -226,3 +226,15 @@ void GateRunManager::RunInitialization()
     ->LocateGlobalPointAndSetup(center,0,false);
 }
 //----------------------------------------------------------------------------------------
+
+
+#ifndef GATE_USE_MT
+//----------------------------------------------------------------------------------------
+void GateRunManager::SetNumberOfThreads(G4int n)
+{
+  if (n != 1)
+    GateWarning("GATE was not compiled with GATE_USE_MT, the simulation runs in a single thread ("
+                << n << " threads requested)");
+}
+//----------------------------------------------------------------------------------------
+#endif
@@ -12,6 +12,7 @@ See LICENSE.md for further details
 
 #include "G4UIcmdWithoutParameter.hh"
 #include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAnInteger.hh"
 #include "GateDetectorConstruction.hh"
 
 //----------------------------------------------------------------------------------------
@@ -26,6 +27,12 @@ GateRunManagerMessenger::GateRunManagerMessenger(GateRunManager* runManager)
 
   pRunEnableGlobalOutputCmd = new G4UIcmdWithABool("/gate/run/enableGlobalOutput",this);
   pRunEnableGlobalOutputCmd->SetGuidance("Enabled by default. Use 'false' only for applications that do not use 'systems' (PET, SPECT etc), it will be a bit faster.");
+
+  pRunSetNumberOfThreadsCmd = new G4UIcmdWithAnInteger("/gate/run/setNumberOfThreads",this);
+  pRunSetNumberOfThreadsCmd->SetGuidance("Set the number of worker threads (only with GATE compiled with GATE_USE_MT). Must be set before /gate/run/initialize.");
+  pRunSetNumberOfThreadsCmd->SetParameterName("N",false);
+  pRunSetNumberOfThreadsCmd->SetRange("N>0");
+  pRunSetNumberOfThreadsCmd->SetToBeBroadcasted(false);
 }
 //----------------------------------------------------------------------------------------
 
@@ -35,6 +42,7 @@ GateRunManagerMessenger::~GateRunManagerMessenger()
   delete pRunInitCmd;
   delete pRunGeomUpdateCmd;
   delete pRunEnableGlobalOutputCmd;
+  delete pRunSetNumberOfThreadsCmd;
 }
 //----------------------------------------------------------------------------------------
 
@@ -50,5 +58,8 @@ void GateRunManagerMessenger::SetNewValue(G4UIcommand* command, G4String newValu
   else if (command == pRunEnableGlobalOutputCmd) {
     pRunManager->EnableGlobalOutput(pRunEnableGlobalOutputCmd->GetNewBoolValue(newValue));
   }
+  else if (command == pRunSetNumberOfThreadsCmd) {
+    pRunManager->SetNumberOfThreads(pRunSetNumberOfThreadsCmd->GetNewIntValue(newValue));
+  }
 }
 //----------------------------------------------------------------------------------------
@@ -65,6 +65,7 @@ void GateVolumeFilter::addVolume(G4String volName)
 //---------------------------------------------------------------------------
 void GateVolumeFilter::Initialize()
 {
+  if (IsInitialized) return;
   IsInitialized=true;
   
   for(unsigned int k =0 ; k<theTempoListOfVolumeName.size();k++)
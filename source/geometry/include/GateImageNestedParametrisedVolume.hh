@@ -80,6 +80,10 @@ public:
 				   G4NavigationHistory & history) const;
   //-----------------------------------------------------------------------------
 
+  // Logical volume of the voxels: its copy number is the z index, the
+  // copy numbers of its mothers are the x then the y indexes
+  G4LogicalVolume * GetVoxelLogicalVolume() const { return logZRep; }
+
   // This function add multi-SD to the sub logical-volume
   virtual void PropagateSensitiveDetectorToChild(GateMultiSensitiveDetector *);
 
@@ -81,6 +81,9 @@ public:
   void SetSkipEqualMaterialsFlag(bool b);
   bool GetSkipEqualMaterialsFlag();
 
+  // Logical volume of the voxels (copy number = voxel index)
+  G4LogicalVolume * GetVoxelLogicalVolume() const { return mVoxelLog; }
+
 protected:
   // The messenger
   GateImageRegularParametrisedVolumeMessenger* pMessenger;
@@ -61,6 +61,12 @@ protected:
 protected:
   G4VSensitiveDetector * pSensitiveDetector;
   G4MultiFunctionalDetector* pMultiFunctionalDetector;
+
+  // Step dispatch table of the actors attached to this (logical) volume,
+  // with their filter (0 if none). The multi functional detector is only
+  // kept for the G4 bookkeeping (Initialize, EndOfEvent ...).
+  std::vector<GateVActor*> mActors;
+  std::vector<GateFilterManager*> mActorFilters;
 };
 
 #endif /* end #define GATEMSD_HH */
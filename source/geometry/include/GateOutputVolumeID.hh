@@ -57,6 +57,21 @@ inline GateOutputVolumeID::GateOutputVolumeID(size_t itsSize)
 {}
 
 
+/*! \class GateOutputVolumeIDHash
+    \brief Hash of a GateOutputVolumeID, to use output volume IDs as keys of unordered containers
+*/
+struct GateOutputVolumeIDHash
+{
+  inline size_t operator()(const GateOutputVolumeID& volumeID) const
+  {
+    size_t h = volumeID.size();
+    for (size_t i=0; i<volumeID.size(); ++i)
+      h = h*31 + static_cast<size_t>(volumeID[i]);
+    return h;
+  }
+};
+
+
 #define BASE_DEPTH    	   0
 #define RSECTOR_DEPTH      1
 #define MODULE_DEPTH       2
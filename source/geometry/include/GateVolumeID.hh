@@ -191,5 +191,23 @@ inline GateVolumeID::GateVolumeID()
 {}
 
 
+/*! \class GateVolumeIDHash
+    \brief Hash of a GateVolumeID (creator and copy-no of each level), consistent with operator==
+*/
+struct GateVolumeIDHash
+{
+  inline size_t operator()(const GateVolumeID& volumeID) const
+  {
+    size_t h = volumeID.size();
+    for (size_t i=0; i<volumeID.size(); ++i) {
+      const GateVolumeSelector& selector = volumeID[i];
+      h = h*31 + reinterpret_cast<size_t>(selector.GetCreator());
+      h = h*31 + static_cast<size_t>(selector.GetCopyNo());
+    }
+    return h;
+  }
+};
+
+
 #endif
 
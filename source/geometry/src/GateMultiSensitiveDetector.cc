@@ -15,6 +15,7 @@
 #define GATESDM_CC
 
 #include "GateMultiSensitiveDetector.hh"
+#include <algorithm>
 
 //-----------------------------------------------------------------------------
 GateMultiSensitiveDetector::GateMultiSensitiveDetector(G4String name)
@@ -80,7 +81,10 @@ void GateMultiSensitiveDetector::PrintAll()
 G4bool GateMultiSensitiveDetector::ProcessHits(G4Step* aStep, G4TouchableHistory*)
 {
   if(pSensitiveDetector) pSensitiveDetector->Hit(aStep);
-  if(pMultiFunctionalDetector) pMultiFunctionalDetector->Hit(aStep);
+  for(size_t i=0; i<mActors.size(); i++) {
+    if (mActorFilters[i] && !mActorFilters[i]->Accept(aStep)) continue;
+    mActors[i]->ProcessStep(aStep);
+  }
   return true;
 }
 //-----------------------------------------------------------------------------
@@ -101,6 +105,14 @@ void GateMultiSensitiveDetector::SetActor(GateVActor * actor)
   if(actor->GetNumberOfFilters()!=0)
     actor->SetFilter(actor->GetFilterManager());
   pMultiFunctionalDetector ->RegisterPrimitive(actor);
+
+  // The actor lists may be built several times (one per initialization)
+  std::vector<GateVActor*>::iterator it = std::find(mActors.begin(), mActors.end(), actor);
+  if (it == mActors.end()) {
+    mActors.push_back(actor);
+    mActorFilters.push_back(actor->GetFilterManagerIfAny());
+  }
+  else mActorFilters[it-mActors.begin()] = actor->GetFilterManagerIfAny();
 }
 //-----------------------------------------------------------------------------
 
@@ -34,6 +34,7 @@ public:
   read_from_string_f m_read_from_string;
   size_t m_index_of_this_data_in_header;
   size_t m_max_caracter_accepted_by_provided_read_buffer;
+  size_t m_nb_characters; // size of a written char array, not always '\0' terminated
 
 };
 
@@ -0,0 +1,70 @@
+//
+// Blocks of bytes written to output streams by a background thread
+//
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <set>
+#include <thread>
+#include <vector>
+
+
+// The output files hand their filled blocks to the writer instead of writing
+// them on the tracking thread. The queue is bounded: submit() waits while the
+// pending blocks exceed the capacity (back-pressure). A stream must not be
+// used directly while blocks for it are pending, wait(out) is called before
+// seeking or closing it.
+class GateAsyncBlockWriter
+{
+public:
+  static GateAsyncBlockWriter &instance();
+  ~GateAsyncBlockWriter();
+
+  // Disabled by default, the blocks are then written by the caller
+  void set_enabled(bool enabled);
+  bool is_enabled() const { return m_enabled; }
+  // Maximal size of the pending blocks (bytes)
+  void set_capacity(size_t capacity);
+
+  // Empty buffer, recycled from a written block when possible
+  std::vector<char> get_buffer();
+  // Queue the first 'size' bytes of the buffer for 'out'
+  void submit(std::ostream *out, std::vector<char> &&buffer, size_t size);
+  // Wait until the blocks of 'out' are written, false if one of them failed
+  bool wait(const std::ostream *out);
+  // Wait until all the blocks are written, the failures are kept for wait(out)
+  void wait();
+
+  // Time spent by submit() waiting for space in the queue (s)
+  double get_waiting_time() const { return m_waiting_time; }
+
+private:
+  GateAsyncBlockWriter();
+  void run();
+
+  struct Block
+  {
+    std::ostream *out;
+    std::vector<char> data;
+    size_t size;
+  };
+
+  bool m_enabled;
+  size_t m_capacity;
+  size_t m_pending_size;
+  const std::ostream *m_writing;   // stream of the block being written
+  bool m_stop;
+  std::set<const std::ostream*> m_failed;
+  double m_waiting_time;
+
+  std::deque<Block> m_blocks;
+  std::vector<std::vector<char>> m_free_buffers;
+  std::mutex m_mutex;
+  std::condition_variable m_block_submitted;
+  std::condition_variable m_block_written;
+  std::thread m_thread;
+};
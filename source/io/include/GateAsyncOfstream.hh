@@ -0,0 +1,57 @@
+//
+// Output file stream whose blocks are written by GateAsyncBlockWriter
+//
+
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+
+// Drop-in replacement of std::ofstream for the outputs that serialise their
+// records on the tracking thread (binary, ASCII). When the asynchronous writing
+// is enabled at open(), the bytes are gathered in blocks that are handed to
+// GateAsyncBlockWriter, flushes (std::endl) only reach the file at the end of
+// the block. Otherwise the stream is a plain std::ofstream.
+class GateAsyncOfstream : public std::ofstream
+{
+public:
+  GateAsyncOfstream();
+  ~GateAsyncOfstream();
+
+  void open(const std::string &name, std::ios_base::openmode mode = std::ios_base::out);
+  // Waits for the pending blocks, the stream is bad if one of them failed
+  void close();
+
+private:
+  class BlockBuffer : public std::streambuf
+  {
+  public:
+    explicit BlockBuffer(std::ostream *file);
+
+    void reset();
+    // Hands the current block to the writer
+    void submit();
+    // Waits for the blocks handed to the writer, false if one of them failed
+    bool wait();
+
+  protected:
+    int_type overflow(int_type c) override;
+    int sync() override;
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+  private:
+    std::ostream *m_file;
+    std::vector<char> m_block;
+    std::streamoff m_position; // position of the beginning of the block in the file
+    bool m_at_end;             // m_position is the end of the file
+    bool m_failed;
+
+    static const size_t s_block_size = 1 << 20;
+  };
+
+  std::ostream m_file; // on the std::filebuf, used by the writer thread
+  BlockBuffer m_buffer;
+};
@@ -12,6 +12,7 @@
 #include <typeinfo>
 #include <typeindex>
 #include <unordered_map>
+#include <memory>
 #include <stdexcept>
 #include <cxxabi.h>
 
@@ -33,6 +34,7 @@ public:
       m_size_of_data(size_of_data),
       m_numpy_format(numpy_format),
       m_nb_characters(0),
+      m_offset(0),
       m_type_index_read(type_index),
       buffer_read(0)
   {
@@ -44,6 +46,7 @@ public:
   const size_t m_size_of_data;
   const std::string m_numpy_format;
   size_t m_nb_characters;
+  size_t m_offset; // position in an entry
   std::string m_numpy_description;
 
   std::type_index m_type_index_read; // type index of read variable, in case where we want to read a string
@@ -92,7 +95,6 @@ protected:
   std::fstream m_file;
 
   uint64_t m_position_before_shape;
-  uint64_t m_position_after_shape;
 
   const std::string magic_prefix = "\x93NUMPY";
   std::unordered_map<std::type_index, std::string> m_tmap_cppToNumpy;
@@ -101,6 +103,10 @@ protected:
 };
 
 
+// Entries are packed in memory and written by blocks of about s_block_size
+// bytes. With one file per column, each variable is written in its own .npy
+// file ('<path without .npy>.<variable>.npy') so that a single field can be
+// memory-mapped with numpy.
 class GateOutputNumpyTreeFile: public GateNumpyTree, public GateOutputTreeFile
 {
 public:
@@ -112,11 +118,13 @@ public:
   void write_header() override ;
   void write() override ;
   virtual void fill() override;
+  void flush();
 
   void write_variable(const std::string &name, const void *p, std::type_index t_index) override;
   void write_variable(const std::string &name, const std::string *p, size_t nb_char)override ;
   void write_variable(const std::string &name, const char *p, size_t nb_char) override  ;
    void write_variable(const std::string &name, const int  *p, size_t n) override  ;
+  bool write_record(const GateTreeRecord &record) override;
 
   template<typename T >
   void write_variable(const std::string &name, const T *p)
@@ -124,8 +132,47 @@ public:
     register_variable(name, p);
   }
 
+protected:
+  explicit GateOutputNumpyTreeFile(bool one_file_per_column);
+
 private:
+  // A written .npy file and the variables it holds
+  struct OutputFile
+  {
+    std::fstream *file;
+    std::string path;
+    std::vector<size_t> variables;  // indexes in m_vector_of_pointer_to_data
+    size_t row_size;
+    uint64_t position_before_shape;
+    std::vector<char> buffer;       // entries not yet written
+    const char *row;                // packed row in the record, 0 if the variables are packed one by one
+  };
+
+  void write_header(OutputFile &output);
+  void pack(const GateNumpyData &d, char *dest);
+  std::string column_path(const std::string &name) const;
+
   bool m_write_header_called;
+  const GateTreeRecord *m_record; // the variables are fields of this record
+  bool m_one_file_per_column;
+  bool m_columns_open;
+  std::vector<std::unique_ptr<std::fstream>> m_column_files;
+  std::vector<OutputFile> m_outputs;
+  size_t m_nb_rows_per_block;
+  size_t m_nb_buffered_rows;
+
+  static const size_t s_block_size = 1 << 20;
+  static bool s_registered;
+};
+
+
+class GateOutputNumpyColumnsTreeFile: public GateOutputNumpyTreeFile
+{
+public:
+  GateOutputNumpyColumnsTreeFile();
+  static std::string _get_factory_name() { return "npycolumns"; }
+
+private:
   static bool s_registered;
 };
 
@@ -134,6 +181,7 @@ class GateInputNumpyTreeFile: public GateNumpyTree, public GateInputTreeFile
 {
 public:
   GateInputNumpyTreeFile();
+  ~GateInputNumpyTreeFile() override;
 
   void open(const std::string &name) override ;
   bool is_open() override;
@@ -152,11 +200,19 @@ public:
 
   bool has_variable(const std::string &name) override;
   std::type_index get_type_of_variable(const std::string &name) override;
+  bool get_column_view(const std::string &name, GateTreeColumnView &view) override;
 
 private:
+  void read_entrie_from_memory(const char *entry);
+
   size_t  m_length_of_file;
   static bool s_registered;
   bool m_read_header_called;
   size_t m_start_of_data;
+  size_t m_entry_size;
+  uint64_t m_current_entry;
+  // The file is memory-mapped when possible, the entries are then copied from
+  // the mapping instead of being read through m_file
+  const char *m_mapped_file;
 };
 
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <vector>
 
 #include "GateTreeFile.hh"
 #include "GateTreeFileManager.hh"
@@ -12,6 +13,28 @@
 class TFile;
 class TTree;
 
+// Storage options of the ROOT output files, the ROOT defaults are kept for
+// the options that are not set
+struct GateRootStorageSettings
+{
+  GateRootStorageSettings();
+
+  // Algorithm "zlib", "lzma", "lz4", "zstd" (ROOT >= 6.20) or "none", level
+  // from 1 to 9 (-1 keeps the default level). False if the name is unknown.
+  bool set_compression(const std::string &algorithm, int level = -1);
+
+  void apply(TFile *file) const;
+  // To be called once the branches are created (basket size of each branch)
+  void apply(TTree *tree) const;
+
+  int compression_algorithm;  // ROOT algorithm code, -1: default
+  int compression_level;      // -1: default
+  int basket_size;            // bytes, 0: default
+  bool has_auto_flush;
+  long long auto_flush;       // entries if > 0, bytes if < 0, 0 disables it
+  long long auto_save;        // same convention, 0: default
+};
+
 class GateRootTree : public GateTree
 {
 public:
@@ -70,6 +93,9 @@ class GateOutputRootTreeFile: public GateRootTree, public GateOutputTreeFile
 
   void set_tree_name(const std::string &name) override ;
 
+  // Settings applied to the files opened afterwards
+  static GateRootStorageSettings &storage_settings();
+
 
   void write_variable(const std::string &name, const void *p, std::type_index t_index) override;
   void write_variable(const std::string &name, const std::string *p, size_t nb_char)override ;
@@ -83,7 +109,8 @@ class GateOutputRootTreeFile: public GateRootTree, public GateOutputTreeFile
   }
 
 private:
-  std::unordered_map<const std::string*, char*> m_mapConstStringToRootString;
+  // nb_char characters and a terminating '\0' for the /C leaf
+  std::unordered_map<const std::string*, std::vector<char>> m_mapConstStringToRootString;
   static bool s_registered;
 };
 
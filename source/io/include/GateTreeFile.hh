@@ -11,10 +11,13 @@
 #include <iostream>
 #include <memory>
 #include <fstream>
+#include <cstdint>
 
 
 #include "GateFile.hh"
 
+class GateTreeRecord;
+
 class GateData
 {
 public:
@@ -98,6 +101,11 @@ public:
   virtual void write_variable(const std::string &name, const std::string *p, size_t nb_char) = 0;
   virtual void write_variable(const std::string &name, const char *p, size_t nb_char) = 0;
   virtual void write_variable(const std::string &name, const int  *p, size_t n) = 0;
+  // Registers the fields of a compiled record. By default each field is
+  // written as a variable read from its source; the backends copying the
+  // packed entry override it and return true, the record is then packed at
+  // each fill().
+  virtual bool write_record(const GateTreeRecord &record);
   virtual void set_tree_name(const std::string &name) ;
   virtual ~GateOutputTreeFile();
 
@@ -106,6 +114,19 @@ protected:
 };
 
 
+// Values of one variable for all the entries of a file, accessed in place:
+// the value of entry i starts at data + i*stride (not necessarily aligned)
+struct GateTreeColumnView
+{
+  GateTreeColumnView() : data(nullptr), stride(0), nb_elements(0), type_index(typeid(void)) {}
+
+  const char *data;
+  size_t stride;
+  uint64_t nb_elements;
+  std::type_index type_index;
+};
+
+
 class GateInputTreeFile : public GateFile
 {
 public:
@@ -125,6 +146,8 @@ public:
   virtual bool has_variable(const std::string &name) = 0;
   virtual std::type_index get_type_of_variable(const std::string &name) = 0;
   virtual uint64_t nb_elements() = 0;
+  // In-memory view of a variable, false when the backend can not provide it
+  virtual bool get_column_view(const std::string &name, GateTreeColumnView &view);
 
 
   template<typename T>
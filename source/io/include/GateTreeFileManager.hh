@@ -10,6 +10,7 @@
 #include <map>
 
 #include "GateTreeFile.hh"
+#include "GateTreeRecord.hh"
 
 
 typedef const std::function<std::unique_ptr<GateOutputTreeFile>()> TCreateOutputTreeFileMethod;
@@ -35,6 +36,8 @@ private:
 
 
 
+// The variables are registered in a record compiled by write_header(). When a
+// file copies the packed entry (numpy), each fill() packs the record once.
 class GateOutputTreeFileManager
 {
 public:
@@ -47,10 +50,7 @@ public:
   template<typename T>
   void write_variable(const std::string &name, const T *p)
   {
-    for(auto&& f : m_listOfTreeFile)
-    {
-      f->write_variable(name, p, typeid(T));
-    }
+    m_record.add(name, p, typeid(T), sizeof(T));
   }
 
   void write_variable(const std::string &name, const std::string *p, size_t nb_char);
@@ -68,6 +68,8 @@ public:
 private:
   std::vector<std::unique_ptr<GateOutputTreeFile>> m_listOfTreeFile;
   std::string m_nameOfTree;
+  GateTreeRecord m_record;
+  bool m_pack_record;
 };
 
 
@@ -160,6 +162,9 @@ public:
 
   bool has_variable(const std::string &name);
   std::type_index get_type_of_variable(const std::string &name);
+  // In-memory views of a variable, one per file of the chain; false when a
+  // file can not provide it
+  bool get_column_views(const std::string &name, std::vector<GateTreeColumnView> &views);
 
 
 private:
@@ -0,0 +1,75 @@
+//
+// Packed record of the variables of an output tree
+//
+
+#pragma once
+
+#include <string>
+#include <typeindex>
+#include <typeinfo>
+#include <vector>
+
+
+// The variables registered in a GateOutputTreeFileManager are compiled once
+// into a fixed layout: each variable gets an offset in a packed buffer, in the
+// registration order and without padding, strings taking nb_char bytes padded
+// with '\0' (the layout of a numpy row). pack() gathers the current values of
+// all the variables in the buffer once per entry, for the files that copy the
+// entry as raw bytes. The fields are not aligned: the files reading typed
+// values (ROOT, ASCII) use the sources of the fields instead.
+class GateTreeRecord
+{
+public:
+  enum class kind
+  {
+    value,     // arithmetic value copied as is
+    chars,     // nb characters, from a char array or a std::string
+    int_array  // nb int
+  };
+
+  struct field
+  {
+    std::string name;
+    kind field_kind;
+    std::type_index type_index; // of the value, typeid(char*) for chars
+    size_t size;                // bytes in the record
+    size_t nb;                  // characters or ints, 0 for a value
+    size_t offset;              // set by compile()
+    const void *source;         // the registered variable
+    bool from_string;           // chars read from a std::string
+  };
+
+  GateTreeRecord();
+
+  void add(const std::string &name, const void *p, std::type_index t_index, size_t size);
+  void add(const std::string &name, const char *p, size_t nb_char);
+  // Longer strings are truncated to nb_char characters
+  void add(const std::string &name, const std::string *p, size_t nb_char);
+  void add(const std::string &name, const int *p, size_t n);
+
+  // Computes the offsets and the copies done by pack()
+  void compile();
+  bool is_compiled() const { return m_compiled; }
+  void pack();
+
+  const std::vector<field> &fields() const { return m_fields; }
+  const char *data() const { return m_data.data(); }
+  const char *data(const field &f) const { return m_data.data() + f.offset; }
+  size_t size() const { return m_data.size(); }
+
+private:
+  struct copy
+  {
+    const char *source;
+    size_t offset;
+    size_t size;
+  };
+
+  void add(const field &f);
+
+  std::vector<field> m_fields;
+  std::vector<copy> m_copies;        // raw copies, merged when the sources are contiguous
+  std::vector<size_t> m_text_fields; // fields packed as '\0' padded text
+  std::vector<char> m_data;
+  bool m_compiled;
+};
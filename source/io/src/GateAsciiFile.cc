@@ -39,9 +39,10 @@ void GateAsciiTree::register_variable(const std::string &name, const void *p, st
 
 }
 
-void GateAsciiTree::register_variable(const std::string &name, const char *p, size_t )
+void GateAsciiTree::register_variable(const std::string &name, const char *p, size_t nb_char)
 {
     this->register_variable(name, p, typeid(char*));
+    m_vector_of_pointer_to_data.back().m_nb_characters = nb_char;
 }
 
 void GateAsciiTree::register_variable(const std::string &name, const std::string *p, size_t )
@@ -80,7 +81,10 @@ void GateOutputAsciiTreeFile::fill()
         if (d.m_type_index == typeid(char*) )
         {
             const char* p = (const  char *)d.m_pointer_to_data;
-            m_file << p;
+            if (d.m_nb_characters)
+                m_file.write(p, strnlen(p, d.m_nb_characters));
+            else
+                m_file << p;
         }
         else
         {
@@ -146,7 +150,8 @@ GateAsciiData::GateAsciiData(const void *pointer_to_data,
     m_save_to_file(save_to_file),
     m_read_from_string(read_from_string),
     m_index_of_this_data_in_header(0),
-    m_max_caracter_accepted_by_provided_read_buffer(0)
+    m_max_caracter_accepted_by_provided_read_buffer(0),
+    m_nb_characters(0)
 {}
 
 template<>
@@ -0,0 +1,124 @@
+//
+// Blocks of bytes written to output streams by a background thread
+//
+
+#include "GateAsyncBlockWriter.hh"
+
+#include <chrono>
+
+GateAsyncBlockWriter &GateAsyncBlockWriter::instance()
+{
+  static GateAsyncBlockWriter s_instance;
+  return s_instance;
+}
+
+GateAsyncBlockWriter::GateAsyncBlockWriter() :
+  m_enabled(false),
+  m_capacity(64 << 20),
+  m_pending_size(0),
+  m_writing(nullptr),
+  m_stop(false),
+  m_waiting_time(0)
+{}
+
+GateAsyncBlockWriter::~GateAsyncBlockWriter()
+{
+  if(!m_thread.joinable())
+    return;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_block_submitted.notify_one();
+  m_thread.join();
+}
+
+void GateAsyncBlockWriter::set_enabled(bool enabled)
+{
+  if(!enabled && m_enabled)
+    wait();
+  m_enabled = enabled;
+}
+
+void GateAsyncBlockWriter::set_capacity(size_t capacity)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_capacity = capacity;
+}
+
+std::vector<char> GateAsyncBlockWriter::get_buffer()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if(m_free_buffers.empty())
+    return std::vector<char>();
+  std::vector<char> buffer(std::move(m_free_buffers.back()));
+  m_free_buffers.pop_back();
+  return buffer;
+}
+
+void GateAsyncBlockWriter::submit(std::ostream *out, std::vector<char> &&buffer, size_t size)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  if(!m_thread.joinable())
+    m_thread = std::thread(&GateAsyncBlockWriter::run, this);
+
+  // a block larger than the capacity is accepted once the queue is empty
+  if(m_pending_size && m_pending_size + size > m_capacity)
+    {
+      auto start = std::chrono::steady_clock::now();
+      m_block_written.wait(lock, [&] { return !m_pending_size || m_pending_size + size <= m_capacity; });
+      m_waiting_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+  m_blocks.push_back(Block{out, std::move(buffer), size});
+  m_pending_size += size;
+  lock.unlock();
+  m_block_submitted.notify_one();
+}
+
+bool GateAsyncBlockWriter::wait(const std::ostream *out)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_block_written.wait(lock, [&] {
+      if(out && m_writing == out)
+        return false;
+      for(auto &&block : m_blocks)
+        if(block.out == out)
+          return false;
+      return true;
+    });
+  // the stream may be closed and its address reused by another one
+  return !m_failed.erase(out);
+}
+
+void GateAsyncBlockWriter::wait()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_block_written.wait(lock, [this] { return m_blocks.empty() && !m_writing; });
+}
+
+void GateAsyncBlockWriter::run()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while(true)
+    {
+      m_block_submitted.wait(lock, [this] { return m_stop || !m_blocks.empty(); });
+      if(m_blocks.empty())
+        return; // stopped
+
+      Block block(std::move(m_blocks.front()));
+      m_blocks.pop_front();
+      m_writing = block.out;
+      lock.unlock();
+
+      block.out->write(block.data.data(), block.size);
+      bool failed = !*block.out;
+
+      lock.lock();
+      m_writing = nullptr;
+      if(failed)
+        m_failed.insert(block.out);
+      m_pending_size -= block.size;
+      m_free_buffers.push_back(std::move(block.data));
+      m_block_written.notify_all();
+    }
+}
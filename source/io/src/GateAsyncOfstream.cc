@@ -0,0 +1,127 @@
+//
+// Output file stream whose blocks are written by GateAsyncBlockWriter
+//
+
+#include "GateAsyncOfstream.hh"
+
+#include "GateAsyncBlockWriter.hh"
+
+GateAsyncOfstream::GateAsyncOfstream() :
+  std::ofstream(),
+  m_file(std::ofstream::rdbuf()),
+  m_buffer(&m_file)
+{}
+
+GateAsyncOfstream::~GateAsyncOfstream()
+{
+  // the writer thread must not use the stream once it is destroyed
+  if(is_open())
+    close();
+}
+
+void GateAsyncOfstream::open(const std::string &name, std::ios_base::openmode mode)
+{
+  std::ofstream::open(name, mode);
+  m_file.clear();
+  m_buffer.reset();
+  if(is_open() && GateAsyncBlockWriter::instance().is_enabled())
+    std::ios::rdbuf(&m_buffer);
+}
+
+void GateAsyncOfstream::close()
+{
+  if(std::ios::rdbuf() == &m_buffer)
+    {
+      m_buffer.submit();
+      bool written = m_buffer.wait();
+      auto state = rdstate();
+      std::ios::rdbuf(std::ofstream::rdbuf());
+      setstate(state);
+      if(!written)
+        setstate(std::ios_base::badbit);
+    }
+  std::ofstream::close();
+}
+
+GateAsyncOfstream::BlockBuffer::BlockBuffer(std::ostream *file) :
+  m_file(file),
+  m_position(0),
+  m_at_end(true),
+  m_failed(false)
+{}
+
+void GateAsyncOfstream::BlockBuffer::reset()
+{
+  setp(nullptr, nullptr);
+  m_position = 0;
+  m_at_end = true;
+  m_failed = false;
+}
+
+void GateAsyncOfstream::BlockBuffer::submit()
+{
+  size_t size = pptr() - pbase();
+  if(!size)
+    return;
+  auto &writer = GateAsyncBlockWriter::instance();
+  writer.submit(m_file, std::move(m_block), size);
+  m_block = writer.get_buffer();
+  m_position += size;
+  setp(nullptr, nullptr);
+}
+
+bool GateAsyncOfstream::BlockBuffer::wait()
+{
+  if(!GateAsyncBlockWriter::instance().wait(m_file))
+    m_failed = true;
+  return !m_failed;
+}
+
+GateAsyncOfstream::BlockBuffer::int_type GateAsyncOfstream::BlockBuffer::overflow(int_type c)
+{
+  submit();
+  if(m_block.size() < s_block_size)
+    m_block.resize(s_block_size);
+  setp(m_block.data(), m_block.data() + m_block.size());
+  if(!traits_type::eq_int_type(c, traits_type::eof()))
+    {
+      *pptr() = traits_type::to_char_type(c);
+      pbump(1);
+    }
+  return traits_type::not_eof(c);
+}
+
+int GateAsyncOfstream::BlockBuffer::sync()
+{
+  // the block is written once it is full or when the file is closed
+  return 0;
+}
+
+GateAsyncOfstream::BlockBuffer::pos_type
+GateAsyncOfstream::BlockBuffer::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+  // tellp() and the seeks to the current position do not wait for the writer
+  std::streamoff current = m_position + (pptr() - pbase());
+  if((dir == std::ios_base::cur && off == 0) ||
+     (dir == std::ios_base::end && off == 0 && m_at_end) ||
+     (dir == std::ios_base::beg && off == current))
+    return pos_type(current);
+
+  submit();
+  if(!wait())
+    return pos_type(off_type(-1));
+  auto file = m_file->rdbuf();
+  pos_type pos = file->pubseekoff(off, dir, which);
+  if(pos == pos_type(off_type(-1)))
+    return pos;
+  m_position = pos;
+  m_at_end = file->pubseekoff(0, std::ios_base::end, which) == pos;
+  file->pubseekpos(pos, which);
+  return pos;
+}
+
+GateAsyncOfstream::BlockBuffer::pos_type
+GateAsyncOfstream::BlockBuffer::seekpos(pos_type pos, std::ios_base::openmode which)
+{
+  return seekoff(off_type(pos), std::ios_base::beg, which);
+}
@@ -9,11 +9,18 @@
 
 #include <iomanip>
 #include <cstring>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
 #include <stdexcept>
 #include <utility>
 #include "GateFileExceptions.hh"
 #include "GateTreeFileManager.hh"
+#include "GateAsyncBlockWriter.hh"
+#include "GateTreeRecord.hh"
 
 #include "GateMessageManager.hh"
 
@@ -147,7 +154,68 @@ void GateOutputNumpyTreeFile::write_header()
   if( (m_mode & ios_base::out) != ios_base::out )
     throw std::runtime_error("NumpyFile::write_header: file not opened in write mode");
 
-  m_file << magic_prefix.c_str();
+  m_outputs.clear();
+  if(!m_one_file_per_column)
+    {
+      OutputFile output;
+      output.file = &m_file;
+      output.path = m_path;
+      for(size_t i = 0; i < m_vector_of_pointer_to_data.size(); ++i)
+        output.variables.push_back(i);
+      m_outputs.push_back(output);
+    }
+  else
+    {
+      for(size_t i = 0; i < m_vector_of_pointer_to_data.size(); ++i)
+        {
+          auto path = column_path(m_vector_of_pointer_to_data[i].name());
+          std::unique_ptr<std::fstream> file(new std::fstream(path, std::ofstream::binary | std::fstream::out));
+          if(!file->is_open())
+            {
+              std::stringstream ss;
+              ss << "Error opening file! '"  << path <<  "' : " << strerror(errno) ;
+              throw std::ios::failure(ss.str());
+            }
+          OutputFile output;
+          output.file = file.get();
+          output.path = path;
+          output.variables.push_back(i);
+          m_outputs.push_back(output);
+          m_column_files.push_back(std::move(file));
+        }
+    }
+
+  // All the files hold the same number of entries per block
+  size_t row_size = 0;
+  for (auto&& d : m_vector_of_pointer_to_data)
+    row_size += d.m_size_of_data;
+  m_nb_rows_per_block = row_size ? std::max<size_t>(1, s_block_size / row_size) : 1;
+  m_nb_buffered_rows = 0;
+
+  for (auto&& output : m_outputs)
+    {
+      output.row_size = 0;
+      // the fields of a record are already packed ('\0' padded strings):
+      // consecutive fields are copied as a single row
+      output.row = m_record && !output.variables.empty() ? (const char*)m_vector_of_pointer_to_data[output.variables.front()].m_pointer_to_data : nullptr;
+      for (auto i : output.variables)
+        {
+          auto&& d = m_vector_of_pointer_to_data[i];
+          if(output.row && d.m_pointer_to_data != output.row + output.row_size)
+            output.row = nullptr;
+          output.row_size += d.m_size_of_data;
+        }
+      output.buffer.resize(output.row_size * m_nb_rows_per_block);
+      write_header(output);
+    }
+  m_write_header_called = true;
+}
+
+
+void GateOutputNumpyTreeFile::write_header(OutputFile &output)
+{
+  std::fstream &file = *output.file;
+  file << magic_prefix.c_str();
   uint32_t  magic_len = magic_prefix.size() + 2;
 
   std::stringstream ss_dico_before_shape, ss_dico_after_shape;
@@ -156,11 +224,11 @@ void GateOutputNumpyTreeFile::write_header()
   ss_dico_before_shape << "{'descr': [";
 
 
-  for ( auto it = m_vector_of_pointer_to_data.begin(); it != m_vector_of_pointer_to_data.end(); ++it )
+  for ( auto it = output.variables.begin(); it != output.variables.end(); ++it )
     {
-      if(it != m_vector_of_pointer_to_data.begin())
+      if(it != output.variables.begin())
         ss_dico_before_shape << ", ";
-      ss_dico_before_shape << (*it).m_numpy_description;
+      ss_dico_before_shape << m_vector_of_pointer_to_data[*it].m_numpy_description;
     }
 
   ss_dico_before_shape << "], 'fortran_order': False, 'shape': (";
@@ -191,18 +259,54 @@ void GateOutputNumpyTreeFile::write_header()
   uint8_t major = 1;
   uint8_t minor = 0;
 
-  m_file.write((char*)&major, sizeof(major));
-  m_file.write((char*)&minor, sizeof(minor));
-  m_file.write((char*)&hlen, sizeof(hlen));
+  file.write((char*)&major, sizeof(major));
+  file.write((char*)&minor, sizeof(minor));
+  file.write((char*)&hlen, sizeof(hlen));
 
 
-  m_file << dico_before_shape.c_str();
-  m_position_before_shape = m_file.tellp();
+  file << dico_before_shape.c_str();
+  output.position_before_shape = file.tellp();
 
-  m_file.write(shape.c_str(), shape.size());
-  m_position_after_shape = m_file.tellp();
-  m_file << dico_after_shape.c_str();
-  m_write_header_called = true;
+  file.write(shape.c_str(), shape.size());
+  file << dico_after_shape.c_str();
+}
+
+
+void GateOutputNumpyTreeFile::pack(const GateNumpyData &d, char *dest)
+{
+  if(d.m_nb_characters == 0)
+    memcpy(dest, d.m_pointer_to_data, d.m_size_of_data);
+  else if(d.m_type_index == typeid(char*))
+    {
+      // characters after the end of the string are written as '\0'
+      const char *p_data = (const char*)d.m_pointer_to_data;
+      size_t current_nb_characters = strnlen(p_data, d.m_nb_characters);
+      memcpy(dest, p_data, current_nb_characters);
+      memset(dest + current_nb_characters, '\0', d.m_size_of_data - current_nb_characters);
+    }
+  else if (d.m_type_index == typeid(string))
+    {
+      const auto *p_s = (const string*) d.m_pointer_to_data;
+      if( p_s->size() > d.m_nb_characters)
+        {
+          string m;
+          m += "length(" + *p_s + ") = (" + std::to_string(p_s->size()) +   ") > " + std::to_string(d.m_nb_characters);
+          throw std::length_error(m);
+        }
+      memcpy(dest, p_s->data(), p_s->size());
+      memset(dest + p_s->size(), '\0', d.m_size_of_data - p_s->size());
+    }
+  /*
+   *Thinking about how to write in npy file an array of int corresponding to volumeID information. Work in progres. It is not working
+   * else if (d.m_type_index == typeid(int*))
+   {
+   int *p_int = (int*) d.m_pointer_to_data;
+   std::string numericArrayToWrite ="[";
+   for (auto numericIndex=0; numericIndex<d.m_nb_characters-1; ++numericIndex)
+   numericArrayToWrite += std::to_string(p_int[numericIndex]) + ",";
+   numericArrayToWrite += std::to_string(p_int[d.m_nb_characters-1]) + "]";
+   m_file.write(numericArrayToWrite.c_str(), d.m_size_of_data+2+d.m_nb_characters-1);
+   }*/
 }
 
 
@@ -215,75 +319,78 @@ void GateOutputNumpyTreeFile::fill()
   if (m_vector_of_pointer_to_data.empty())
     return;
 
-  //  if( (m_mode & ios_base::out) != ios_base::out )
-  //    return;
-
-  //  cout << "OutputNumpyTreeFile::fill()" << endl;
-  for (auto&& d : m_vector_of_pointer_to_data) // access by const reference
+  for (auto&& output : m_outputs)
     {
-      if(d.m_nb_characters == 0)
-        m_file.write((const char*)d.m_pointer_to_data, d.m_size_of_data);
-      else
+      char *dest = &output.buffer[m_nb_buffered_rows * output.row_size];
+      if(output.row)
         {
-          if(d.m_type_index == typeid(char*))
-            {
-              char *p_data = (char*)d.m_pointer_to_data;
-              auto current_nb_characters = strlen(p_data);
-              //        cout << " p_data = " << p_data;
-              //        cout << " current_nb_characters = " << current_nb_characters;
-              for(size_t i = current_nb_characters; i < d.m_nb_characters; ++i)
-                p_data[i] = '\0';
-
-
-              m_file.write(p_data, d.m_size_of_data);
-          } else if (d.m_type_index == typeid(string))
-          {
-              const auto *p_s = (const string*) d.m_pointer_to_data;
-              if( p_s->size() > d.m_nb_characters)
-              {
-                  string m;
-                  m += "length(" + *p_s + ") = (" + std::to_string(p_s->size()) +   ") > " + std::to_string(d.m_nb_characters);
-                  throw std::length_error(m);
-              }
-
-              string s(*p_s); // copy of the data, :-(
-              s.resize(d.m_nb_characters, '\0');
-
-
-              m_file.write(s.c_str(), d.m_size_of_data);
-          }
-          /*
-           *Thinking about how to write in npy file an array of int corresponding to volumeID information. Work in progres. It is not working
-           * else if (d.m_type_index == typeid(int*))
-          {
-              int *p_int = (int*) d.m_pointer_to_data;
-              std::string numericArrayToWrite ="[";
-              for (auto numericIndex=0; numericIndex<d.m_nb_characters-1; ++numericIndex)
-                  numericArrayToWrite += std::to_string(p_int[numericIndex]) + ",";
-              numericArrayToWrite += std::to_string(p_int[d.m_nb_characters-1]) + "]";
-              m_file.write(numericArrayToWrite.c_str(), d.m_size_of_data+2+d.m_nb_characters-1);
-          }*/
+          memcpy(dest, output.row, output.row_size);
+          continue;
+        }
+      for (auto i : output.variables)
+        {
+          auto&& d = m_vector_of_pointer_to_data[i];
+          pack(d, dest);
+          dest += d.m_size_of_data;
         }
     }
 
   m_nb_elements++;
-  //  cout << "\n";
+  if(++m_nb_buffered_rows == m_nb_rows_per_block)
+    flush();
+}
+
+void GateOutputNumpyTreeFile::flush()
+{
+  if(!m_nb_buffered_rows)
+    return;
+  auto &writer = GateAsyncBlockWriter::instance();
+  for (auto&& output : m_outputs)
+    {
+      size_t size = m_nb_buffered_rows * output.row_size;
+      if(writer.is_enabled())
+        {
+          // the filled block is written by the writer thread, the entries
+          // are packed in another buffer meanwhile
+          std::vector<char> block = writer.get_buffer();
+          block.resize(output.buffer.size());
+          std::swap(block, output.buffer);
+          writer.submit(output.file, std::move(block), size);
+        }
+      else
+        output.file->write(&output.buffer[0], size);
+    }
+  m_nb_buffered_rows = 0;
 }
 
 void GateOutputNumpyTreeFile::write()
 {
 
-  if(!m_file.is_open())
+  if(!is_open())
     return;
 
   if( (m_mode & ios_base::out) == ios_base::out )
     {
-      m_file.seekp(m_position_before_shape);
-      //    cout << "current position = " << m_file.tellp() << "\n";
+      flush();
+      for (auto&& output : m_outputs)
+        {
+          if(!GateAsyncBlockWriter::instance().wait(output.file))
+            {
+              std::stringstream ss;
+              ss << "Error writing file! '" << output.path << "'";
+              throw std::ios::failure(ss.str());
+            }
+        }
       stringstream ss_shape;
       ss_shape << std::setw(20) << std::setfill(' ') << m_nb_elements;
       string shape = ss_shape.str();
-      m_file.write(shape.c_str(), shape.size());
+      for (auto&& output : m_outputs)
+        {
+          output.file->seekp(output.position_before_shape);
+          output.file->write(shape.c_str(), shape.size());
+          // next entries are appended
+          output.file->seekp(0, std::ios_base::end);
+        }
     } else {
     for (auto&& d : m_vector_of_pointer_to_data) // access by const reference
       {
@@ -297,16 +404,27 @@ void GateOutputNumpyTreeFile::write()
 void GateOutputNumpyTreeFile::close()
 {
 
-  if(!m_file.is_open())
+  if(!is_open())
     return;
 
   GateOutputNumpyTreeFile::write();
 
-  m_file.close();
+  for (auto&& file : m_column_files)
+    file->close();
+  m_column_files.clear();
+  m_outputs.clear();
+  m_columns_open = false;
+  if(m_file.is_open())
+    m_file.close();
 }
 
 void GateInputNumpyTreeFile::close()
 {
+  if(m_mapped_file)
+    {
+      munmap((void*)m_mapped_file, m_length_of_file);
+      m_mapped_file = nullptr;
+    }
 
   if(!m_file.is_open())
     return;
@@ -319,6 +437,12 @@ void GateInputNumpyTreeFile::close()
 void GateOutputNumpyTreeFile::open(const std::string& s)
 {
   GateFile::open(s, std::ofstream::binary | std::fstream::out);
+  if(m_one_file_per_column)
+    {
+      // the files are created by write_header, once the variables are known
+      m_columns_open = true;
+      return;
+    }
   m_file.open(s, std::ofstream::binary | std::fstream::out);
   if(!m_file.is_open())
     {
@@ -345,6 +469,17 @@ void GateInputNumpyTreeFile::open(const std::string &s)
   m_file.seekg (0, std::fstream::end);
   m_length_of_file = m_file.tellg();
   m_file.seekg (0, std::fstream::beg);
+
+  // m_file is still used for the header, and for the entries if mmap fails
+  int fd = ::open(s.c_str(), O_RDONLY);
+  if(fd >= 0 && m_length_of_file > 0)
+    {
+      void *p = mmap(nullptr, m_length_of_file, PROT_READ, MAP_PRIVATE, fd, 0);
+      if(p != MAP_FAILED)
+        m_mapped_file = (const char*)p;
+    }
+  if(fd >= 0)
+    ::close(fd);
 }
 
 void GateOutputNumpyTreeFile::write_variable(const std::string &name, const void *p, std::type_index t_index)
@@ -367,7 +502,50 @@ void GateOutputNumpyTreeFile::write_variable(const std::string &name, const int
   this->register_variable(name, p, nb);
 }
 
-GateOutputNumpyTreeFile::GateOutputNumpyTreeFile() : m_write_header_called(false)
+bool GateOutputNumpyTreeFile::write_record(const GateTreeRecord &record)
+{
+  // the variables are read in the packed record, with memcpy only
+  for(auto &&f : record.fields())
+    {
+      switch(f.field_kind)
+        {
+        case GateTreeRecord::kind::value:
+          write_variable(f.name, record.data(f), f.type_index);
+          break;
+        case GateTreeRecord::kind::chars:
+          write_variable(f.name, record.data(f), f.nb);
+          break;
+        case GateTreeRecord::kind::int_array:
+          write_variable(f.name, (const int*)record.data(f), f.nb);
+          break;
+        }
+    }
+  m_record = &record;
+  return true;
+}
+
+GateOutputNumpyTreeFile::GateOutputNumpyTreeFile() : GateOutputNumpyTreeFile(false)
+{}
+
+GateOutputNumpyTreeFile::GateOutputNumpyTreeFile(bool one_file_per_column) :
+  m_write_header_called(false),
+  m_record(nullptr),
+  m_one_file_per_column(one_file_per_column),
+  m_columns_open(false),
+  m_nb_rows_per_block(1),
+  m_nb_buffered_rows(0)
+{}
+
+std::string GateOutputNumpyTreeFile::column_path(const std::string &name) const
+{
+  std::string base = m_path;
+  const std::string extension = ".npy";
+  if(base.size() >= extension.size() && base.compare(base.size() - extension.size(), extension.size(), extension) == 0)
+    base.erase(base.size() - extension.size());
+  return base + "." + name + extension;
+}
+
+GateOutputNumpyColumnsTreeFile::GateOutputNumpyColumnsTreeFile() : GateOutputNumpyTreeFile(true)
 {}
 
 
@@ -383,6 +561,8 @@ void GateNumpyTree::register_variable(const std::string &name, const void *p, st
 
 bool GateOutputNumpyTreeFile::is_open()
 {
+  if(m_one_file_per_column)
+    return m_columns_open;
   return m_file.is_open();
 }
 
@@ -575,15 +755,47 @@ void GateInputNumpyTreeFile::read_header()
         }
     }
   m_start_of_data = m_file.tellg();
+  m_entry_size = 0;
+  for (auto&& d : m_vector_of_pointer_to_data)
+    {
+      d.m_offset = m_entry_size;
+      m_entry_size += d.m_size_of_data;
+    }
+  m_current_entry = 0;
   m_read_header_called = true;
 }
 
+void GateInputNumpyTreeFile::read_entrie_from_memory(const char *entry)
+{
+  for (auto&& d : m_vector_of_pointer_to_data)
+    {
+      if(!d.m_pointer_to_data)
+        continue;
+      const char *p_data = entry + d.m_offset;
+      if( d.m_nb_characters && d.m_type_index_read == typeid(string) )
+        ((string*)d.m_pointer_to_data)->assign(p_data, strnlen(p_data, d.m_nb_characters));
+      else
+        memcpy((void*)d.m_pointer_to_data, p_data, d.m_size_of_data);
+    }
+}
+
 void GateInputNumpyTreeFile::read_next_entrie()
 {
 
   if(!m_read_header_called)
     throw std::logic_error("read_header not called");
 
+  if(m_mapped_file)
+    {
+      // reading past the mapping would not fail, it would crash
+      if(m_current_entry >= m_nb_elements ||
+         m_start_of_data + (m_current_entry + 1) * m_entry_size > m_length_of_file)
+        throw std::out_of_range("InputNumpyTreeFile::read_next_entrie: no entry left in the file");
+      read_entrie_from_memory(m_mapped_file + m_start_of_data + m_current_entry * m_entry_size);
+      ++m_current_entry;
+      return;
+    }
+
   //  cout << "0. current pos = " << m_file.tellg() << " end = " << m_file.end << "eof = " <<  m_file.eof() << "data_to_read() ="  << data_to_read() <<   "\n";
   for (auto&& d : m_vector_of_pointer_to_data) // access by const reference
     {
@@ -614,6 +826,7 @@ void GateInputNumpyTreeFile::read_next_entrie()
           m_file.seekg((size_t )m_file.tellg() + d.m_size_of_data);
         }
     }
+  ++m_current_entry;
 
   //  cout << "1. current pos = " << m_file.tellg() << " end = " << m_file.end << "eof = " <<  m_file.eof() << "data_to_read()"   << data_to_read() <<   "\n";
 
@@ -687,9 +900,21 @@ void GateInputNumpyTreeFile::read_variable(const std::string &name, void *p, std
 
 }
 
-GateInputNumpyTreeFile::GateInputNumpyTreeFile() : m_read_header_called(false)
+GateInputNumpyTreeFile::GateInputNumpyTreeFile() :
+  m_length_of_file(0),
+  m_read_header_called(false),
+  m_start_of_data(0),
+  m_entry_size(0),
+  m_current_entry(0),
+  m_mapped_file(nullptr)
 {}
 
+GateInputNumpyTreeFile::~GateInputNumpyTreeFile()
+{
+  // the readers (e.g. the phase-space sources) do not always close their files
+  close();
+}
+
 void GateInputNumpyTreeFile::read_variable(const std::string &name, char *p)
 {
   read_variable(name, p, typeid(char*));
@@ -699,6 +924,8 @@ bool GateInputNumpyTreeFile::data_to_read()
 {
   if(!m_read_header_called)
     throw std::logic_error("read_header not called");
+  if(m_mapped_file)
+    return m_start_of_data + (m_current_entry + 1) * m_entry_size <= m_length_of_file;
   return m_length_of_file > (size_t)m_file.tellg(); // cast to remove warning
 }
 
@@ -726,27 +953,38 @@ uint64_t GateInputNumpyTreeFile::nb_elements()
 
 void GateInputNumpyTreeFile::read_entrie(const uint64_t &i)
 {
-  //  m_file.seekg(m_start_of_data);
-
-  size_t one_element = 0;
-  for (auto&& d : m_vector_of_pointer_to_data) // access by const reference
+  if(i >= m_nb_elements)
     {
-      one_element += d.m_size_of_data;
+      std::stringstream ss;
+      ss << "InputNumpyTreeFile::read_entrie: entry " << i << " is out of the " << m_nb_elements << " entries";
+      throw std::out_of_range(ss.str());
     }
-
-  m_file.seekg(m_start_of_data + i * one_element);
+  m_current_entry = i;
+  if(!m_mapped_file)
+    m_file.seekg(m_start_of_data + i * m_entry_size);
   this->read_next_entrie();
-  return;
-
+}
 
-  for(uint64_t nb_seek = 0; nb_seek < i; ++nb_seek)
-    {
-      for (auto&& d : m_vector_of_pointer_to_data) // access by const reference
-        {
-          m_file.seekg((size_t )m_file.tellg() + d.m_size_of_data);
-        }
+bool GateInputNumpyTreeFile::get_column_view(const std::string &name, GateTreeColumnView &view)
+{
+  if(!m_read_header_called)
+    throw std::logic_error("read_header not called");
+  if(!m_mapped_file)
+    return false;
+  for (auto&& d : m_vector_of_pointer_to_data) {
+    if (name == d.name()) {
+      if(d.m_nb_characters)
+        return false;
+      view.data = m_mapped_file + m_start_of_data + d.m_offset;
+      view.stride = m_entry_size;
+      view.nb_elements = std::min<uint64_t>(m_nb_elements, (m_length_of_file - m_start_of_data) / (m_entry_size ? m_entry_size : 1));
+      view.type_index = d.m_type_index;
+      return true;
     }
-  this->read_next_entrie();
+  }
+  std::stringstream ss;
+  ss << "Variable named '" << name << "' not found !";
+  throw GateKeyNotFoundInHeaderException(ss.str());
 }
 
 type_index GateInputNumpyTreeFile::get_type_of_variable(const std::string &name)
@@ -765,6 +1003,7 @@ type_index GateInputNumpyTreeFile::get_type_of_variable(const std::string &name)
 
 
 bool GateOutputNumpyTreeFile::s_registered =  GateOutputTreeFileFactory::_register(GateOutputNumpyTreeFile::_get_factory_name(), &GateOutputNumpyTreeFile::_create_method<GateOutputNumpyTreeFile>);
+bool GateOutputNumpyColumnsTreeFile::s_registered =  GateOutputTreeFileFactory::_register(GateOutputNumpyColumnsTreeFile::_get_factory_name(), &GateOutputNumpyColumnsTreeFile::_create_method<GateOutputNumpyColumnsTreeFile>);
 bool GateInputNumpyTreeFile::s_registered =  GateInputTreeFileFactory::_register(GateInputNumpyTreeFile::_get_factory_name(), &GateInputNumpyTreeFile::_create_method<GateInputNumpyTreeFile>);
 
 
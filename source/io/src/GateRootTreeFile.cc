@@ -7,6 +7,8 @@
 #include <iostream>
 #include <fstream>
 #include <assert.h>
+#include <cstring>
+#include <algorithm>
 
 #include "TLeaf.h"
 #include "TROOT.h"
@@ -18,6 +20,59 @@
 
 using namespace std;
 
+GateRootStorageSettings::GateRootStorageSettings() :
+  compression_algorithm(-1),
+  compression_level(-1),
+  basket_size(0),
+  has_auto_flush(false),
+  auto_flush(0),
+  auto_save(0)
+{}
+
+bool GateRootStorageSettings::set_compression(const std::string &algorithm, int level)
+{
+  // codes of ROOT::RCompressionSetting::EAlgorithm, kZSTD is missing before ROOT 6.20
+  static const std::unordered_map<std::string, int> algorithms = {
+    {"zlib", 1}, {"lzma", 2}, {"lz4", 4}, {"zstd", 5}
+  };
+  if(algorithm == "none")
+  {
+    compression_algorithm = -1;
+    compression_level = 0;
+    return true;
+  }
+  auto it = algorithms.find(algorithm);
+  if(it == algorithms.end())
+    return false;
+  compression_algorithm = it->second;
+  compression_level = level;
+  return true;
+}
+
+void GateRootStorageSettings::apply(TFile *file) const
+{
+  if(compression_algorithm >= 0)
+    file->SetCompressionAlgorithm(compression_algorithm);
+  if(compression_level >= 0)
+    file->SetCompressionLevel(compression_level);
+}
+
+void GateRootStorageSettings::apply(TTree *tree) const
+{
+  if(basket_size > 0)
+    tree->SetBasketSize("*", basket_size);
+  if(has_auto_flush)
+    tree->SetAutoFlush(auto_flush);
+  if(auto_save)
+    tree->SetAutoSave(auto_save);
+}
+
+GateRootStorageSettings &GateOutputRootTreeFile::storage_settings()
+{
+  static GateRootStorageSettings s_settings;
+  return s_settings;
+}
+
 
 GateRootTree::GateRootTree() : GateTree()
 {
@@ -83,6 +138,7 @@ void GateOutputRootTreeFile::open(const std::string& s)
 {
   GateFile::open(s.c_str(), ios_base::out);
   m_file = new TFile(s.c_str(), "RECREATE");
+  storage_settings().apply(m_file);
 //  cout << "create tree name = " << m_nameOfTree << " from file " << endl;
   m_ttree = new TTree(m_nameOfTree.c_str(), m_nameOfTree.c_str());
 }
@@ -138,10 +194,12 @@ bool GateInputRootTreeFile::is_open()
 void GateOutputRootTreeFile::fill()
 {
 
-  for(auto ss: m_mapConstStringToRootString)
+  for(auto &&ss: m_mapConstStringToRootString)
   {
-//    ss.second->assign(*ss.first);
-    strcpy(ss.second, ss.first->data());
+    // longer strings are truncated, as in the other backends
+    size_t n = std::min(ss.first->size(), ss.second.size() - 1);
+    memcpy(ss.second.data(), ss.first->data(), n);
+    ss.second[n] = '\0';
   }
 
   m_ttree->Fill();
@@ -149,7 +207,7 @@ void GateOutputRootTreeFile::fill()
 
 void GateOutputRootTreeFile::write_header()
 {
-
+  storage_settings().apply(m_ttree);
 }
 
 void GateOutputRootTreeFile::write_variable(const std::string &name, const void *p, std::type_index t_index)
@@ -158,11 +216,8 @@ void GateOutputRootTreeFile::write_variable(const std::string &name, const void
 }
 void GateOutputRootTreeFile::write_variable(const std::string &name, const std::string *p, size_t nb_char)
 {
-    char *s = new char[nb_char];
-    m_mapConstStringToRootString.emplace(p, s);
-
-
-    this->write_variable(name, s, nb_char);
+    auto &s = m_mapConstStringToRootString.emplace(p, std::vector<char>(nb_char + 1, '\0')).first->second;
+    this->write_variable(name, s.data(), nb_char + 1);
 }
 void GateOutputRootTreeFile::write_variable(const std::string &name, const char *p, size_t nb_char)
 {
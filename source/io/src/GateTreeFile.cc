@@ -3,6 +3,7 @@
 //
 
 #include "GateTreeFile.hh"
+#include "GateTreeRecord.hh"
 
 #include <iostream>
 
@@ -50,6 +51,29 @@ void GateOutputTreeFile::set_tree_name(const std::string &name)
   m_nameOfTree = name;
 }
 
+bool GateOutputTreeFile::write_record(const GateTreeRecord &record)
+{
+  for(auto &&f : record.fields())
+    {
+      switch(f.field_kind)
+        {
+        case GateTreeRecord::kind::value:
+          write_variable(f.name, f.source, f.type_index);
+          break;
+        case GateTreeRecord::kind::chars:
+          if(f.from_string)
+            write_variable(f.name, (const std::string*)f.source, f.nb);
+          else
+            write_variable(f.name, (const char*)f.source, f.nb);
+          break;
+        case GateTreeRecord::kind::int_array:
+          write_variable(f.name, (const int*)f.source, f.nb);
+          break;
+        }
+    }
+  return false;
+}
+
 GateOutputTreeFile::~GateOutputTreeFile()
 {
 //  cout << "~OutputTreeFile" << endl;
@@ -89,4 +113,7 @@ void GateInputTreeFile::read_variable(const std::string &name, char *p, size_t)
   this->read_variable(name, p, typeid(p));
 }
 
-
+bool GateInputTreeFile::get_column_view(const std::string &, GateTreeColumnView &)
+{
+  return false;
+}
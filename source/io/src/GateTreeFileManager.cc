@@ -50,39 +50,33 @@ GateOutputTreeFileFactory::_create(const string& name)
 
 
 
-GateOutputTreeFileManager::GateOutputTreeFileManager()
+GateOutputTreeFileManager::GateOutputTreeFileManager() :
+m_pack_record(false)
 {
   m_nameOfTree = GateTree::default_tree_name();
 }
 
 GateOutputTreeFileManager::GateOutputTreeFileManager(GateOutputTreeFileManager &&m) :
 m_listOfTreeFile(move(m.m_listOfTreeFile)),
-m_nameOfTree(move(m.m_nameOfTree))
+m_nameOfTree(move(m.m_nameOfTree)),
+m_record(move(m.m_record)),
+m_pack_record(m.m_pack_record)
 {}
 
 
 void GateOutputTreeFileManager::write_variable(const std::string &name, const std::string *p, size_t nb_char)
 {
-  for(auto&& f : m_listOfTreeFile)
-  {
-    f->write_variable(name, p, nb_char);
-  }
+  m_record.add(name, p, nb_char);
 }
 
 void GateOutputTreeFileManager::write_variable(const std::string &name, const char *p, size_t nb_char)
 {
-  for(auto&& f : m_listOfTreeFile)
-  {
-    f->write_variable(name, p, nb_char);
-  }
+  m_record.add(name, p, nb_char);
 }
 
 void GateOutputTreeFileManager::write_variable(const std::string &name, const int *p, size_t sizeArray)
 {
-  for(auto&& f : m_listOfTreeFile)
-  {
-    f->write_variable(name, p, sizeArray);
-  }
+  m_record.add(name, p, sizeArray);
 }
 
 void GateOutputTreeFileManager::write()
@@ -103,6 +97,8 @@ void GateOutputTreeFileManager::close()
 
 void GateOutputTreeFileManager::fill()
 {
+  if(m_pack_record)
+    m_record.pack();
   for(auto& f : m_listOfTreeFile)
   {
     f->fill();
@@ -111,8 +107,12 @@ void GateOutputTreeFileManager::fill()
 
 void GateOutputTreeFileManager::write_header()
 {
+  m_record.compile();
+  m_pack_record = false;
   for(auto&& f : m_listOfTreeFile)
   {
+    if(f->write_record(m_record))
+      m_pack_record = true;
     f->set_tree_name(m_nameOfTree);
     f->write_header();
   }
@@ -424,6 +424,22 @@ GateInputTreeFileChain::GateInputTreeFileChain()
   m_nameOfTree = GateTree::default_tree_name();
 }
 
+bool GateInputTreeFileChain::get_column_views(const std::string &name, std::vector<GateTreeColumnView> &views)
+{
+  views.clear();
+  for(auto &f: m_listOfTreeFile)
+  {
+    GateTreeColumnView view;
+    if(!f->get_column_view(name, view))
+    {
+      views.clear();
+      return false;
+    }
+    views.push_back(view);
+  }
+  return true;
+}
+
 void GateInputTreeFileChain::read_entrie(const uint64_t &i)
 {
   uint64_t seek = i;
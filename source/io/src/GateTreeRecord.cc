@@ -0,0 +1,121 @@
+//
+// Packed record of the variables of an output tree
+//
+
+#include "GateTreeRecord.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "GateFileExceptions.hh"
+
+using namespace std;
+
+GateTreeRecord::GateTreeRecord() : m_compiled(false)
+{}
+
+void GateTreeRecord::add(const field &f)
+{
+  if(m_compiled)
+    throw std::logic_error("GateTreeRecord: variable '" + f.name + "' added after compile");
+
+  for(auto &&f_ : m_fields)
+    {
+      if(f_.name == f.name)
+        {
+          string m("Error: Key '");
+          m += f.name;
+          m += "' already used !";
+          throw GateKeyAlreadyExistsException(m);
+        }
+    }
+  m_fields.push_back(f);
+}
+
+void GateTreeRecord::add(const std::string &name, const void *p, std::type_index t_index, size_t size)
+{
+  add(field{name, kind::value, t_index, size, 0, 0, p, false});
+}
+
+void GateTreeRecord::add(const std::string &name, const char *p, size_t nb_char)
+{
+  if(!nb_char)
+    throw std::out_of_range("nb_char == 0 does not make any sense");
+  add(field{name, kind::chars, typeid(char*), nb_char, nb_char, 0, p, false});
+}
+
+void GateTreeRecord::add(const std::string &name, const std::string *p, size_t nb_char)
+{
+  if(!nb_char)
+    throw std::out_of_range("nb_char == 0 does not make any sense");
+  add(field{name, kind::chars, typeid(char*), nb_char, nb_char, 0, p, true});
+}
+
+void GateTreeRecord::add(const std::string &name, const int *p, size_t n)
+{
+  if(!n)
+    throw std::out_of_range("n == 0 does not make any sense");
+  add(field{name, kind::int_array, typeid(int*), n * sizeof(int), n, 0, p, false});
+}
+
+void GateTreeRecord::compile()
+{
+  size_t offset = 0;
+  m_copies.clear();
+  m_text_fields.clear();
+  for(size_t i = 0; i < m_fields.size(); ++i)
+    {
+      auto &f = m_fields[i];
+      f.offset = offset;
+      offset += f.size;
+
+      if(f.field_kind == kind::chars)
+        {
+          m_text_fields.push_back(i);
+          continue;
+        }
+      // consecutive values stored next to each other (arrays, structures)
+      // are copied at once
+      auto p = (const char*)f.source;
+      if(!m_copies.empty())
+        {
+          auto &last = m_copies.back();
+          if(last.source + last.size == p && last.offset + last.size == f.offset)
+            {
+              last.size += f.size;
+              continue;
+            }
+        }
+      m_copies.push_back(copy{p, f.offset, f.size});
+    }
+  m_data.assign(offset, '\0');
+  m_compiled = true;
+}
+
+void GateTreeRecord::pack()
+{
+  char *data = m_data.data();
+  for(auto &&c : m_copies)
+    memcpy(data + c.offset, c.source, c.size);
+
+  for(auto i : m_text_fields)
+    {
+      auto &f = m_fields[i];
+      const char *p;
+      size_t n;
+      if(f.from_string)
+        {
+          auto s = (const string*)f.source;
+          p = s->data();
+          n = std::min(s->size(), f.nb);
+        }
+      else
+        {
+          p = (const char*)f.source;
+          n = strnlen(p, f.nb);
+        }
+      memcpy(data + f.offset, p, n);
+      memset(data + f.offset + n, '\0', f.nb - n);
+    }
+}
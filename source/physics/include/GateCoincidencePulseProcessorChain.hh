@@ -49,8 +49,10 @@ class GateCoincidencePulseProcessorChain : public GateModuleListManager
      virtual size_t GetProcessorNumber()
       	  { return size();}
 	  
-     std::vector<G4String>& GetInputNames()
+     const std::vector<G4String>& GetInputNames() const
        { return m_inputNames; }
+     void AddInputName(const G4String& anInputName)
+       { m_inputNames.push_back(anInputName); m_inputSlots.clear(); }
      const G4String& GetOutputName() const
        { return m_outputName; }
      const std::vector<GateCoincidencePulse*> MakeInputList() const;
@@ -71,6 +73,8 @@ class GateCoincidencePulseProcessorChain : public GateModuleListManager
       GateVSystem *m_system;            //!< System to which the chain is attached
       G4String				   m_outputName;
       std::vector<G4String>                m_inputNames;
+      std::vector<G4int>                   m_inputSlots;  //!< Digitizer slots of the inputs, bound on the first event after a change of the inputs
+      G4int                                m_outputSlot;  //!< Digitizer slot of the output alias
       G4bool         	      	           m_noPriority;
 };
 
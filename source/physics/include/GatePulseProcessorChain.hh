@@ -49,7 +49,7 @@ class GatePulseProcessorChain : public GateModuleListManager
      const G4String& GetInputName() const
        { return m_inputName; }
      void SetInputName(const G4String& anInputName)
-       {  m_inputName = anInputName; }
+       {  m_inputName = anInputName; m_inputSlot = -1; }
      const G4String& GetOutputName() const
        { return m_outputName; }
 
@@ -63,6 +63,8 @@ class GatePulseProcessorChain : public GateModuleListManager
       GateVSystem *m_system;            //!< System to which the chain is attached
       G4String				   m_outputName;
       G4String                             m_inputName;
+      G4int                                m_inputSlot;   //!< Digitizer slot of the input, bound on the first event
+      G4int                                m_outputSlot;  //!< Digitizer slot of the output alias
 };
 
 #endif
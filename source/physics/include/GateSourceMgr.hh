@@ -130,7 +130,7 @@ protected:
   GateSourceMgr();
   G4int CheckSourceName( G4String sourceName );
 
-  static GateSourceMgr*     mInstance;
+  static G4ThreadLocal GateSourceMgr* mInstance;
   GateVSourceVector         mSources;
   GateVSource*              m_previousSource;
   GateVSourceVector         m_currentSources;
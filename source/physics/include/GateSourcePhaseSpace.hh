@@ -96,6 +96,9 @@ public:
   void SetPytorchParams(G4String & name) { mPTJsonFilename = name; }
 
 protected:
+  // Selection of the entries within mRmax directly on the memory-mapped files
+  void SelectEventsInRmax(const std::vector<GateTreeColumnView> & xViews,
+                          const std::vector<GateTreeColumnView> & yViews);
 
 
   //TEntryList
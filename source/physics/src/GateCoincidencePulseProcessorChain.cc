@@ -27,6 +27,7 @@ GateCoincidencePulseProcessorChain::GateCoincidencePulseProcessorChain( GateDigi
     m_system(0 /*itsDigitizer->GetSystem() */),//mhadi_modif
     m_outputName(itsOutputName),
     m_inputNames(),
+    m_outputSlot(-1),
     m_noPriority(true)
 {
   
@@ -84,9 +85,11 @@ void GateCoincidencePulseProcessorChain::ListElements()
 const std::vector<GateCoincidencePulse*> GateCoincidencePulseProcessorChain::MakeInputList() const
 {
    std::vector<GateCoincidencePulse*> ans;
-   for (std::vector<G4String>::const_iterator itName = m_inputNames.begin() ; itName != m_inputNames.end() ; ++itName){
-     std::vector<GateCoincidencePulse*> pulseList 
-        = GateDigitizer::GetInstance()->FindCoincidencePulse( *itName );
+   for (size_t k = 0 ; k < m_inputNames.size() ; ++k){
+     // inputs bound to a slot by ProcessCoincidencePulses are found by index
+     std::vector<GateCoincidencePulse*> pulseList = (k<m_inputSlots.size())
+        ? GateDigitizer::GetInstance()->FindCoincidencePulse( m_inputSlots[k] )
+        : GateDigitizer::GetInstance()->FindCoincidencePulse( m_inputNames[k] );
      for (std::vector<GateCoincidencePulse*>::const_iterator it = pulseList.begin() ; it != pulseList.end() ; ++it){
 	GateCoincidencePulse* pulse = *it;
 	if (pulse->empty()) continue;
@@ -115,7 +118,14 @@ const std::vector<GateCoincidencePulse*> GateCoincidencePulseProcessorChain::Mak
 //------------------------------------------------------------------------------------------------------
 void GateCoincidencePulseProcessorChain::ProcessCoincidencePulses()
 {
-  if (m_inputNames.empty()) m_inputNames.push_back("Coincidences");
+  GateDigitizer* digitizer = GateDigitizer::GetInstance();
+  if (m_inputNames.empty()) AddInputName("Coincidences");
+  if (m_inputSlots.empty()) {
+    m_inputSlots.clear();
+    for (size_t k = 0 ; k < m_inputNames.size() ; ++k)
+      m_inputSlots.push_back(digitizer->GetCoincidencePulseSlot(m_inputNames[k]));
+    m_outputSlot = digitizer->GetCoincidencePulseSlot(m_outputName);
+  }
   std::vector<GateCoincidencePulse*> pulseList = MakeInputList();
 
   //mhadi_add[
@@ -144,12 +154,12 @@ void GateCoincidencePulseProcessorChain::ProcessCoincidencePulses()
 	 if (pulse){
 	   //G4cout<<"processorName="<<processor->GetObjectName()<<G4endl;
       	   pulse->SetName(processor->GetObjectName());
-      	   GateDigitizer::GetInstance()->StoreCoincidencePulse(pulse);
+      	   digitizer->StoreCoincidencePulse(pulse);
 	 } else break;
        }
      }
       //G4cout<<"CoincChain m_outputName="<<m_outputName<<G4endl;
-     if (pulse) GateDigitizer::GetInstance()->StoreCoincidencePulseAlias(m_outputName,pulse);
+     if (pulse) digitizer->StoreCoincidencePulseAlias(m_outputSlot,pulse);
    }
 
   return;
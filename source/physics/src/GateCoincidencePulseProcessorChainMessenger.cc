@@ -56,7 +56,7 @@ GateCoincidencePulseProcessorChainMessenger::~GateCoincidencePulseProcessorChain
 void GateCoincidencePulseProcessorChainMessenger::SetNewValue(G4UIcommand* command,G4String newValue)
 { 
   if (command == AddInputNameCmd) 
-  { GetProcessorChain()->GetInputNames().push_back(newValue);  //mhadi_modif
+  { GetProcessorChain()->AddInputName(newValue);  //mhadi_modif
     GetProcessorChain()->SetSystem(newValue); } //mhadi
   else if (command == usePriorityCmd) 
     { GetProcessorChain()->SetNoPriority(!usePriorityCmd->GetNewBoolValue(newValue)); }
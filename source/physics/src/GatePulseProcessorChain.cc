@@ -25,7 +25,9 @@ GatePulseProcessorChain::GatePulseProcessorChain( GateDigitizer* itsDigitizer,
   : GateModuleListManager(itsDigitizer,itsDigitizer->GetObjectName() + "/" + itsOutputName,"pulse-processor"),
     m_system( itsDigitizer->GetSystem() ),
     m_outputName(itsOutputName),
-    m_inputName(GateHitConvertor::GetOutputAlias())
+    m_inputName(GateHitConvertor::GetOutputAlias()),
+    m_inputSlot(-1),
+    m_outputSlot(-1)
 {
 //  G4cout << " DEBUT Constructor GatePulseProcessorChain \n";
   m_messenger = new GatePulseProcessorChainMessenger(this);
@@ -80,7 +82,13 @@ void GatePulseProcessorChain::ListElements()
 
 GatePulseList* GatePulseProcessorChain::ProcessPulseList()
 {
-  GatePulseList* pulseList = GateDigitizer::GetInstance()->FindPulseList( m_inputName );
+  GateDigitizer* digitizer = GateDigitizer::GetInstance();
+  if (m_inputSlot<0) {
+    m_inputSlot = digitizer->GetPulseListSlot( m_inputName );
+    m_outputSlot = digitizer->GetPulseListSlot( m_outputName );
+  }
+
+  GatePulseList* pulseList = digitizer->FindPulseList( m_inputSlot );
 
   if (!pulseList)
     return 0;
@@ -93,11 +101,11 @@ GatePulseList* GatePulseProcessorChain::ProcessPulseList()
   for (size_t processorID = 0 ; processorID < GetProcessorNumber(); processorID++) 
     if (GetProcessor(processorID)->IsEnabled()) {
       pulseList = GetProcessor(processorID)->ProcessPulseList(pulseList);
-      if (pulseList) GateDigitizer::GetInstance()->StorePulseList(pulseList);
+      if (pulseList) digitizer->StorePulseList(pulseList);
       else break;
     }
 
-  if (pulseList)  GateDigitizer::GetInstance()->StorePulseListAlias(m_outputName,pulseList);
+  if (pulseList)  digitizer->StorePulseListAlias(m_outputSlot,pulseList);
   return pulseList;
 }
 
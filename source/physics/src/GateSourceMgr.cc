@@ -32,7 +32,7 @@
 #include "GateExtendedVSource.hh"
 
 //----------------------------------------------------------------------------------------
-GateSourceMgr* GateSourceMgr::mInstance = 0;
+G4ThreadLocal GateSourceMgr* GateSourceMgr::mInstance = 0;
 
 //----------------------------------------------------------------------------------------
 GateSourceMgr::GateSourceMgr()
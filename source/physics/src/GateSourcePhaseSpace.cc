@@ -35,6 +35,7 @@
 #include "GateApplicationMgr.hh"
 #include "GateFileExceptions.hh"
 #include <chrono>
+#include <cstring>
 
 typedef unsigned int uint;
 
@@ -182,10 +183,17 @@ void GateSourcePhaseSpace::Initialize()
     }
 
     if (mRmax>0){
-      for(int i = 0; i < mTotalNumberOfParticles;i++) {
-        mChain.read_entrie(i);
-        if (std::abs(x)<mRmax && std::abs(y)<mRmax) {
-          pListOfSelectedEvents.push_back(i);
+      // X and Y are scanned in place when all the files are memory-mapped,
+      // otherwise every entry is read
+      std::vector<GateTreeColumnView> xViews, yViews;
+      if (mChain.get_column_views("X", xViews) && mChain.get_column_views("Y", yViews))
+        SelectEventsInRmax(xViews, yViews);
+      else {
+        for(int i = 0; i < mTotalNumberOfParticles;i++) {
+          mChain.read_entrie(i);
+          if (std::abs(x)<mRmax && std::abs(y)<mRmax) {
+            pListOfSelectedEvents.push_back(i);
+          }
         }
       }
       mTotalNumberOfParticles = pListOfSelectedEvents.size();
@@ -204,6 +212,38 @@ void GateSourcePhaseSpace::Initialize()
 // ----------------------------------------------------------------------------------
 
 
+// ----------------------------------------------------------------------------------
+template<typename T>
+static void SelectInRmax(const GateTreeColumnView & xView, const GateTreeColumnView & yView,
+                         float rmax, unsigned int first, std::vector<unsigned int> & selected)
+{
+  T vx, vy;
+  for(uint64_t i = 0; i < xView.nb_elements; i++) {
+    // entries are packed, the values may not be aligned
+    memcpy(&vx, xView.data + i*xView.stride, sizeof(T));
+    memcpy(&vy, yView.data + i*yView.stride, sizeof(T));
+    if (std::abs(vx)<rmax && std::abs(vy)<rmax) selected.push_back(first+i);
+  }
+}
+// ----------------------------------------------------------------------------------
+
+
+// ----------------------------------------------------------------------------------
+void GateSourcePhaseSpace::SelectEventsInRmax(const std::vector<GateTreeColumnView> & xViews,
+                                              const std::vector<GateTreeColumnView> & yViews)
+{
+  unsigned int first = 0;
+  for(size_t f = 0; f < xViews.size(); f++) {
+    // X and Y have been bound to floats, the file type is checked by read_variable
+    if (xViews[f].type_index != typeid(float) || yViews[f].type_index != typeid(float))
+      GateError("Phase Space Source. X and Y must be float values");
+    SelectInRmax<float>(xViews[f], yViews[f], mRmax, first, pListOfSelectedEvents);
+    first += xViews[f].nb_elements;
+  }
+}
+// ----------------------------------------------------------------------------------
+
+
 // ----------------------------------------------------------------------------------
 void GateSourcePhaseSpace::GenerateROOTVertex( G4Event* /*aEvent*/ )
 {